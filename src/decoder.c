@@ -80,8 +80,27 @@
 #include <string.h>
 #include <math.h>
 
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
 #include "decoder.h"
 
+#if !defined LTC_NO_SIMD
+# if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define LTC_DECODE_SSE2
+#  define LTC_DECODE_SIMD
+# elif defined __aarch64__ && defined __ARM_NEON
+#  include <arm_neon.h>
+#  define LTC_DECODE_NEON
+#  define LTC_DECODE_SIMD
+# endif
+# if defined LTC_DECODE_SIMD && defined _MSC_VER
+#  include <intrin.h>
+# endif
+#endif
+
 #define DEBUG_DUMP(msg, f) \
 { \
 	int _ii; \
@@ -113,16 +132,271 @@
 #endif
 
 static double calc_volume_db(LTCDecoder *d) {
+	if (d->snd_native) {
+		if (d->snd_env_max <= d->snd_env_min)
+			return -INFINITY;
+		return (20.0 * log10((d->snd_env_max - d->snd_env_min) / 2.0));
+	}
 	if (d->snd_to_biphase_max <= d->snd_to_biphase_min)
 		return -INFINITY;
 	return (20.0 * log10((d->snd_to_biphase_max - d->snd_to_biphase_min) / 255.0));
 }
 
-static void parse_ltc(LTCDecoder *d, unsigned char bit, ltc_off_t offset, ltc_off_t posinfo) {
-	int bit_num, bit_set, byte_num;
+/** map the tracked signal envelope to the 0..255 range reported in LTCFrameExt */
+static ltcsnd_sample_t env_to_sample(LTCDecoder *d, float env, ltcsnd_sample_t u8) {
+	if (!d->snd_native)
+		return u8;
+	if (env <= -1.f)
+		return 0;
+	if (env >= 1.f)
+		return 255;
+	return (ltcsnd_sample_t) (SAMPLE_CENTER + env * 127.f);
+}
+
+/** bit-reversal of a byte */
+#define R2(n) n, n + 2*64, n + 1*64, n + 3*64
+#define R4(n) R2(n), R2(n + 2*16), R2(n + 1*16), R2(n + 3*16)
+#define R6(n) R4(n), R4(n + 2*4 ), R4(n + 1*4 ), R4(n + 3*4 )
+static const unsigned char bit_reverse[256] = {
+	R6(0), R6(2), R6(1), R6(3)
+};
+#undef R2
+#undef R4
+#undef R6
 
+/** write the in-flight frame register to a LTCFrame (byte n holds bits 8n..8n+7) */
+static void store_ltc_frame(LTCFrame *frame, uint64_t lo, uint16_t hi) {
+	unsigned char *b = (unsigned char*) frame;
+	int k;
+	memset(frame, 0, sizeof(LTCFrame));
+	for (k = 0; k < 8; k++) {
+		b[k] = (unsigned char)(lo >> (8 * k));
+	}
+	b[8] = (unsigned char)(hi);
+	b[9] = (unsigned char)(hi >> 8);
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Auto-detection (LTC_DECODER_AUTODETECT)
+ *
+ * Biphase mark code has transitions after a full bit period (0) or
+ * half a bit period (1). The bit period is estimated from a histogram of
+ * transition intervals, the framerate is counted from decoded frames.
+ */
+
+void decoder_detect_restart(LTCDecoder *d) {
+	memset(d->detect_hist, 0, sizeof(d->detect_hist));
+	d->detect_edges = 0;
+	d->detect_prev = -1;
+	d->detect_fps = 0;
+	d->detect_df = 0;
+	d->detect_len = 0;
+	d->detect_len_cnt = 0;
+}
+
+/** estimate the bit period from the histogram */
+static void detect_period(LTCDecoder *d) {
+	unsigned int sum[LTC_DETECT_BINS + 1]; /* prefix sums of the histogram */
+	unsigned int best = 0;
+	double period = 0;
+	int k, i, iter;
+
+	sum[0] = 0;
+	for (k = 0; k < LTC_DETECT_BINS; ++k) {
+		sum[k + 1] = sum[k] + d->detect_hist[k];
+	}
+
+#define HIST_RANGE(lo, hi) (sum[(hi) < LTC_DETECT_BINS ? (hi) + 1 : LTC_DETECT_BINS] - sum[(lo) < LTC_DETECT_BINS ? (lo) : LTC_DETECT_BINS])
+	/* the bit period is the interval that explains most transitions as full or half periods */
+	for (k = 1; k < LTC_DETECT_BINS; ++k) {
+		const unsigned int n = HIST_RANGE((3 * k + 3) / 4, (5 * k) / 4) + HIST_RANGE((3 * k + 7) / 8, (5 * k) / 8);
+		if (n > best) {
+			best = n;
+			period = k;
+		}
+	}
+#undef HIST_RANGE
+
+	/* refine: weighted mean, half periods count twice */
+	for (iter = 0; iter < 3 && period > 0; ++iter) {
+		double acc = 0;
+		unsigned int n = 0;
+		for (i = 1; i < LTC_DETECT_BINS; ++i) {
+			if (i >= .75 * period && i <= 1.25 * period) {
+				acc += (double)i * d->detect_hist[i];
+				n += d->detect_hist[i];
+			} else if (i >= .375 * period && i <= .625 * period) {
+				acc += 2.0 * i * d->detect_hist[i];
+				n += d->detect_hist[i];
+			}
+		}
+		if (n == 0) break;
+		period = acc / n;
+	}
+
+	if (period <= 0) {
+		/* no signal, start over */
+		memset(d->detect_hist, 0, sizeof(d->detect_hist));
+		d->detect_edges = 0;
+		return;
+	}
+
+	d->snd_to_biphase_period = period;
+	d->snd_to_biphase_lmt = (period * 3) / 4;
+}
+
+/** add the current transition interval to the histogram */
+static inline void detect_interval(LTCDecoder *d) {
+	const int cnt = d->snd_to_biphase_cnt;
+	if (cnt < 1 || cnt >= LTC_DETECT_BINS) {
+		return;
+	}
+	d->detect_hist[cnt]++;
+	if (++d->detect_edges == LTC_DETECT_EDGES) {
+		detect_period(d);
+	}
+}
+
+/** count the framerate from the frame-numbers of consecutive frames */
+static void detect_frame(LTCDecoder *d, const LTCFrame *f, ltc_off_t len, int reverse) {
+	const int frame = f->frame_units + f->frame_tens * 10;
+	const int prev = d->detect_prev;
+
+	if (prev >= 0) {
+		const int last = reverse ? frame : prev;
+		const int first = reverse ? prev : frame;
+		/* frame-numbers wrap from fps - 1 to 0 at each second (or to 2 for drop-frame) */
+		if (first < 3 && last >= 23 && last < 30
+				&& (first == 0 || (f->dfbit && last == 29))) {
+			d->detect_fps = last + 1;
+		}
+		if ((reverse ? prev - frame : frame - prev) == 1) {
+			d->detect_len += len;
+			d->detect_len_cnt++;
+		}
+	}
+	d->detect_prev = frame;
+	d->detect_df = f->dfbit;
+}
+
+/** copy the timing of the last LTC_FRAME_BIT_COUNT bits, oldest bit first */
+static void unroll_tics(LTCDecoder *d, float *tics) {
+	const int tic = d->biphase_tic;
+	memcpy(tics, &d->biphase_tics[tic], (LTC_FRAME_BIT_COUNT - tic) * sizeof(float));
+	memcpy(&tics[LTC_FRAME_BIT_COUNT - tic], d->biphase_tics, tic * sizeof(float));
+}
+
+/** append the completed in-flight frame to the queue.
+ * If the queue is full, the frame is dropped and an overrun is counted.
+ */
+static void queue_frame(LTCDecoder *d, ltc_off_t off_start, ltc_off_t off_end, int reverse) {
+	const unsigned int len = d->queue_len;
+	const unsigned int w = ltc_atomic_load_relaxed(&d->queue_write_off);
+	const unsigned int r = ltc_atomic_load_acquire(&d->queue_read_off);
+
+	d->stats.frames++;
+	if (reverse) {
+		d->stats.frames_reverse++;
+	}
+
+	if (d->detect) {
+		LTCFrame f;
+		store_ltc_frame(&f, d->ltc_frame_lo, d->ltc_frame_hi);
+		detect_frame(d, &f, off_end - off_start + 1, reverse);
+	}
+
+	if ((w + 2 * len - r) % (2 * len) == len) {
+		ltc_atomic_store_release(&d->queue_overruns, ltc_atomic_load_relaxed(&d->queue_overruns) + 1);
+		return;
+	}
+
+	if (d->queue_compact) {
+		LTCFrameCompact *f = &d->queue_compact[w % len];
+		store_ltc_frame(&f->ltc, d->ltc_frame_lo, d->ltc_frame_hi);
+		f->off_start = off_start;
+		f->off_end = off_end;
+		f->reverse = reverse;
+		f->volume = calc_volume_db(d);
+		f->sample_min = env_to_sample(d, d->snd_env_min, d->snd_to_biphase_min);
+		f->sample_max = env_to_sample(d, d->snd_env_max, d->snd_to_biphase_max);
+		if (d->queue_tics) {
+			unroll_tics(d, &d->queue_tics[(w % len) * LTC_FRAME_BIT_COUNT]);
+		}
+	} else {
+		LTCFrameExt *f = &d->queue[w % len];
+		store_ltc_frame(&f->ltc, d->ltc_frame_lo, d->ltc_frame_hi);
+		unroll_tics(d, f->biphase_tics);
+		f->off_start = off_start;
+		f->off_end = off_end;
+		f->reverse = reverse;
+		f->volume = calc_volume_db(d);
+		f->sample_min = env_to_sample(d, d->snd_env_min, d->snd_to_biphase_min);
+		f->sample_max = env_to_sample(d, d->snd_env_max, d->snd_to_biphase_max);
+	}
+
+	/* publish the frame */
+	ltc_atomic_store_release(&d->queue_write_off, (w + 1) % (2 * len));
+}
+
+/** append an event to the early queue, it is dropped if the queue is full */
+static void queue_early(LTCDecoder *d, int status, ltc_off_t off_event) {
+	const unsigned int w = ltc_atomic_load_relaxed(&d->early_write_off);
+	const unsigned int r = ltc_atomic_load_acquire(&d->early_read_off);
+	LTCFrameEarly *f;
+
+	if ((w + 2 * LTC_EARLY_QUEUE - r) % (2 * LTC_EARLY_QUEUE) == LTC_EARLY_QUEUE) {
+		return;
+	}
+	f = &d->early_queue[w % LTC_EARLY_QUEUE];
+	memcpy(f, &d->early_frame, sizeof(LTCFrameEarly));
+	f->status = status;
+	f->off_event = off_event;
+	ltc_atomic_store_release(&d->early_write_off, (w + 1) % (2 * LTC_EARLY_QUEUE));
+}
+
+/** report the in-flight frame as provisional, once its 64 data bits are known */
+static void early_frame(LTCDecoder *d, ltc_off_t off_event) {
+	LTCFrame *f = &d->early_frame.ltc;
+	LTCFrame p;
+
+	/* forward sync word 0x3ffd, bit 64 first */
+	store_ltc_frame(f, d->ltc_frame_lo, B16(10111111,11111100));
+
+	if (f->frame_units > 9 || f->secs_units > 9 || f->secs_tens > 5
+			|| f->mins_units > 9 || f->mins_tens > 5 || f->hours_units > 9 || f->hours_tens > 2) {
+		return;
+	}
+
+	/* the parity bit position depends on the TV standard, accept either */
+	memcpy(&p, f, sizeof(LTCFrame));
+	ltc_frame_set_parity(&p, LTC_TV_525_60);
+	if (memcmp(&p, f, sizeof(LTCFrame))) {
+		memcpy(&p, f, sizeof(LTCFrame));
+		ltc_frame_set_parity(&p, LTC_TV_625_50);
+		if (memcmp(&p, f, sizeof(LTCFrame))) {
+			return;
+		}
+	}
+
+	d->early_frame.off_start = d->frame_start_off;
+	d->early_frame.off_end = off_event + (LTC_FRAME_BIT_COUNT - 64) * d->snd_to_biphase_period - 1;
+	d->early_pending = 1;
+	queue_early(d, LTC_EARLY_PROVISIONAL, off_event);
+}
+
+/** the in-flight frame was not completed */
+static void early_retract(LTCDecoder *d, ltc_off_t off_event) {
+	d->early_armed = 0;
+	if (d->early_pending) {
+		d->early_pending = 0;
+		queue_early(d, LTC_EARLY_RETRACTED, off_event);
+	}
+}
+
+static void parse_ltc(LTCDecoder *d, unsigned char bit, ltc_off_t offset, ltc_off_t posinfo) {
 	if (d->bit_cnt == 0) {
-		memset(&d->ltc_frame, 0, sizeof(LTCFrame));
+		d->ltc_frame_lo = 0;
+		d->ltc_frame_hi = 0;
 
 		if (d->frame_start_prev < 0) {
 			d->frame_start_off = posinfo - d->snd_to_biphase_period;
@@ -134,74 +408,53 @@ static void parse_ltc(LTCDecoder *d, unsigned char bit, ltc_off_t offset, ltc_of
 
 	if (d->bit_cnt >= LTC_FRAME_BIT_COUNT) {
 		/* shift bits backwards */
-		int k = 0;
-		const int byte_num_max = LTC_FRAME_BIT_COUNT >> 3;
-
-		for (k=0; k< byte_num_max; k++) {
-			const unsigned char bi = ((unsigned char*)&d->ltc_frame)[k];
-			unsigned char bo = 0;
-			bo |= (bi & B8(10000000) ) ? B8(01000000) : 0;
-			bo |= (bi & B8(01000000) ) ? B8(00100000) : 0;
-			bo |= (bi & B8(00100000) ) ? B8(00010000) : 0;
-			bo |= (bi & B8(00010000) ) ? B8(00001000) : 0;
-			bo |= (bi & B8(00001000) ) ? B8(00000100) : 0;
-			bo |= (bi & B8(00000100) ) ? B8(00000010) : 0;
-			bo |= (bi & B8(00000010) ) ? B8(00000001) : 0;
-			if (k+1 < byte_num_max) {
-				bo |= ( (((unsigned char*)&d->ltc_frame)[k+1]) & B8(00000001) ) ? B8(10000000): B8(00000000);
-			}
-			((unsigned char*)&d->ltc_frame)[k] = bo;
-		}
+		d->ltc_frame_lo = (d->ltc_frame_lo >> 1) | ((uint64_t)(d->ltc_frame_hi & 1) << 63);
+		d->ltc_frame_hi >>= 1;
 
 		d->frame_start_off += ceil(d->snd_to_biphase_period);
 		d->bit_cnt--;
+		d->stats.bit_overflows++;
+		if (d->early) {
+			early_retract(d, offset + posinfo);
+		}
 	}
 
+	d->stats.bits++;
 	d->decoder_sync_word <<= 1;
 	if (bit) {
 
 		d->decoder_sync_word |= B16(00000000,00000001);
 
-		if (d->bit_cnt < LTC_FRAME_BIT_COUNT) {
-			// Isolating the lowest three bits: the location of this bit in the current byte
-			bit_num = (d->bit_cnt & B8(00000111));
-			// Using the bit number to define which of the eight bits to set
-			bit_set = (B8(00000001) << bit_num);
-			// Isolating the higher bits: the number of the byte/char the target bit is contained in
-			byte_num = d->bit_cnt >> 3;
-
-			(((unsigned char*)&d->ltc_frame)[byte_num]) |= bit_set;
+		if (d->bit_cnt < 64) {
+			d->ltc_frame_lo |= (uint64_t)1 << d->bit_cnt;
+		} else if (d->bit_cnt < LTC_FRAME_BIT_COUNT) {
+			d->ltc_frame_hi |= 1 << (d->bit_cnt - 64);
 		}
 
 	}
 	d->bit_cnt++;
 
+	if (d->early && d->early_armed && d->bit_cnt == 64) {
+		early_frame(d, posinfo + (ltc_off_t) offset);
+	}
+
 	if (d->decoder_sync_word == B16(00111111,11111101) /*LTC Sync Word 0x3ffd*/) {
 		if (d->bit_cnt == LTC_FRAME_BIT_COUNT) {
-			int bc;
-
-			if (d->queue_write_off == d->queue_len) {
-				d->queue_write_off = 0;
+			queue_frame(d,
+					d->frame_start_off,
+					posinfo + (ltc_off_t) offset - 1LL,
+					0);
+			if (d->early_pending) {
+				d->early_pending = 0;
+				d->early_frame.off_end = posinfo + (ltc_off_t) offset - 1LL;
+				queue_early(d, LTC_EARLY_CONFIRMED, posinfo + (ltc_off_t) offset);
 			}
-
-			memcpy( &d->queue[d->queue_write_off].ltc,
-				&d->ltc_frame,
-				sizeof(LTCFrame));
-
-			for(bc = 0; bc < LTC_FRAME_BIT_COUNT; ++bc) {
-				const int btc = (d->biphase_tic + bc ) % LTC_FRAME_BIT_COUNT;
-				d->queue[d->queue_write_off].biphase_tics[bc] = d->biphase_tics[btc];
+			d->early_armed = d->early;
+		} else {
+			d->stats.sync_errors++;
+			if (d->early) {
+				early_retract(d, posinfo + (ltc_off_t) offset);
 			}
-
-			d->queue[d->queue_write_off].off_start = d->frame_start_off;
-			d->queue[d->queue_write_off].off_end = posinfo + (ltc_off_t) offset - 1LL;
-			d->queue[d->queue_write_off].reverse = 0;
-			d->queue[d->queue_write_off].volume = calc_volume_db(d);
-			d->queue[d->queue_write_off].sample_min = d->snd_to_biphase_min;
-			d->queue[d->queue_write_off].sample_max = d->snd_to_biphase_max;
-
-			d->queue_write_off++;
-
 		}
 		d->bit_cnt = 0;
 	}
@@ -209,59 +462,50 @@ static void parse_ltc(LTCDecoder *d, unsigned char bit, ltc_off_t offset, ltc_of
 	if (d->decoder_sync_word == B16(10111111,11111100) /* reverse sync-word*/) {
 		if (d->bit_cnt == LTC_FRAME_BIT_COUNT) {
 			/* reverse frame */
-			int bc;
-			int k = 0;
-			int byte_num_max = LTC_FRAME_BIT_COUNT >> 3;
-
-			/* swap bits */
-			for (k=0; k< byte_num_max; k++) {
-				const unsigned char bi = ((unsigned char*)&d->ltc_frame)[k];
-				unsigned char bo = 0;
-				bo |= (bi & B8(10000000) ) ? B8(00000001) : 0;
-				bo |= (bi & B8(01000000) ) ? B8(00000010) : 0;
-				bo |= (bi & B8(00100000) ) ? B8(00000100) : 0;
-				bo |= (bi & B8(00010000) ) ? B8(00001000) : 0;
-				bo |= (bi & B8(00001000) ) ? B8(00010000) : 0;
-				bo |= (bi & B8(00000100) ) ? B8(00100000) : 0;
-				bo |= (bi & B8(00000010) ) ? B8(01000000) : 0;
-				bo |= (bi & B8(00000001) ) ? B8(10000000) : 0;
-				((unsigned char*)&d->ltc_frame)[k] = bo;
-			}
-
-			/* swap bytes */
-			byte_num_max-=2; // skip sync-word
-			for (k=0; k< (byte_num_max)/2; k++) {
-				const unsigned char bi = ((unsigned char*)&d->ltc_frame)[k];
-				((unsigned char*)&d->ltc_frame)[k] = ((unsigned char*)&d->ltc_frame)[byte_num_max-1-k];
-				((unsigned char*)&d->ltc_frame)[byte_num_max-1-k] = bi;
-			}
-
-			if (d->queue_write_off == d->queue_len) {
-				d->queue_write_off = 0;
-			}
-
-			memcpy( &d->queue[d->queue_write_off].ltc,
-				&d->ltc_frame,
-				sizeof(LTCFrame));
+			int k;
+			uint64_t lo = 0;
 
-			for(bc = 0; bc < LTC_FRAME_BIT_COUNT; ++bc) {
-				const int btc = (d->biphase_tic + bc ) % LTC_FRAME_BIT_COUNT;
-				d->queue[d->queue_write_off].biphase_tics[bc] = d->biphase_tics[btc];
+			/* swap bits and bytes 0..7 (ie. reverse all 64 bits), swap bits of the sync-word bytes */
+			for (k = 0; k < 8; k++) {
+				lo = (lo << 8) | bit_reverse[(d->ltc_frame_lo >> (8 * k)) & 0xff];
 			}
+			d->ltc_frame_lo = lo;
+			d->ltc_frame_hi = bit_reverse[d->ltc_frame_hi & 0xff] | (bit_reverse[d->ltc_frame_hi >> 8] << 8);
 
-			d->queue[d->queue_write_off].off_start = d->frame_start_off - 16 * d->snd_to_biphase_period;
-			d->queue[d->queue_write_off].off_end = posinfo + (ltc_off_t) offset - 1LL - 16 * d->snd_to_biphase_period;
-			d->queue[d->queue_write_off].reverse = (LTC_FRAME_BIT_COUNT >> 3) * 8 * d->snd_to_biphase_period;
-			d->queue[d->queue_write_off].volume = calc_volume_db(d);
-			d->queue[d->queue_write_off].sample_min = d->snd_to_biphase_min;
-			d->queue[d->queue_write_off].sample_max = d->snd_to_biphase_max;
-
-			d->queue_write_off++;
+			queue_frame(d,
+					d->frame_start_off - 16 * d->snd_to_biphase_period,
+					posinfo + (ltc_off_t) offset - 1LL - 16 * d->snd_to_biphase_period,
+					(LTC_FRAME_BIT_COUNT >> 3) * 8 * d->snd_to_biphase_period);
+		} else {
+			d->stats.sync_errors++;
+		}
+		if (d->early) {
+			early_retract(d, posinfo + (ltc_off_t) offset);
 		}
 		d->bit_cnt = 0;
 	}
 }
 
+void decoder_reconfigure(LTCDecoder *d, int apv) {
+	/* restart the bit-parser, queued frames and statistics are retained */
+	if (d->early) {
+		early_retract(d, d->frame_start_prev);
+	}
+	d->bit_cnt = 0;
+	d->decoder_sync_word = 0;
+	d->frame_start_prev = -1;
+	d->snd_to_biphase_cnt = 0;
+	memset(d->match_hist, 0, sizeof(d->match_hist));
+
+	if (apv > 0) {
+		d->snd_to_biphase_period = apv / 80.0;
+		d->snd_to_biphase_lmt = (d->snd_to_biphase_period * 3) / 4;
+	}
+	if (d->detect) {
+		decoder_detect_restart(d);
+	}
+}
+
 static inline void biphase_decode2(LTCDecoder *d, ltc_off_t offset, ltc_off_t pos) {
 
 	d->biphase_tics[d->biphase_tic] = d->snd_to_biphase_period;
@@ -282,10 +526,79 @@ static inline void biphase_decode2(LTCDecoder *d, ltc_off_t offset, ltc_off_t po
 	d->biphase_prev = d->snd_to_biphase_state;
 }
 
-void decode_ltc(LTCDecoder *d, ltcsnd_sample_t *sound, size_t size, ltc_off_t posinfo) {
-	size_t i;
+/**
+ * handle a biphase state change at sample \p i
+ * (common to all sample formats, the caller does the level detection)
+ */
+static inline void biphase_state_change(LTCDecoder *d, size_t i, ltc_off_t posinfo) {
+	d->stats.edges++;
+
+	if (d->detect && d->detect_edges < LTC_DETECT_EDGES) {
+		detect_interval(d);
+	}
+
+	/* If the sample count has risen above the biphase length limit */
+	if (d->snd_to_biphase_cnt > d->snd_to_biphase_lmt) {
+		/* single state change within a biphase priod. decode to a 0 */
+		biphase_decode2(d, i, posinfo);
+		biphase_decode2(d, i, posinfo);
+
+	} else {
+		/* "short" state change covering half a period
+		 * together with the next or previous state change decode to a 1
+		 */
+		d->snd_to_biphase_cnt *= 2;
+		biphase_decode2(d, i, posinfo);
+
+	}
+
+#define SWITCH_FIX_SILENCE_LOGIC_BUG
+#ifdef SWITCH_FIX_SILENCE_LOGIC_BUG
+	// The original code pre 2/20/2025 had a bug that noise at line level values (128 +/- 2) could cause snd_to_biphase_period
+	// to be small, approximately 2.0, after which all valid periods, which for 25fps at 44100 are about 11 samples, would
+	// be interpreted as silence and would *not* update the period, perpetuating the interpretation that all remaining samples are silence.
+	//
+	// The fix is to strengthen the silence test by adding a comparison with "min_silence_num_samples_threshold".
+	// This constant must exceed max samples per period for 30fps @ 48kHz (the max period) = about 15 to avoid interpreting valid periods as silence.
+	// But to do its job of ensuring valid periods for 25fps @22050 (the min period) = about 5 are NOT silence, it must be less than 4 * 5 = 20, using 
+	// the "4 * period = silence" policy of original code.
+	static size_t const min_silence_num_samples_threshold = 16; 
+	if (d->snd_to_biphase_cnt > (d->snd_to_biphase_period * 4) && d->snd_to_biphase_cnt > min_silence_num_samples_threshold) {
+#else
+	if (d->snd_to_biphase_cnt > (d->snd_to_biphase_period * 4)) {
+#endif
+		/* "long" silence in between
+		 * -> reset parser, don't use it for phase-tracking
+		 */
+		d->bit_cnt = 0;
+		d->stats.silence_resets++;
+		if (d->early) {
+			early_retract(d, posinfo + i);
+		}
+		if (d->detect && d->detect_edges == LTC_DETECT_EDGES) {
+			/* the source may have changed */
+			decoder_detect_restart(d);
+		}
+	} else  {
+		/* track speed variations
+		 * As this is only executed at a state change,
+		 * d->snd_to_biphase_cnt is an accurate representation of the current period length.
+		 */
+		d->snd_to_biphase_period = (d->snd_to_biphase_period * 3.0 + d->snd_to_biphase_cnt) / 4.0;
 
-	for (i = 0 ; i < size ; i++) {
+		/* This limit specifies when a state-change is
+		 * considered biphase-clock or 2*biphase-clock.
+		 * The relation with period has been determined
+		 * empirically through trial-and-error */
+		d->snd_to_biphase_lmt = (d->snd_to_biphase_period * 3) / 4;
+	}
+
+	d->snd_to_biphase_cnt = 0;
+	d->snd_to_biphase_state = !d->snd_to_biphase_state;
+}
+
+static void decode_ltc_u8_scalar(LTCDecoder *d, ltcsnd_sample_t *sound, size_t i, size_t size, ltc_off_t posinfo) {
+	for (; i < size ; i++) {
 		ltcsnd_sample_t max_threshold, min_threshold;
 
 		/* track minimum and maximum values */
@@ -305,58 +618,742 @@ void decode_ltc(LTCDecoder *d, ltcsnd_sample_t *sound, size_t size, ltc_off_t po
 			   (  d->snd_to_biphase_state && (sound[i] > max_threshold) )
 			|| ( !d->snd_to_biphase_state && (sound[i] < min_threshold) )
 		   ) {
+			biphase_state_change(d, i, posinfo);
+		}
+		d->snd_to_biphase_cnt++;
+	}
+}
+
+/* Native sample-format decoder core.
+ *
+ * Samples are normalized to -1..+1 in a register and the envelope is
+ * tracked at full float precision (no intermediate 8 bit buffer).
+ * The hysteresis does not drop below min_threshold_native (-60 dBFS),
+ * otherwise low-level noise on a silent input would toggle the state.
+ */
+static const float min_threshold_native = 0.001f;
 
-			/* If the sample count has risen above the biphase length limit */
-			if (d->snd_to_biphase_cnt > d->snd_to_biphase_lmt) {
-				/* single state change within a biphase priod. decode to a 0 */
-				biphase_decode2(d, i, posinfo);
-				biphase_decode2(d, i, posinfo);
+#define DECODE_LTC_TEMPLATE(FN, FORMAT, CONV) \
+static void decode_ltc_ ## FN ## _scalar (LTCDecoder *d, FORMAT *sound, size_t stride, size_t i, size_t size, ltc_off_t posinfo) { \
+	float env_min = d->snd_env_min; \
+	float env_max = d->snd_env_max; \
+	for (; i < size ; i++) { \
+		const float s = CONV; \
+		float max_threshold, min_threshold; \
+		/* track minimum and maximum values */ \
+		env_min *= 15.f / 16.f; \
+		env_max *= 15.f / 16.f; \
+		if (s < env_min) env_min = s; \
+		if (s > env_max) env_max = s; \
+		/* set the thresholds for hi/lo state tracking */ \
+		min_threshold = env_min * (8.f / 16.f); \
+		max_threshold = env_max * (8.f / 16.f); \
+		if (min_threshold > -min_threshold_native) min_threshold = -min_threshold_native; \
+		if (max_threshold <  min_threshold_native) max_threshold =  min_threshold_native; \
+		if ( /* Check for a biphase state change */ \
+				(  d->snd_to_biphase_state && (s > max_threshold) ) \
+				|| ( !d->snd_to_biphase_state && (s < min_threshold) ) \
+			 ) { \
+			d->snd_env_min = env_min; \
+			d->snd_env_max = env_max; \
+			biphase_state_change(d, i, posinfo); \
+		} \
+		d->snd_to_biphase_cnt++; \
+	} \
+	d->snd_env_min = env_min; \
+	d->snd_env_max = env_max; \
+}
 
-			} else {
-				/* "short" state change covering half a period
-				 * together with the next or previous state change decode to a 1
-				 */
-				d->snd_to_biphase_cnt *= 2;
-				biphase_decode2(d, i, posinfo);
+DECODE_LTC_TEMPLATE(float, float, sound[i * stride])
+DECODE_LTC_TEMPLATE(double, double, (float) sound[i * stride])
+DECODE_LTC_TEMPLATE(s16, short, sound[i * stride] * (1.f / 32768.f))
+DECODE_LTC_TEMPLATE(u16, unsigned short, ((int)sound[i * stride] - 32768) * (1.f / 32768.f))
 
-			}
+/* little-endian PCM as found in audio files, read byte by byte
+ * (independent of host byte order and alignment)
+ */
+static inline float pcm_u8(const unsigned char *p) {
+	return ((int)p[0] - 128) * (1.f / 128.f);
+}
 
-#define SWITCH_FIX_SILENCE_LOGIC_BUG
-#ifdef SWITCH_FIX_SILENCE_LOGIC_BUG
-			// The original code pre 2/20/2025 had a bug that noise at line level values (128 +/- 2) could cause snd_to_biphase_period
-			// to be small, approximately 2.0, after which all valid periods, which for 25fps at 44100 are about 11 samples, would
-			// be interpreted as silence and would *not* update the period, perpetuating the interpretation that all remaining samples are silence.
-			//
-			// The fix is to strengthen the silence test by adding a comparison with "min_silence_num_samples_threshold".
-			// This constant must exceed max samples per period for 30fps @ 48kHz (the max period) = about 15 to avoid interpreting valid periods as silence.
-			// But to do its job of ensuring valid periods for 25fps @22050 (the min period) = about 5 are NOT silence, it must be less than 4 * 5 = 20, using 
-			// the "4 * period = silence" policy of original code.
-			static size_t const min_silence_num_samples_threshold = 16; 
-			if (d->snd_to_biphase_cnt > (d->snd_to_biphase_period * 4) && d->snd_to_biphase_cnt > min_silence_num_samples_threshold) {
+static inline float pcm_s16(const unsigned char *p) {
+	return (int16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8)) * (1.f / 32768.f);
+}
+
+static inline float pcm_s24(const unsigned char *p) {
+	return (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) * (1.f / 2147483648.f);
+}
+
+static inline uint32_t pcm_f32_bits(const unsigned char *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline float pcm_f32(const unsigned char *p) {
+	const uint32_t u = pcm_f32_bits(p);
+	float f;
+	memcpy(&f, &u, sizeof(float));
+	return f;
+}
+
+static inline float pcm_f64(const unsigned char *p) {
+	const uint64_t u = (uint64_t)pcm_f32_bits(p) | ((uint64_t)pcm_f32_bits(p + 4) << 32);
+	double f;
+	memcpy(&f, &u, sizeof(double));
+	return (float) f;
+}
+
+static inline float pcm_s32(const unsigned char *p) {
+	return (int32_t)pcm_f32_bits(p) * (1.f / 2147483648.f);
+}
+
+DECODE_LTC_TEMPLATE(pcm_u8, const unsigned char, pcm_u8(&sound[i * stride]))
+DECODE_LTC_TEMPLATE(pcm_s16, const unsigned char, pcm_s16(&sound[i * stride]))
+DECODE_LTC_TEMPLATE(pcm_s24, const unsigned char, pcm_s24(&sound[i * stride]))
+DECODE_LTC_TEMPLATE(pcm_s32, const unsigned char, pcm_s32(&sound[i * stride]))
+DECODE_LTC_TEMPLATE(pcm_f32, const unsigned char, pcm_f32(&sound[i * stride]))
+DECODE_LTC_TEMPLATE(pcm_f64, const unsigned char, pcm_f64(&sound[i * stride]))
+
+#undef DECODE_LTC_TEMPLATE
+
+#ifdef LTC_DECODE_SIMD
+/* Vectorized envelope/threshold pre-pass.
+ *
+ * The envelope recurrence  env[i] = max (decay (env[i-1]), dist (sound[i]))
+ * does not depend on the biphase state. Since decay() is monotonic it
+ * distributes over max(), and a block of samples can be processed with
+ * a log-step prefix-scan. The pre-pass yields a bitmask of samples that
+ * exceed the upper threshold and one for samples below the lower threshold.
+ * The scalar state-machine then only visits samples where a state change
+ * happens: every transition flips the state, so the next candidate is the
+ * next set bit in the other mask.
+ *
+ * For 8 bit input the envelope is tracked as distance from SAMPLE_CENTER.
+ * decay(v) = (v * 15) / 16 is computed as v - ceil (v / 16) which is exact
+ * for 0 <= v <= 128, so results are identical to decode_ltc_u8_scalar().
+ */
+#define LTC_SIMD_BLOCK 64
+
+static inline int ctz64(uint64_t m) {
+#if defined __GNUC__
+	return __builtin_ctzll(m);
+#elif defined _MSC_VER && defined _M_X64
+	unsigned long idx;
+	_BitScanForward64(&idx, m);
+	return idx;
 #else
-			if (d->snd_to_biphase_cnt > (d->snd_to_biphase_period * 4)) {
+	int n = 0;
+	while (!(m & 1)) { m >>= 1; ++n; }
+	return n;
 #endif
-				/* "long" silence in between
-				 * -> reset parser, don't use it for phase-tracking
-				 */
-				d->bit_cnt = 0;
-			} else  {
-				/* track speed variations
-				 * As this is only executed at a state change,
-				 * d->snd_to_biphase_cnt is an accurate representation of the current period length.
-				 */
-				d->snd_to_biphase_period = (d->snd_to_biphase_period * 3.0 + d->snd_to_biphase_cnt) / 4.0;
-
-				/* This limit specifies when a state-change is
-				 * considered biphase-clock or 2*biphase-clock.
-				 * The relation with period has been determined
-				 * empirically through trial-and-error */
-				d->snd_to_biphase_lmt = (d->snd_to_biphase_period * 3) / 4;
-			}
+}
 
-			d->snd_to_biphase_cnt = 0;
-			d->snd_to_biphase_state = !d->snd_to_biphase_state;
+/* run the state-machine for all transitions in a pre-processed block */
+static void biphase_walk(LTCDecoder *d, uint64_t lo, uint64_t hi, size_t base, size_t n, ltc_off_t posinfo,
+		const unsigned char *dmin, const unsigned char *dmax, const float *fmin, const float *fmax)
+{
+	size_t pos = 0;
+	for (;;) {
+		uint64_t m = d->snd_to_biphase_state ? hi : lo;
+		size_t i;
+		if (pos >= LTC_SIMD_BLOCK) break;
+		m &= ~(uint64_t)0 << pos;
+		if (!m) break;
+		i = ctz64(m);
+		d->snd_to_biphase_cnt += i - pos;
+		if (dmin) {
+			d->snd_to_biphase_min = SAMPLE_CENTER - dmin[i];
+			d->snd_to_biphase_max = SAMPLE_CENTER + dmax[i];
+		} else {
+			d->snd_env_min = -fmin[i];
+			d->snd_env_max = fmax[i];
 		}
+		biphase_state_change(d, base + i, posinfo);
 		d->snd_to_biphase_cnt++;
+		pos = i + 1;
+	}
+	d->snd_to_biphase_cnt += n - pos;
+	if (dmin) {
+		d->snd_to_biphase_min = SAMPLE_CENTER - dmin[n - 1];
+		d->snd_to_biphase_max = SAMPLE_CENTER + dmax[n - 1];
+	} else {
+		d->snd_env_min = -fmin[n - 1];
+		d->snd_env_max = fmax[n - 1];
+	}
+}
+
+#if defined LTC_DECODE_SSE2
+
+static inline __m128i env_decay_u8(__m128i v) {
+	const __m128i c15 = _mm_set1_epi8(15);
+	const __m128i m0f = _mm_set1_epi8(0x0f);
+	return _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi16(_mm_add_epi8(v, c15), 4), m0f));
+}
+
+/* process n samples (multiple of 8, <= LTC_SIMD_BLOCK).
+ * The low 64 bits of each vector hold the distance of 8 samples below
+ * SAMPLE_CENTER (min envelope), the high 64 bits above (max envelope).
+ * Shifting each 64 bit half by 8 bits moves all samples by one.
+ */
+static void envelope_prepass_u8(LTCDecoder *d, const ltcsnd_sample_t *sound, size_t n,
+		unsigned char *dmin, unsigned char *dmax, uint64_t *lo, uint64_t *hi)
+{
+	const __m128i center = _mm_set1_epi8((char)SAMPLE_CENTER);
+	const __m128i m7f = _mm_set1_epi8(0x7f);
+	const __m128i zero = _mm_setzero_si128();
+	int cmin = SAMPLE_CENTER - d->snd_to_biphase_min;
+	int cmax = d->snd_to_biphase_max - SAMPLE_CENTER;
+	uint64_t mlo = 0, mhi = 0;
+	size_t k;
+
+	for (k = 0; k < n; k += 8) {
+		const __m128i s = _mm_loadl_epi64((const __m128i*)(sound + k));
+		const __m128i x = _mm_unpacklo_epi64(_mm_subs_epu8(center, s), _mm_subs_epu8(s, center));
+		__m128i y, t;
+		int m;
+
+		/* carry-in: the decayed envelope of the previous sample */
+		y = _mm_insert_epi16(_mm_insert_epi16(zero, (cmin * 15) / 16, 0), (cmax * 15) / 16, 4);
+		y = _mm_max_epu8(x, y);
+
+		/* prefix-scan */
+		t = env_decay_u8(_mm_slli_epi64(y, 8));
+		y = _mm_max_epu8(y, t);
+		t = env_decay_u8(env_decay_u8(_mm_slli_epi64(y, 16)));
+		y = _mm_max_epu8(y, t);
+		t = env_decay_u8(env_decay_u8(env_decay_u8(env_decay_u8(_mm_slli_epi64(y, 32)))));
+		y = _mm_max_epu8(y, t);
+
+		/* threshold is half the envelope, x > t <=> saturated (x - t) != 0 */
+		t = _mm_and_si128(_mm_srli_epi16(y, 1), m7f);
+		m = ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(x, t), zero));
+
+		mlo |= (uint64_t)(m & 0xff) << k;
+		mhi |= (uint64_t)((m >> 8) & 0xff) << k;
+
+		_mm_storel_epi64((__m128i*)(dmin + k), y);
+		_mm_storel_epi64((__m128i*)(dmax + k), _mm_unpackhi_epi64(y, y));
+		cmin = _mm_extract_epi16(y, 3) >> 8;
+		cmax = _mm_extract_epi16(y, 7) >> 8;
+	}
+	*lo = mlo;
+	*hi = mhi;
+}
+
+/* process n samples (multiple of 4, <= LTC_SIMD_BLOCK).
+ * The float envelope is tracked as magnitude (fmin = -env_min).
+ */
+static void envelope_prepass_float(LTCDecoder *d, const float *sound, size_t n,
+		float *fmin, float *fmax, uint64_t *lo, uint64_t *hi)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 k1 = _mm_set1_ps(15.f / 16.f);
+	const __m128 k2 = _mm_set1_ps((15.f / 16.f) * (15.f / 16.f));
+	const __m128 half = _mm_set1_ps(8.f / 16.f);
+	const __m128 thr_floor = _mm_set1_ps(min_threshold_native);
+	float cmin = -d->snd_env_min;
+	float cmax = d->snd_env_max;
+	uint64_t mlo = 0, mhi = 0;
+	size_t k;
+
+	for (k = 0; k < n; k += 4) {
+		const __m128 s = _mm_loadu_ps(sound + k);
+		const __m128 xmin = _mm_max_ps(_mm_sub_ps(zero, s), zero);
+		const __m128 xmax = _mm_max_ps(s, zero);
+		__m128 ymin, ymax;
+
+		ymin = _mm_max_ps(xmin, _mm_set_ss(cmin * (15.f / 16.f)));
+		ymax = _mm_max_ps(xmax, _mm_set_ss(cmax * (15.f / 16.f)));
+
+		ymin = _mm_max_ps(ymin, _mm_mul_ps(k1, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(ymin), 4))));
+		ymax = _mm_max_ps(ymax, _mm_mul_ps(k1, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(ymax), 4))));
+		ymin = _mm_max_ps(ymin, _mm_mul_ps(k2, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(ymin), 8))));
+		ymax = _mm_max_ps(ymax, _mm_mul_ps(k2, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(ymax), 8))));
+
+		mlo |= (uint64_t)_mm_movemask_ps(_mm_cmpgt_ps(xmin, _mm_max_ps(_mm_mul_ps(ymin, half), thr_floor))) << k;
+		mhi |= (uint64_t)_mm_movemask_ps(_mm_cmpgt_ps(xmax, _mm_max_ps(_mm_mul_ps(ymax, half), thr_floor))) << k;
+
+		_mm_storeu_ps(fmin + k, ymin);
+		_mm_storeu_ps(fmax + k, ymax);
+		cmin = fmin[k + 3];
+		cmax = fmax[k + 3];
+	}
+	*lo = mlo;
+	*hi = mhi;
+}
+
+#elif defined LTC_DECODE_NEON
+
+static inline uint8x16_t env_decay_u8(uint8x16_t v) {
+	return vsubq_u8(v, vshrq_n_u8(vaddq_u8(v, vdupq_n_u8(15)), 4));
+}
+
+static inline uint8x16_t shl64_u8(uint8x16_t v, const int bits) {
+	return vreinterpretq_u8_u64(vshlq_u64(vreinterpretq_u64_u8(v), vdupq_n_s64(bits)));
+}
+
+/* see the SSE2 variant above for the data layout */
+static void envelope_prepass_u8(LTCDecoder *d, const ltcsnd_sample_t *sound, size_t n,
+		unsigned char *dmin, unsigned char *dmax, uint64_t *lo, uint64_t *hi)
+{
+	static const uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+	const uint8x8_t center = vdup_n_u8(SAMPLE_CENTER);
+	const uint8x16_t weight = vld1q_u8(bits);
+	unsigned int cmin = SAMPLE_CENTER - d->snd_to_biphase_min;
+	unsigned int cmax = d->snd_to_biphase_max - SAMPLE_CENTER;
+	uint64_t mlo = 0, mhi = 0;
+	size_t k;
+
+	for (k = 0; k < n; k += 8) {
+		const uint8x8_t s = vld1_u8(sound + k);
+		const uint8x16_t x = vcombine_u8(vqsub_u8(center, s), vqsub_u8(s, center));
+		uint8x16_t y, m;
+
+		y = vcombine_u8(vcreate_u8((cmin * 15) / 16), vcreate_u8((cmax * 15) / 16));
+		y = vmaxq_u8(x, y);
+
+		y = vmaxq_u8(y, env_decay_u8(shl64_u8(y, 8)));
+		y = vmaxq_u8(y, env_decay_u8(env_decay_u8(shl64_u8(y, 16))));
+		y = vmaxq_u8(y, env_decay_u8(env_decay_u8(env_decay_u8(env_decay_u8(shl64_u8(y, 32))))));
+
+		m = vandq_u8(vcgtq_u8(x, vshrq_n_u8(y, 1)), weight);
+		mlo |= (uint64_t)vaddv_u8(vget_low_u8(m)) << k;
+		mhi |= (uint64_t)vaddv_u8(vget_high_u8(m)) << k;
+
+		vst1_u8(dmin + k, vget_low_u8(y));
+		vst1_u8(dmax + k, vget_high_u8(y));
+		cmin = vgetq_lane_u8(y, 7);
+		cmax = vgetq_lane_u8(y, 15);
+	}
+	*lo = mlo;
+	*hi = mhi;
+}
+
+static void envelope_prepass_float(LTCDecoder *d, const float *sound, size_t n,
+		float *fmin, float *fmax, uint64_t *lo, uint64_t *hi)
+{
+	static const uint32_t bits[4] = {1, 2, 4, 8};
+	const float32x4_t zero = vdupq_n_f32(0);
+	const float32x4_t thr_floor = vdupq_n_f32(min_threshold_native);
+	const uint32x4_t weight = vld1q_u32(bits);
+	const float k1 = 15.f / 16.f;
+	const float k2 = (15.f / 16.f) * (15.f / 16.f);
+	float cmin = -d->snd_env_min;
+	float cmax = d->snd_env_max;
+	uint64_t mlo = 0, mhi = 0;
+	size_t k;
+
+	for (k = 0; k < n; k += 4) {
+		const float32x4_t s = vld1q_f32(sound + k);
+		const float32x4_t xmin = vmaxq_f32(vnegq_f32(s), zero);
+		const float32x4_t xmax = vmaxq_f32(s, zero);
+		float32x4_t ymin, ymax;
+
+		ymin = vmaxq_f32(xmin, vsetq_lane_f32(cmin * k1, zero, 0));
+		ymax = vmaxq_f32(xmax, vsetq_lane_f32(cmax * k1, zero, 0));
+
+		ymin = vmaxq_f32(ymin, vmulq_n_f32(vextq_f32(zero, ymin, 3), k1));
+		ymax = vmaxq_f32(ymax, vmulq_n_f32(vextq_f32(zero, ymax, 3), k1));
+		ymin = vmaxq_f32(ymin, vmulq_n_f32(vextq_f32(zero, ymin, 2), k2));
+		ymax = vmaxq_f32(ymax, vmulq_n_f32(vextq_f32(zero, ymax, 2), k2));
+
+		mlo |= (uint64_t)vaddvq_u32(vandq_u32(vcgtq_f32(xmin, vmaxq_f32(vmulq_n_f32(ymin, .5f), thr_floor)), weight)) << k;
+		mhi |= (uint64_t)vaddvq_u32(vandq_u32(vcgtq_f32(xmax, vmaxq_f32(vmulq_n_f32(ymax, .5f), thr_floor)), weight)) << k;
+
+		vst1q_f32(fmin + k, ymin);
+		vst1q_f32(fmax + k, ymax);
+		cmin = vgetq_lane_f32(ymin, 3);
+		cmax = vgetq_lane_f32(ymax, 3);
+	}
+	*lo = mlo;
+	*hi = mhi;
+}
+
+#endif /* LTC_DECODE_NEON */
+#endif /* LTC_DECODE_SIMD */
+
+static void decode_ltc_float_native(LTCDecoder *d, float *sound, size_t stride, size_t size, ltc_off_t posinfo) {
+	size_t i = 0;
+
+	d->snd_native = 1;
+	d->stats.samples += size;
+
+#ifdef LTC_DECODE_SIMD
+	while (stride == 1 && size - i >= 4) {
+		float fmin[LTC_SIMD_BLOCK], fmax[LTC_SIMD_BLOCK];
+		uint64_t lo, hi;
+		size_t n = size - i;
+		if (n > LTC_SIMD_BLOCK) n = LTC_SIMD_BLOCK;
+		n &= ~(size_t)3;
+		envelope_prepass_float(d, sound + i, n, fmin, fmax, &lo, &hi);
+		biphase_walk(d, lo, hi, i, n, posinfo, NULL, NULL, fmin, fmax);
+		i += n;
+	}
+#endif
+
+	decode_ltc_float_scalar(d, sound, stride, i, size, posinfo);
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Matched filter front end, LTC_DECODER_MATCHED
+ *
+ * Biphase-mark code consists of rectangular pulses of half a bit
+ * period (two for a 1 bit) or a full bit period (a 0 bit). The input is
+ * correlated with the half-bit pulse, which is a moving average over
+ * len = period / 2 samples. This is the optimal linear detector for
+ * the pulse in white noise, and it also removes the ringing and
+ * pre-echo that lossy codecs or band-limited transmission add around
+ * each edge. The correlation crosses zero in the middle of an edge,
+ * so the unmodified threshold detector runs on the filter output, and
+ * positions are corrected for the filter delay of (len - 1) / 2 samples.
+ *
+ * The running sum  y[j] = y[j - 1] + x[j] - x[j - len]  is computed four
+ * samples at a time with an in-register prefix-sum, and it is restarted
+ * for every block so that rounding errors do not accumulate.
+ */
+
+static int match_len(const LTCDecoder *d) {
+	int len = d->snd_to_biphase_period / 2;
+	if (len < 1) len = 1;
+	if (len > LTC_MATCH_MAX) len = LTC_MATCH_MAX;
+	return len;
+}
+
+/** moving average of len samples, x[-len..-1] are the preceding samples */
+static void match_filter(const float *x, float *y, size_t n, int len) {
+	const float gain = 1.f / len;
+	float sum = 0;
+	size_t j = 0;
+	int k;
+
+	for (k = 1; k <= len; ++k) {
+		sum += x[-k];
+	}
+
+#if defined LTC_DECODE_SSE2
+	{
+		const __m128 g = _mm_set1_ps(gain);
+		__m128 acc = _mm_set1_ps(sum);
+		for (; j + 4 <= n; j += 4) {
+			__m128 v = _mm_sub_ps(_mm_loadu_ps(&x[j]), _mm_loadu_ps(&x[(ptrdiff_t)j - len]));
+			v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)));
+			v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 8)));
+			v = _mm_add_ps(v, acc);
+			acc = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+			_mm_storeu_ps(&y[j], _mm_mul_ps(v, g));
+		}
+		sum = _mm_cvtss_f32(acc);
 	}
+#elif defined LTC_DECODE_NEON
+	{
+		const float32x4_t z = vdupq_n_f32(0);
+		float32x4_t acc = vdupq_n_f32(sum);
+		for (; j + 4 <= n; j += 4) {
+			float32x4_t v = vsubq_f32(vld1q_f32(&x[j]), vld1q_f32(&x[(ptrdiff_t)j - len]));
+			v = vaddq_f32(v, vextq_f32(z, v, 3));
+			v = vaddq_f32(v, vextq_f32(z, v, 2));
+			v = vaddq_f32(v, acc);
+			acc = vdupq_laneq_f32(v, 3);
+			vst1q_f32(&y[j], vmulq_n_f32(v, gain));
+		}
+		sum = vgetq_lane_f32(acc, 0);
+	}
+#endif
+
+	for (; j < n; ++j) {
+		sum += x[j] - x[(ptrdiff_t)j - len];
+		y[j] = sum * gain;
+	}
+}
+
+/**
+ * filter and decode the samples x[LTC_MATCH_MAX .. LTC_MATCH_MAX + n),
+ * x[0 .. LTC_MATCH_MAX) is filled with the previous input
+ */
+static void match_block(LTCDecoder *d, float *x, size_t n, ltc_off_t posinfo) {
+	float y[LTC_MATCH_BLOCK];
+	const int len = match_len(d);
+
+	memcpy(x, d->match_hist, sizeof(d->match_hist));
+	match_filter(&x[LTC_MATCH_MAX], y, n, len);
+	memcpy(d->match_hist, &x[n], sizeof(d->match_hist));
+
+	decode_ltc_float_native(d, y, 1, n, posinfo - (len - 1) / 2);
+}
+
+#define MATCH_LTC_TEMPLATE(FN, FORMAT, CONV) \
+static void match_ltc_ ## FN (LTCDecoder *d, FORMAT *sound, size_t stride, size_t size, ltc_off_t posinfo) { \
+	float x[LTC_MATCH_MAX + LTC_MATCH_BLOCK]; \
+	size_t off; \
+	for (off = 0; off < size; off += LTC_MATCH_BLOCK) { \
+		size_t i, n = size - off; \
+		if (n > LTC_MATCH_BLOCK) n = LTC_MATCH_BLOCK; \
+		for (i = 0; i < n; ++i) { \
+			x[LTC_MATCH_MAX + i] = CONV; \
+		} \
+		match_block(d, x, n, posinfo + off); \
+	} \
+}
+
+MATCH_LTC_TEMPLATE(u8, ltcsnd_sample_t, ((int)sound[(off + i) * stride] - SAMPLE_CENTER) * (1.f / 128.f))
+MATCH_LTC_TEMPLATE(float, float, sound[(off + i) * stride])
+MATCH_LTC_TEMPLATE(double, double, (float) sound[(off + i) * stride])
+MATCH_LTC_TEMPLATE(s16, short, sound[(off + i) * stride] * (1.f / 32768.f))
+MATCH_LTC_TEMPLATE(u16, unsigned short, ((int)sound[(off + i) * stride] - 32768) * (1.f / 32768.f))
+MATCH_LTC_TEMPLATE(pcm_u8, const unsigned char, pcm_u8(&sound[(off + i) * stride]))
+MATCH_LTC_TEMPLATE(pcm_s16, const unsigned char, pcm_s16(&sound[(off + i) * stride]))
+MATCH_LTC_TEMPLATE(pcm_s24, const unsigned char, pcm_s24(&sound[(off + i) * stride]))
+MATCH_LTC_TEMPLATE(pcm_s32, const unsigned char, pcm_s32(&sound[(off + i) * stride]))
+MATCH_LTC_TEMPLATE(pcm_f32, const unsigned char, pcm_f32(&sound[(off + i) * stride]))
+MATCH_LTC_TEMPLATE(pcm_f64, const unsigned char, pcm_f64(&sound[(off + i) * stride]))
+
+#undef MATCH_LTC_TEMPLATE
+
+void decode_ltc(LTCDecoder *d, ltcsnd_sample_t *sound, size_t size, ltc_off_t posinfo) {
+	size_t i = 0;
+
+	if (d->matched) {
+		match_ltc_u8(d, sound, 1, size, posinfo);
+		return;
+	}
+
+	d->snd_native = 0;
+	d->stats.samples += size;
+
+#ifdef LTC_DECODE_SIMD
+	while (size - i >= 8) {
+		unsigned char dmin[LTC_SIMD_BLOCK], dmax[LTC_SIMD_BLOCK];
+		uint64_t lo, hi;
+		size_t n = size - i;
+		if (n > LTC_SIMD_BLOCK) n = LTC_SIMD_BLOCK;
+		n &= ~(size_t)7;
+		envelope_prepass_u8(d, sound + i, n, dmin, dmax, &lo, &hi);
+		biphase_walk(d, lo, hi, i, n, posinfo, dmin, dmax, NULL, NULL);
+		i += n;
+	}
+#endif
+
+	decode_ltc_u8_scalar(d, sound, i, size, posinfo);
+}
+
+void decode_ltc_float(LTCDecoder *d, float *sound, size_t stride, size_t size, ltc_off_t posinfo) {
+	if (d->matched) {
+		match_ltc_float(d, sound, stride, size, posinfo);
+		return;
+	}
+	decode_ltc_float_native(d, sound, stride, size, posinfo);
+}
+
+void decode_ltc_double(LTCDecoder *d, double *sound, size_t stride, size_t size, ltc_off_t posinfo) {
+	if (d->matched) {
+		match_ltc_double(d, sound, stride, size, posinfo);
+		return;
+	}
+	d->snd_native = 1;
+	d->stats.samples += size;
+	decode_ltc_double_scalar(d, sound, stride, 0, size, posinfo);
+}
+
+void decode_ltc_s16(LTCDecoder *d, short *sound, size_t stride, size_t size, ltc_off_t posinfo) {
+	if (d->matched) {
+		match_ltc_s16(d, sound, stride, size, posinfo);
+		return;
+	}
+	d->snd_native = 1;
+	d->stats.samples += size;
+	decode_ltc_s16_scalar(d, sound, stride, 0, size, posinfo);
+}
+
+void decode_ltc_u16(LTCDecoder *d, unsigned short *sound, size_t stride, size_t size, ltc_off_t posinfo) {
+	if (d->matched) {
+		match_ltc_u16(d, sound, stride, size, posinfo);
+		return;
+	}
+	d->snd_native = 1;
+	d->stats.samples += size;
+	decode_ltc_u16_scalar(d, sound, stride, 0, size, posinfo);
+}
+
+void decode_ltc_pcm(LTCDecoder *d, const unsigned char *sound, enum LTCPcmFormat fmt, size_t stride, size_t size, ltc_off_t posinfo) {
+#if defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	if (fmt == LTC_PCM_FLOAT && stride == sizeof(float) && ((uintptr_t)sound % sizeof(float)) == 0) {
+		/* use the vectorized path for mono, aligned input */
+		decode_ltc_float(d, (float*)sound, 1, size, posinfo);
+		return;
+	}
+#endif
+
+	if (d->matched) {
+		switch (fmt) {
+			case LTC_PCM_U8:
+				match_ltc_pcm_u8(d, sound, stride, size, posinfo);
+				break;
+			case LTC_PCM_S16:
+				match_ltc_pcm_s16(d, sound, stride, size, posinfo);
+				break;
+			case LTC_PCM_S24:
+				match_ltc_pcm_s24(d, sound, stride, size, posinfo);
+				break;
+			case LTC_PCM_S32:
+				match_ltc_pcm_s32(d, sound, stride, size, posinfo);
+				break;
+			case LTC_PCM_FLOAT:
+				match_ltc_pcm_f32(d, sound, stride, size, posinfo);
+				break;
+			case LTC_PCM_DOUBLE:
+				match_ltc_pcm_f64(d, sound, stride, size, posinfo);
+				break;
+		}
+		return;
+	}
+
+	d->snd_native = 1;
+	d->stats.samples += size;
+
+	switch (fmt) {
+		case LTC_PCM_U8:
+			decode_ltc_pcm_u8_scalar(d, sound, stride, 0, size, posinfo);
+			break;
+		case LTC_PCM_S16:
+			decode_ltc_pcm_s16_scalar(d, sound, stride, 0, size, posinfo);
+			break;
+		case LTC_PCM_S24:
+			decode_ltc_pcm_s24_scalar(d, sound, stride, 0, size, posinfo);
+			break;
+		case LTC_PCM_S32:
+			decode_ltc_pcm_s32_scalar(d, sound, stride, 0, size, posinfo);
+			break;
+		case LTC_PCM_FLOAT:
+			decode_ltc_pcm_f32_scalar(d, sound, stride, 0, size, posinfo);
+			break;
+		case LTC_PCM_DOUBLE:
+			decode_ltc_pcm_f64_scalar(d, sound, stride, 0, size, posinfo);
+			break;
+	}
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Decoder bank
+ *
+ * Interleaved input is processed time-major: for every audio-frame
+ * the level detector of all channels [c0, c1) is updated using the
+ * bank's per channel arrays. Only when a channel changes state, its
+ * LTCDecoder is updated and the bit-parser is invoked.
+ *
+ * Planar input uses the single channel decoder for each channel.
+ */
+
+static inline void bank_state_change(LTCDecoderBank *b, int c, size_t i, ltc_off_t posinfo) {
+	LTCDecoder *d = &b->decoders[c];
+	d->snd_to_biphase_cnt = b->cnt[c];
+	biphase_state_change(d, i, posinfo);
+	b->cnt[c] = d->snd_to_biphase_cnt;
+	b->state[c] = d->snd_to_biphase_state;
+}
+
+static inline void bank_step_u8(LTCDecoderBank *b, int c, ltcsnd_sample_t s, size_t i, ltc_off_t posinfo) {
+	ltcsnd_sample_t max_threshold, min_threshold;
+	ltcsnd_sample_t snd_min = SAMPLE_CENTER - (((SAMPLE_CENTER - b->snd_min[c]) * 15) / 16);
+	ltcsnd_sample_t snd_max = SAMPLE_CENTER + (((b->snd_max[c] - SAMPLE_CENTER) * 15) / 16);
+
+	if (s < snd_min) snd_min = s;
+	if (s > snd_max) snd_max = s;
+	b->snd_min[c] = snd_min;
+	b->snd_max[c] = snd_max;
+
+	min_threshold = SAMPLE_CENTER - (((SAMPLE_CENTER - snd_min) * 8) / 16);
+	max_threshold = SAMPLE_CENTER + (((snd_max - SAMPLE_CENTER) * 8) / 16);
+
+	if ((b->state[c] && (s > max_threshold)) || (!b->state[c] && (s < min_threshold))) {
+		LTCDecoder *d = &b->decoders[c];
+		d->snd_native = 0;
+		d->snd_to_biphase_min = snd_min;
+		d->snd_to_biphase_max = snd_max;
+		bank_state_change(b, c, i, posinfo);
+	}
+	b->cnt[c]++;
+}
+
+static inline void bank_step_native(LTCDecoderBank *b, int c, float s, size_t i, ltc_off_t posinfo) {
+	float max_threshold, min_threshold;
+	float env_min = b->env_min[c] * (15.f / 16.f);
+	float env_max = b->env_max[c] * (15.f / 16.f);
+
+	if (s < env_min) env_min = s;
+	if (s > env_max) env_max = s;
+	b->env_min[c] = env_min;
+	b->env_max[c] = env_max;
+
+	min_threshold = env_min * (8.f / 16.f);
+	max_threshold = env_max * (8.f / 16.f);
+	if (min_threshold > -min_threshold_native) min_threshold = -min_threshold_native;
+	if (max_threshold <  min_threshold_native) max_threshold =  min_threshold_native;
+
+	if ((b->state[c] && (s > max_threshold)) || (!b->state[c] && (s < min_threshold))) {
+		LTCDecoder *d = &b->decoders[c];
+		d->snd_native = 1;
+		d->snd_env_min = env_min;
+		d->snd_env_max = env_max;
+		bank_state_change(b, c, i, posinfo);
+	}
+	b->cnt[c]++;
 }
+
+/* copy the level detector state between the bank and a channel's decoder */
+static void bank_load(LTCDecoderBank *b, int c) {
+	LTCDecoder *d = &b->decoders[c];
+	d->snd_to_biphase_min = b->snd_min[c];
+	d->snd_to_biphase_max = b->snd_max[c];
+	d->snd_env_min = b->env_min[c];
+	d->snd_env_max = b->env_max[c];
+	d->snd_to_biphase_cnt = b->cnt[c];
+}
+
+static void bank_store(LTCDecoderBank *b, int c) {
+	LTCDecoder *d = &b->decoders[c];
+	b->snd_min[c] = d->snd_to_biphase_min;
+	b->snd_max[c] = d->snd_to_biphase_max;
+	b->env_min[c] = d->snd_env_min;
+	b->env_max[c] = d->snd_env_max;
+	b->cnt[c] = d->snd_to_biphase_cnt;
+	b->state[c] = d->snd_to_biphase_state;
+}
+
+#define DECODE_BANK_TEMPLATE(FN, FORMAT, STEP, CONV, PLANAR) \
+void decode_ltc_bank ## FN (LTCDecoderBank *b, FORMAT *buf, int c0, int c1, size_t size, ltc_off_t posinfo) { \
+	const int nch = b->channels; \
+	size_t i; \
+	int c; \
+	for (i = 0; i < size; ++i) { \
+		FORMAT *const frame = &buf[i * nch]; \
+		for (c = c0; c < c1; ++c) { \
+			STEP (b, c, CONV(frame[c]), i, posinfo); \
+		} \
+	} \
+	for (c = c0; c < c1; ++c) { \
+		b->decoders[c].stats.samples += size; \
+	} \
+} \
+void decode_ltc_bank_planar ## FN (LTCDecoderBank *b, FORMAT **bufs, int c0, int c1, size_t size, ltc_off_t posinfo) { \
+	int c; \
+	for (c = c0; c < c1; ++c) { \
+		bank_load(b, c); \
+		PLANAR; \
+		bank_store(b, c); \
+	} \
+}
+
+#define CONV_U8(x) (x)
+#define CONV_FLOAT(x) (x)
+#define CONV_S16(x) ((x) * (1.f / 32768.f))
+
+DECODE_BANK_TEMPLATE(, ltcsnd_sample_t, bank_step_u8, CONV_U8,
+		decode_ltc(&b->decoders[c], bufs[c], size, posinfo))
+DECODE_BANK_TEMPLATE(_float, float, bank_step_native, CONV_FLOAT,
+		decode_ltc_float(&b->decoders[c], bufs[c], 1, size, posinfo))
+DECODE_BANK_TEMPLATE(_s16, short, bank_step_native, CONV_S16,
+		decode_ltc_s16(&b->decoders[c], bufs[c], 1, size, posinfo))
+
+#undef CONV_U8
+#undef CONV_FLOAT
+#undef CONV_S16
+#undef DECODE_BANK_TEMPLATE
@@ -18,16 +18,67 @@
    If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <stdint.h>
 #include "ltc.h"
 #ifndef SAMPLE_CENTER // also defined in encoder.h
 #define SAMPLE_CENTER 128 // unsigned 8 bit.
 #endif
 
+/* The frame queue is a single-producer/single-consumer ring:
+ * the decoder (ltc_decoder_write) only modifies queue_write_off,
+ * the reader (ltc_decoder_read) only modifies queue_read_off.
+ */
+#if defined __STDC_VERSION__ && __STDC_VERSION__ >= 201112L && !defined __STDC_NO_ATOMICS__
+#include <stdatomic.h>
+typedef atomic_uint ltc_atomic_t;
+#define ltc_atomic_load_acquire(p) atomic_load_explicit(p, memory_order_acquire)
+#define ltc_atomic_load_relaxed(p) atomic_load_explicit(p, memory_order_relaxed)
+#define ltc_atomic_store_release(p, v) atomic_store_explicit(p, v, memory_order_release)
+#define ltc_atomic_store_relaxed(p, v) atomic_store_explicit(p, v, memory_order_relaxed)
+#define ltc_atomic_fence_acquire() atomic_thread_fence(memory_order_acquire)
+#define ltc_atomic_fence_release() atomic_thread_fence(memory_order_release)
+#elif defined __GNUC__
+typedef unsigned int ltc_atomic_t;
+#define ltc_atomic_load_acquire(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define ltc_atomic_load_relaxed(p) __atomic_load_n(p, __ATOMIC_RELAXED)
+#define ltc_atomic_store_release(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define ltc_atomic_store_relaxed(p, v) __atomic_store_n(p, v, __ATOMIC_RELAXED)
+#define ltc_atomic_fence_acquire() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define ltc_atomic_fence_release() __atomic_thread_fence(__ATOMIC_RELEASE)
+#elif defined _MSC_VER
+#include <intrin.h>
+typedef volatile long ltc_atomic_t;
+#define ltc_atomic_load_acquire(p) ((unsigned int)_InterlockedCompareExchange(p, 0, 0))
+#define ltc_atomic_load_relaxed(p) ((unsigned int)*(p))
+#define ltc_atomic_store_release(p, v) _InterlockedExchange(p, (long)(v))
+#define ltc_atomic_store_relaxed(p, v) (*(p) = (long)(v))
+#define ltc_atomic_fence_acquire() _ReadWriteBarrier()
+#define ltc_atomic_fence_release() _ReadWriteBarrier()
+#else
+#error "libltc requires atomic operations (C11 or GNU builtins)"
+#endif
+
+/** size of the early event queue, see LTC_DECODER_EARLY */
+#define LTC_EARLY_QUEUE 8
+
+/** number of transition intervals used to estimate the bit period, see LTC_DECODER_AUTODETECT */
+#define LTC_DETECT_EDGES 64
+/** histogram size, longest transition interval in audio-frames that is considered */
+#define LTC_DETECT_BINS 256
+
+/** maximum length of the matched filter, see LTC_DECODER_MATCHED */
+#define LTC_MATCH_MAX 64
+/** samples filtered per block */
+#define LTC_MATCH_BLOCK 256
+
 struct LTCDecoder {
 	LTCFrameExt* queue;
+	LTCFrameCompact* queue_compact; ///< used instead of queue with LTC_DECODER_COMPACT
+	float* queue_tics; ///< LTC_FRAME_BIT_COUNT bit timings per queue_compact slot, with LTC_DECODER_TICS
 	int queue_len;
-	int queue_read_off;
-	int queue_write_off;
+	ltc_atomic_t queue_read_off; ///< 0 <= off < 2 * queue_len, slot is off % queue_len
+	ltc_atomic_t queue_write_off; ///< the queue is full when write - read == queue_len
+	ltc_atomic_t queue_overruns; ///< count of frames dropped because the queue was full
 
 	unsigned char biphase_state;
 	unsigned char biphase_prev;
@@ -39,8 +90,13 @@ struct LTCDecoder {
 	ltcsnd_sample_t snd_to_biphase_min;
 	ltcsnd_sample_t snd_to_biphase_max;
 
+	unsigned char snd_native; ///< set if the last write used the native (float) envelope below
+	float snd_env_min; ///< envelope of native format input, normalized -1..0
+	float snd_env_max; ///< envelope of native format input, normalized 0..+1
+
 	unsigned short decoder_sync_word;
-	LTCFrame ltc_frame;
+	uint64_t ltc_frame_lo; ///< in-flight frame, LTC bits 0..63 (bit n of the frame is bit n of the register)
+	uint16_t ltc_frame_hi; ///< in-flight frame, LTC bits 64..79
 	int bit_cnt;
 
 	ltc_off_t frame_start_off;
@@ -48,7 +104,76 @@ struct LTCDecoder {
 
 	float biphase_tics[LTC_FRAME_BIT_COUNT];
 	int biphase_tic;
+
+	unsigned char early; ///< set with LTC_DECODER_EARLY
+	unsigned char early_armed; ///< the previous frame completed, the next frame is aligned
+	unsigned char early_pending; ///< early_frame was reported as provisional
+	LTCFrameEarly early_frame;
+	LTCFrameEarly early_queue[LTC_EARLY_QUEUE];
+	ltc_atomic_t early_read_off; ///< like queue_read_off, 0 <= off < 2 * LTC_EARLY_QUEUE
+	ltc_atomic_t early_write_off;
+
+	unsigned char detect; ///< set with LTC_DECODER_AUTODETECT
+	int detect_edges; ///< intervals in detect_hist, LTC_DETECT_EDGES once the bit period is estimated
+	unsigned short detect_hist[LTC_DETECT_BINS]; ///< histogram of transition intervals
+	int detect_prev; ///< frame-number (0..29) of the previous frame, -1 if none
+	int detect_fps; ///< nominal framerate counted from the timecode, 0 if not known
+	int detect_df; ///< drop-frame bit of the last frame
+	double detect_len; ///< sum of durations of consecutive frames
+	int detect_len_cnt;
+
+	unsigned char matched; ///< set with LTC_DECODER_MATCHED
+	float match_hist[LTC_MATCH_MAX]; ///< the last LTC_MATCH_MAX input samples
+
+	LTCAllocator mem; ///< allocator of the decoder block, zero for the standard library
+	unsigned char mem_external; ///< the decoder is in caller-provided memory
+
+	LTCDecoderStats stats; ///< counters, stats.overruns is not used
+	unsigned int stats_overruns; ///< value of queue_overruns at the last stats reset
 };
 
+struct LTCDecoderBank {
+	int channels;
+	LTCDecoder *decoders; ///< per channel bit-parser and frame queue, contiguous
+	LTCFrameExt *queues; ///< storage of all channel queues
+
+	/* per channel level-detector state (structure of arrays),
+	 * they are copied to/from decoders[c] when a state change is detected
+	 */
+	ltcsnd_sample_t *snd_min;
+	ltcsnd_sample_t *snd_max;
+	float *env_min;
+	float *env_max;
+	unsigned char *state;
+	int *cnt;
+
+	struct LTCPool *pool; ///< optional worker threads, see ltc_decoder_bank_set_threads
+};
+
+/** little-endian sample formats of \ref decode_ltc_pcm */
+enum LTCPcmFormat {
+	LTC_PCM_U8,
+	LTC_PCM_S16,
+	LTC_PCM_S24,
+	LTC_PCM_S32,
+	LTC_PCM_FLOAT,
+	LTC_PCM_DOUBLE
+};
+
+void decoder_init(LTCDecoder *d, int apv, LTCFrameExt *queue, int queue_len);
+void decoder_detect_restart(LTCDecoder *d);
+void decoder_reconfigure(LTCDecoder *d, int apv);
 
 void decode_ltc(LTCDecoder *d, ltcsnd_sample_t *sound, size_t size, ltc_off_t posinfo);
+void decode_ltc_float(LTCDecoder *d, float *sound, size_t stride, size_t size, ltc_off_t posinfo);
+void decode_ltc_double(LTCDecoder *d, double *sound, size_t stride, size_t size, ltc_off_t posinfo);
+void decode_ltc_s16(LTCDecoder *d, short *sound, size_t stride, size_t size, ltc_off_t posinfo);
+void decode_ltc_u16(LTCDecoder *d, unsigned short *sound, size_t stride, size_t size, ltc_off_t posinfo);
+
+void decode_ltc_pcm(LTCDecoder *d, const unsigned char *sound, enum LTCPcmFormat fmt, size_t stride, size_t size, ltc_off_t posinfo);
+void decode_ltc_bank(LTCDecoderBank *b, ltcsnd_sample_t *buf, int c0, int c1, size_t size, ltc_off_t posinfo);
+void decode_ltc_bank_float(LTCDecoderBank *b, float *buf, int c0, int c1, size_t size, ltc_off_t posinfo);
+void decode_ltc_bank_s16(LTCDecoderBank *b, short *buf, int c0, int c1, size_t size, ltc_off_t posinfo);
+void decode_ltc_bank_planar(LTCDecoderBank *b, ltcsnd_sample_t **bufs, int c0, int c1, size_t size, ltc_off_t posinfo);
+void decode_ltc_bank_planar_float(LTCDecoderBank *b, float **bufs, int c0, int c1, size_t size, ltc_off_t posinfo);
+void decode_ltc_bank_planar_s16(LTCDecoderBank *b, short **bufs, int c0, int c1, size_t size, ltc_off_t posinfo);
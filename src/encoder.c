@@ -26,21 +26,106 @@
 #include "encoder.h"
 
 /**
- * add values to the output buffer
+ * compute the low-pass filtered edge, starting at SAMPLE_CENTER.
+ * returns the number of samples until the value settles.
  */
-static int addvalues(LTCEncoder *e, int n) {
-	const ltcsnd_sample_t tgtval = e->state ? e->enc_hi : e->enc_lo;
+static int compute_ramp(ltcsnd_sample_t *ramp, ltcsnd_sample_t tgtval, double tcf) {
+	int i;
+	ltcsnd_sample_t val = SAMPLE_CENTER;
+	for (i = 0; i < LTC_RAMP_MAX; i++) {
+		const ltcsnd_sample_t prev = val;
+		val = val + tcf * (tgtval - val);
+		ramp[i] = val;
+		/* the recurrence only depends on val, once it is stable it remains so */
+		if (i > 0 && val == prev) {
+			break;
+		}
+	}
+	return i < LTC_RAMP_MAX ? i + 1 : LTC_RAMP_MAX;
+}
 
-	if (e->offset + n >= e->bufsize) {
-#if 0
-		fprintf(stderr, "libltc: buffer overflow: %d/%lu\n", (int) e->offset, (unsigned long) e->bufsize);
-#endif
-		return 1;
+/**
+ * compute the low-pass filtered edge for native formats, starting at 0.
+ * returns the number of samples until the value settles,
+ * or LTC_RAMP_NATIVE_MAX if it does not settle in time.
+ */
+static int compute_ramp_native(float *ramp, float tgtval, double tcf) {
+	int i;
+	double val = 0;
+	for (i = 0; i < LTC_RAMP_NATIVE_MAX; i++) {
+		val = val + tcf * (tgtval - val);
+		ramp[i] = val;
+		if (i > 0 && ramp[i] == ramp[i - 1]) {
+			return i + 1;
+		}
+	}
+	return LTC_RAMP_NATIVE_MAX;
+}
+
+void encoder_update_ramps(LTCEncoder *e) {
+	if (e->filter_const > 0) {
+		e->ramp_hi_len = compute_ramp(e->ramp_hi, e->enc_hi, e->filter_const);
+		e->ramp_lo_len = compute_ramp(e->ramp_lo, e->enc_lo, e->filter_const);
+		e->ramp_native_len = compute_ramp_native(e->ramp_native, e->enc_level, e->filter_const);
+	} else {
+		e->ramp_hi_len = 0;
+		e->ramp_lo_len = 0;
+		e->ramp_native_len = 0;
+	}
+}
+
+/** value of the native format edge at sample i */
+static inline float ramp_native(LTCEncoder *e, int i) {
+	if (i < e->ramp_native_len) {
+		return e->ramp_native[i];
+	}
+	if (e->ramp_native_len < LTC_RAMP_NATIVE_MAX) {
+		return e->ramp_native[e->ramp_native_len - 1];
 	}
+	return e->enc_level * (1.0 - pow(1.0 - e->filter_const, i + 1));
+}
+
+#define ADDVALUES_TEMPLATE(FN, FORMAT, STORE) \
+static void addvalues_ ## FN (LTCEncoder *e, FORMAT *wave, int n) { \
+	const float sign = e->state ? 1.f : -1.f; \
+	int i; \
+	if (e->filter_const > 0) { \
+		const int m = (n+1)>>1; \
+		for (i = 0 ; i < m ; i++) { \
+			const float val = sign * ramp_native(e, i); \
+			STORE(wave, i, val); \
+			STORE(wave, n-i-1, val); \
+		} \
+	} else { \
+		const float val = sign * e->enc_level; \
+		for (i = 0 ; i < n ; i++) { \
+			STORE(wave, i, val); \
+		} \
+	} \
+}
+
+#define ROUND(v) ((v) < 0 ? (v) - .5f : (v) + .5f)
+#define STORE_FLOAT(w, i, v) (w)[i] = (v)
+#define STORE_S16(w, i, v) (w)[i] = (short) ROUND((v) * 32767.f)
+#define STORE_S24(w, i, v) { \
+	const int s24 = (int) ROUND((v) * 8388607.f); \
+	(w)[3 * (i)] = s24 & 0xff; \
+	(w)[3 * (i) + 1] = (s24 >> 8) & 0xff; \
+	(w)[3 * (i) + 2] = (s24 >> 16) & 0xff; \
+}
+
+ADDVALUES_TEMPLATE(float, float, STORE_FLOAT)
+ADDVALUES_TEMPLATE(s16, short, STORE_S16)
+ADDVALUES_TEMPLATE(s24, unsigned char, STORE_S24)
+
+#undef ADDVALUES_TEMPLATE
+#undef ROUND
+#undef STORE_FLOAT
+#undef STORE_S16
+#undef STORE_S24
 
-	ltcsnd_sample_t * const wave = &(e->buf[e->offset]);
-	const double tcf =  e->filter_const;
-	if (tcf > 0) {
+static void addvalues_u8(LTCEncoder *e, ltcsnd_sample_t *wave, int n) {
+	if (e->filter_const > 0) {
 		/* low-pass-filter
 		 * LTC signal should have a rise time of 40 us +/- 10 us.
 		 *
@@ -49,23 +134,82 @@ static int addvalues(LTCEncoder *e, int n) {
 		 * here we need half-of it. (0.000020 sec)
 		 *
 		 * e->cutoff = 1.0 -exp( -1.0 / (sample_rate * .000020 / exp(1.0)) );
+		 *
+		 * The step response is precomputed by encoder_update_ramps(),
+		 * the 2nd half of the edge mirrors the first.
 		 */
 		int i;
-		ltcsnd_sample_t val = SAMPLE_CENTER;
-		int m = (n+1)>>1;
-		for (i = 0 ; i < m ; i++) {
-			val = val + tcf * (tgtval - val);
-			wave[n-i-1] = wave[i] = val;
+		const ltcsnd_sample_t * const ramp = e->state ? e->ramp_hi : e->ramp_lo;
+		const int len = e->state ? e->ramp_hi_len : e->ramp_lo_len;
+		const int m = (n+1)>>1;
+		if (m <= len) {
+			memcpy(wave, ramp, m);
+		} else {
+			memcpy(wave, ramp, len);
+			memset(&wave[len], ramp[len - 1], m - len);
+		}
+		for (i = m ; i < n ; i++) {
+			wave[i] = wave[n-i-1];
 		}
 	} else {
 		/* perfect square wave */
-		memset(wave, tgtval, n);
+		memset(wave, e->state ? e->enc_hi : e->enc_lo, n);
+	}
+}
+
+/**
+ * add values to the output buffer
+ */
+static int addvalues(LTCEncoder *e, int n) {
+	if (e->offset + n >= e->bufsize) {
+#if 0
+		fprintf(stderr, "libltc: buffer overflow: %d/%lu\n", (int) e->offset, (unsigned long) e->bufsize);
+#endif
+		return 1;
+	}
+
+	switch (e->out_fmt) {
+		case LTC_ENC_FLOAT:
+			addvalues_float(e, &((float*)e->out)[e->offset], n);
+			break;
+		case LTC_ENC_S16:
+			addvalues_s16(e, &((short*)e->out)[e->offset], n);
+			break;
+		case LTC_ENC_S24:
+			addvalues_s24(e, &((unsigned char*)e->out)[3 * e->offset], n);
+			break;
+		default:
+			addvalues_u8(e, &e->buf[e->offset], n);
+			break;
 	}
 
 	e->offset += n;
 	return 0;
 }
 
+/** encode a single bit, spc and sph are the samples per (half) clock */
+static int encode_bit(LTCEncoder *e, int bit, double spc, double sph) {
+	int err = 0;
+	int n;
+	if (bit == 0) {
+		n = (int)(spc + e->sample_remainder);
+		e->sample_remainder = spc + e->sample_remainder - n;
+		e->state = !e->state;
+		err |= addvalues(e, n);
+	} else {
+		n = (int)(sph + e->sample_remainder);
+		e->sample_remainder = sph + e->sample_remainder - n;
+		e->state = !e->state;
+		err |= addvalues(e, n);
+
+		n = (int)(sph + e->sample_remainder);
+		e->sample_remainder = sph + e->sample_remainder - n;
+		e->state = !e->state;
+		err |= addvalues(e, n);
+	}
+	return err;
+}
+
 int encode_byte(LTCEncoder *e, int byte, double speed) {
 	if (byte < 0 || byte > 9) return -1;
 	if (speed ==0) return -1;
@@ -78,23 +222,7 @@ int encode_byte(LTCEncoder *e, int byte, double speed) {
 
 	do
 	{
-		int n;
-		if ((c & b) == 0) {
-			n = (int)(spc + e->sample_remainder);
-			e->sample_remainder = spc + e->sample_remainder - n;
-			e->state = !e->state;
-			err |= addvalues(e, n);
-		} else {
-			n = (int)(sph + e->sample_remainder);
-			e->sample_remainder = sph + e->sample_remainder - n;
-			e->state = !e->state;
-			err |= addvalues(e, n);
-
-			n = (int)(sph + e->sample_remainder);
-			e->sample_remainder = sph + e->sample_remainder - n;
-			e->state = !e->state;
-			err |= addvalues(e, n);
-		}
+		err |= encode_bit(e, (c & b) != 0, spc, sph);
 		/* this is based on the assumption that with every compiler
 		 * ((unsigned char) 128)<<1 == ((unsigned char 1)>>1) == 0
 		 */
@@ -107,6 +235,41 @@ int encode_byte(LTCEncoder *e, int byte, double speed) {
 	return err;
 }
 
+/* playback speed of the k-th bit (in encoding order), interpolated
+ * linearly at the center of the bit */
+static double bit_speed(double speed_start, double speed_end, int k) {
+	return fabs(speed_start + (speed_end - speed_start) * (k + .5) / LTC_FRAME_BIT_COUNT);
+}
+
+int encode_frame_varispeed(LTCEncoder *e, double speed_start, double speed_end) {
+	const unsigned char *c = (unsigned char*)&e->f;
+	const int reverse = speed_start < 0;
+	double len = e->sample_remainder;
+	int err = 0;
+	int k;
+
+	if (speed_start == 0 || speed_end == 0 || (speed_end < 0) != reverse) {
+		return -1;
+	}
+
+	/* check the space beforehand, rather than encoding a partial frame */
+	for (k = 0; k < LTC_FRAME_BIT_COUNT; ++k) {
+		len += e->samples_per_clock / bit_speed(speed_start, speed_end, k);
+	}
+	if (e->offset + (size_t) len >= e->bufsize) {
+		return -1;
+	}
+
+	for (k = 0; k < LTC_FRAME_BIT_COUNT; ++k) {
+		const int bit = reverse ? LTC_FRAME_BIT_COUNT - 1 - k : k;
+		const double speed = bit_speed(speed_start, speed_end, k);
+		err |= encode_bit(e, (c[bit >> 3] >> (bit & 7)) & 1,
+				e->samples_per_clock / speed,
+				e->samples_per_clock_2 / speed);
+	}
+	return err ? -1 : 0;
+}
+
 int encode_transition(LTCEncoder *e) {
 	if (e->offset + 1 >= e->bufsize) {
 		return -1;
@@ -124,3 +287,151 @@ int encode_transition(LTCEncoder *e) {
 
 	return err;
 }
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Streaming
+ *
+ * The signal is rendered edge by edge. An edge can be split at any
+ * sample: every sample of it is a function of its index in the edge
+ * (the 2nd half mirrors the first, see addvalues()), so rendering
+ * can be resumed at arbitrary sample positions.
+ */
+
+void encode_stream_reset(LTCEncoder *e, size_t preroll) {
+	e->stream_bit = LTC_FRAME_BIT_COUNT;
+	e->stream_half = 0;
+	e->stream_edge_len = 0;
+	e->stream_edge_pos = 0;
+	e->stream_preroll = preroll;
+}
+
+/** advance to the next edge, start a new frame if needed */
+static void stream_next_edge(LTCEncoder *e) {
+	const double spc = e->samples_per_clock;
+	const double sph = e->samples_per_clock_2;
+	int n;
+
+	if (e->stream_half) {
+		e->stream_half = 0;
+		n = (int)(sph + e->sample_remainder);
+		e->sample_remainder = sph + e->sample_remainder - n;
+	} else {
+		int bit;
+		if (e->stream_bit >= LTC_FRAME_BIT_COUNT) {
+			memcpy(&e->stream_f, &e->f, sizeof(LTCFrame));
+			ltc_frame_increment(&e->f, (int) floor(e->fps + .5), e->standard, e->flags);
+			e->stream_bit = 0;
+		}
+		bit = (((unsigned char*)&e->stream_f)[e->stream_bit >> 3] >> (e->stream_bit & 7)) & 1;
+		++e->stream_bit;
+		if (bit == 0) {
+			n = (int)(spc + e->sample_remainder);
+			e->sample_remainder = spc + e->sample_remainder - n;
+		} else {
+			e->stream_half = 1;
+			n = (int)(sph + e->sample_remainder);
+			e->sample_remainder = sph + e->sample_remainder - n;
+		}
+	}
+	e->state = !e->state;
+	e->stream_edge_len = n;
+	e->stream_edge_pos = 0;
+}
+
+static inline ltcsnd_sample_t edge_u8(LTCEncoder *e, int k) {
+	const ltcsnd_sample_t * const ramp = e->state ? e->ramp_hi : e->ramp_lo;
+	const int len = e->state ? e->ramp_hi_len : e->ramp_lo_len;
+	return k < len ? ramp[k] : ramp[len - 1];
+}
+
+/* render samples [from, to) of the current edge, every stride'th sample */
+#define SEGMENT_TEMPLATE(FN, FORMAT, SILENCE, VALUE, STORE) \
+static void segment_ ## FN (LTCEncoder *e, FORMAT *wave, size_t stride, int from, int to) { \
+	const int n = e->stream_edge_len; \
+	const int m = (n+1)>>1; \
+	int i; \
+	for (i = from; i < to; i++) { \
+		const int k = i < m ? i : n - i - 1; \
+		STORE(wave, (i - from) * stride, VALUE(e, k)); \
+	} \
+} \
+static void silence_ ## FN (FORMAT *wave, size_t stride, size_t n) { \
+	size_t i; \
+	for (i = 0; i < n; i++) { \
+		STORE(wave, i * stride, SILENCE); \
+	} \
+}
+
+#define ROUND(v) ((v) < 0 ? (v) - .5f : (v) + .5f)
+#define VALUE_U8(e, k) ((e)->filter_const > 0 ? edge_u8(e, k) : ((e)->state ? (e)->enc_hi : (e)->enc_lo))
+#define VALUE_NATIVE(e, k) (((e)->state ? 1.f : -1.f) * ((e)->filter_const > 0 ? ramp_native(e, k) : (e)->enc_level))
+#define STORE_U8(w, i, v) (w)[i] = (v)
+#define STORE_FLOAT(w, i, v) (w)[i] = (v)
+#define STORE_S16(w, i, v) { const float f16 = (v); (w)[i] = (short) ROUND(f16 * 32767.f); }
+#define STORE_S24(w, i, v) { \
+	const float f24 = (v); \
+	const int s24 = (int) ROUND(f24 * 8388607.f); \
+	(w)[3 * (i)] = s24 & 0xff; \
+	(w)[3 * (i) + 1] = (s24 >> 8) & 0xff; \
+	(w)[3 * (i) + 2] = (s24 >> 16) & 0xff; \
+}
+
+SEGMENT_TEMPLATE(u8, ltcsnd_sample_t, SAMPLE_CENTER, VALUE_U8, STORE_U8)
+SEGMENT_TEMPLATE(float, float, 0.f, VALUE_NATIVE, STORE_FLOAT)
+SEGMENT_TEMPLATE(s16, short, 0.f, VALUE_NATIVE, STORE_S16)
+SEGMENT_TEMPLATE(s24, unsigned char, 0.f, VALUE_NATIVE, STORE_S24)
+
+#undef SEGMENT_TEMPLATE
+#undef ROUND
+#undef VALUE_U8
+#undef VALUE_NATIVE
+#undef STORE_U8
+#undef STORE_FLOAT
+#undef STORE_S16
+#undef STORE_S24
+
+void encode_stream(LTCEncoder *e, void *out, enum LTCEncoderFormat fmt, size_t stride, size_t n) {
+	size_t off = 0;
+	while (off < n) {
+		const size_t pos = off * stride;
+		size_t k;
+		if (e->stream_preroll > 0) {
+			k = n - off < e->stream_preroll ? n - off : e->stream_preroll;
+			switch (fmt) {
+				case LTC_ENC_FLOAT: silence_float(&((float*)out)[pos], stride, k); break;
+				case LTC_ENC_S16:   silence_s16(&((short*)out)[pos], stride, k); break;
+				case LTC_ENC_S24:   silence_s24(&((unsigned char*)out)[3 * pos], stride, k); break;
+				default:            silence_u8(&((ltcsnd_sample_t*)out)[pos], stride, k); break;
+			}
+			e->stream_preroll -= k;
+			off += k;
+			continue;
+		}
+
+		if (e->stream_edge_pos >= e->stream_edge_len) {
+			stream_next_edge(e);
+			continue;
+		}
+
+		k = e->stream_edge_len - e->stream_edge_pos;
+		if (k > n - off) {
+			k = n - off;
+		}
+		switch (fmt) {
+			case LTC_ENC_FLOAT:
+				segment_float(e, &((float*)out)[pos], stride, e->stream_edge_pos, e->stream_edge_pos + k);
+				break;
+			case LTC_ENC_S16:
+				segment_s16(e, &((short*)out)[pos], stride, e->stream_edge_pos, e->stream_edge_pos + k);
+				break;
+			case LTC_ENC_S24:
+				segment_s24(e, &((unsigned char*)out)[3 * pos], stride, e->stream_edge_pos, e->stream_edge_pos + k);
+				break;
+			default:
+				segment_u8(e, &((ltcsnd_sample_t*)out)[pos], stride, e->stream_edge_pos, e->stream_edge_pos + k);
+				break;
+		}
+		e->stream_edge_pos += k;
+		off += k;
+	}
+}
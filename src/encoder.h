@@ -23,6 +23,19 @@
 #define SAMPLE_CENTER 128 // unsigned 8 bit.
 #endif
 
+/** upper bound of the length of a low-pass filtered edge (8 bit) */
+#define LTC_RAMP_MAX 256
+/** length of the precomputed native format edge, longer edges are computed */
+#define LTC_RAMP_NATIVE_MAX 1024
+
+/** sample format of the encoder output */
+enum LTCEncoderFormat {
+	LTC_ENC_U8 = 0, ///< ltcsnd_sample_t, written to buf
+	LTC_ENC_FLOAT, ///< float -1..+1, written to out
+	LTC_ENC_S16, ///< signed 16 bit, written to out
+	LTC_ENC_S24 ///< packed signed 24 bit little-endian, written to out
+};
+
 struct LTCEncoder {
 	double fps;
 	double sample_rate;
@@ -30,10 +43,19 @@ struct LTCEncoder {
 	int flags;
 	enum LTC_TV_STANDARD standard;
 	ltcsnd_sample_t enc_lo, enc_hi;
+	float enc_level; ///< peak level for native output formats, linear gain
 
 	size_t offset;
 	size_t bufsize;
 	ltcsnd_sample_t *buf;
+	size_t buf_alloc; ///< allocated size of buf, >= bufsize
+	unsigned char buf_inline; ///< buf is part of the encoder block
+
+	LTCAllocator mem; ///< allocator of the encoder block, zero for the standard library
+	unsigned char mem_external; ///< the encoder is in caller-provided memory
+
+	enum LTCEncoderFormat out_fmt;
+	void *out; ///< output buffer for native formats, the offset is in samples
 
 	char state;
 
@@ -42,7 +64,36 @@ struct LTCEncoder {
 	double sample_remainder;
 
 	LTCFrame f;
+
+	/* precomputed low-pass filter step response, from SAMPLE_CENTER towards
+	 * enc_hi or enc_lo. After ramp_*_len samples the signal no longer changes.
+	 */
+	ltcsnd_sample_t ramp_hi[LTC_RAMP_MAX];
+	ltcsnd_sample_t ramp_lo[LTC_RAMP_MAX];
+	int ramp_hi_len;
+	int ramp_lo_len;
+
+	/* step response for native formats from 0 to enc_level */
+	float ramp_native[LTC_RAMP_NATIVE_MAX];
+	int ramp_native_len;
+
+	/* streaming state, see ltc_encoder_render */
+	LTCFrame stream_f; ///< frame that is currently rendered
+	int stream_bit; ///< next bit of stream_f, LTC_FRAME_BIT_COUNT: start a new frame
+	int stream_half; ///< 2nd half of a '1' bit is pending
+	int stream_edge_len; ///< length of the current edge, in samples
+	int stream_edge_pos; ///< samples of the current edge that were rendered
+	size_t stream_preroll; ///< remaining samples of silence before the first frame
 };
 
 int encode_byte(LTCEncoder *e, int byte, double speed);
+int encode_frame_varispeed(LTCEncoder *e, double speed_start, double speed_end);
 int encode_transition(LTCEncoder *e);
+void encoder_update_ramps(LTCEncoder *e);
+void encode_stream_reset(LTCEncoder *e, size_t preroll);
+void encode_stream(LTCEncoder *e, void *out, enum LTCEncoderFormat fmt, size_t stride, size_t n);
+
+struct LTCEncoderBank {
+	int channels;
+	LTCEncoder **encoders;
+};
@@ -0,0 +1,455 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h> /* before system headers, for large file support */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined HAVE_SYS_MMAN_H && defined HAVE_UNISTD_H && !defined _WIN32
+# include <sys/mman.h>
+# include <unistd.h>
+# define LTC_FILE_MMAP
+#endif
+
+#include "file.h"
+
+#if defined _MSC_VER
+# define file_seek _fseeki64
+# define file_tell _ftelli64
+#elif defined _WIN32
+# define file_seek fseeko64
+# define file_tell ftello64
+#else
+# define file_seek fseeko
+# define file_tell ftello
+#endif
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * File window
+ *
+ * The audio-data is accessed through a window of LTC_FILE_WINDOW bytes
+ * that moves sequentially through the file. It is memory-mapped where
+ * possible, otherwise it is read into a buffer.
+ */
+
+static void window_release(LTCFileDecoder *f) {
+#ifdef LTC_FILE_MMAP
+	if (f->use_mmap && f->win) {
+		munmap(f->win, f->win_len);
+	}
+#endif
+	if (!f->use_mmap) {
+		free(f->win);
+	}
+	f->win = NULL;
+	f->win_len = 0;
+	f->buf_size = 0;
+}
+
+#ifdef LTC_FILE_MMAP
+static int window_map(LTCFileDecoder *f, ltc_off_t off, size_t len) {
+	const ltc_off_t page = sysconf(_SC_PAGESIZE);
+	const ltc_off_t start = off - (off % page);
+	size_t map_len = LTC_FILE_WINDOW;
+	void *win;
+
+	if ((ltc_off_t)map_len < off + (ltc_off_t)len - start) {
+		map_len = off + len - start;
+	}
+	if (start + (ltc_off_t)map_len > f->file_size) {
+		map_len = f->file_size - start;
+	}
+
+	if (f->win) {
+		munmap(f->win, f->win_len);
+		f->win = NULL;
+		f->win_len = 0;
+	}
+
+	win = mmap(NULL, map_len, PROT_READ, MAP_SHARED, fileno(f->fp), start);
+	if (win == MAP_FAILED) {
+		return -1;
+	}
+#ifdef POSIX_MADV_SEQUENTIAL
+	posix_madvise(win, map_len, POSIX_MADV_SEQUENTIAL);
+#endif
+	f->win = (unsigned char*) win;
+	f->win_off = start;
+	f->win_len = map_len;
+	return 0;
+}
+#endif
+
+static int window_read(LTCFileDecoder *f, ltc_off_t off, size_t len) {
+	size_t n = LTC_FILE_WINDOW;
+	if (n < len || off != f->win_off + (ltc_off_t)f->win_len) {
+		/* read ahead only when reading sequentially */
+		n = len;
+	}
+	if (off + (ltc_off_t)n > f->file_size) {
+		n = f->file_size - off;
+	}
+
+	if (n > f->buf_size) {
+		unsigned char *buf = (unsigned char*) realloc(f->win, n);
+		if (!buf) {
+			return -1;
+		}
+		f->win = buf;
+		f->buf_size = n;
+	}
+
+	f->win_len = 0;
+	if (file_seek(f->fp, off, SEEK_SET) || fread(f->win, 1, n, f->fp) < len) {
+		return -1;
+	}
+	f->win_off = off;
+	f->win_len = n;
+	return 0;
+}
+
+/** return a pointer to the bytes [off, off + len) of the file */
+static const unsigned char* window_get(LTCFileDecoder *f, ltc_off_t off, size_t len) {
+	if (f->win && off >= f->win_off && off + (ltc_off_t)len <= f->win_off + (ltc_off_t)f->win_len) {
+		return &f->win[off - f->win_off];
+	}
+
+#ifdef LTC_FILE_MMAP
+	if (f->use_mmap) {
+		if (window_map(f, off, len) == 0) {
+			return &f->win[off - f->win_off];
+		}
+		/* fall back to reading */
+		f->use_mmap = 0;
+	}
+#endif
+
+	if (window_read(f, off, len)) {
+		return NULL;
+	}
+	return &f->win[off - f->win_off];
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * RIFF/WAVE, RF64 and BW64 header
+ */
+
+static uint32_t rd_u16le(const unsigned char *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static uint32_t rd_u32le(const unsigned char *p) {
+	return rd_u16le(p) | (rd_u16le(p + 2) << 16);
+}
+
+static ltc_off_t rd_u64le(const unsigned char *p) {
+	return (ltc_off_t)rd_u32le(p) | ((ltc_off_t)rd_u32le(p + 4) << 32);
+}
+
+/** set the sample format from a WAVE fmt chunk */
+static int parse_fmt(LTCFileDecoder *f, const unsigned char *fmt, uint32_t size) {
+	uint32_t tag;
+	if (size < 16) {
+		return -1;
+	}
+	tag = rd_u16le(fmt);
+	f->channels = rd_u16le(fmt + 2);
+	f->sample_rate = rd_u32le(fmt + 4);
+	f->block_align = rd_u16le(fmt + 12);
+
+	if (tag == 0xFFFE && size >= 40) {
+		/* WAVE_FORMAT_EXTENSIBLE, the SubFormat GUID starts with the format tag */
+		tag = rd_u16le(fmt + 24);
+	}
+
+	if (f->channels < 1 || f->block_align < f->channels || f->block_align % f->channels) {
+		return -1;
+	}
+	f->sample_size = f->block_align / f->channels;
+
+	/* samples may be stored in a larger container, e.g. 24 bit in 32,
+	 * in which case the valid bits are the most significant ones.
+	 */
+	if (tag == 1) {
+		switch (f->sample_size) {
+			case 1: f->fmt = LTC_PCM_U8; return 0;
+			case 2: f->fmt = LTC_PCM_S16; return 0;
+			case 3: f->fmt = LTC_PCM_S24; return 0;
+			case 4: f->fmt = LTC_PCM_S32; return 0;
+			default: break;
+		}
+	} else if (tag == 3) {
+		switch (f->sample_size) {
+			case 4: f->fmt = LTC_PCM_FLOAT; return 0;
+			case 8: f->fmt = LTC_PCM_DOUBLE; return 0;
+			default: break;
+		}
+	}
+	return -1;
+}
+
+/** @return 0 on success, 1 if the file is not a WAVE file, -1 on error */
+static int parse_wave(LTCFileDecoder *f) {
+	unsigned char hdr[40];
+	ltc_off_t off = 12;
+	ltc_off_t data_size64 = -1;
+	int have_fmt = 0;
+	int rf64;
+
+	if (file_seek(f->fp, 0, SEEK_SET) || fread(hdr, 1, 12, f->fp) != 12) {
+		return 1;
+	}
+	if (memcmp(hdr + 8, "WAVE", 4)) {
+		return 1;
+	}
+	if (!memcmp(hdr, "RIFF", 4)) {
+		rf64 = 0;
+	} else if (!memcmp(hdr, "RF64", 4) || !memcmp(hdr, "BW64", 4)) {
+		rf64 = 1;
+	} else {
+		return 1;
+	}
+
+	while (off + 8 <= f->file_size) {
+		ltc_off_t size;
+		if (file_seek(f->fp, off, SEEK_SET) || fread(hdr, 1, 8, f->fp) != 8) {
+			return -1;
+		}
+		size = rd_u32le(hdr + 4);
+
+		if (!memcmp(hdr, "ds64", 4) && size >= 24) {
+			if (fread(hdr, 1, 24, f->fp) != 24) {
+				return -1;
+			}
+			data_size64 = rd_u64le(hdr + 8);
+		} else if (!memcmp(hdr, "fmt ", 4)) {
+			const uint32_t n = size < (ltc_off_t)sizeof(hdr) ? (uint32_t)size : (uint32_t)sizeof(hdr);
+			if (fread(hdr, 1, n, f->fp) != n || parse_fmt(f, hdr, n)) {
+				return -1;
+			}
+			have_fmt = 1;
+		} else if (!memcmp(hdr, "data", 4)) {
+			if (!have_fmt) {
+				return -1;
+			}
+			if (rf64 && size == 0xFFFFFFFF && data_size64 >= 0) {
+				size = data_size64;
+			}
+			f->data_off = off + 8;
+			/* truncated files, or headers that were not finalized */
+			if (size == 0 || f->data_off + size > f->file_size) {
+				size = f->file_size - f->data_off;
+			}
+			f->length = size / f->block_align;
+			return 0;
+		}
+		/* chunks are word aligned */
+		off += 8 + size + (size & 1);
+	}
+	return -1;
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * File decoder
+ */
+
+LTCFileDecoder* ltc_file_decoder_open(const char *path, int channel, int apv, int flags) {
+	int rv;
+	LTCFileDecoder *f = (LTCFileDecoder*) calloc(1, sizeof(LTCFileDecoder));
+	if (!f) return NULL;
+
+	f->fp = fopen(path, "rb");
+	if (!f->fp || file_seek(f->fp, 0, SEEK_END) || (f->file_size = file_tell(f->fp)) < 0) {
+		goto fail;
+	}
+
+	rv = (flags & LTC_FILE_RAW) ? 1 : parse_wave(f);
+	if (rv < 0) {
+		goto fail;
+	}
+	if (rv > 0) {
+		/* headerless, unsigned 8 bit mono */
+		f->data_off = 0;
+		f->length = f->file_size;
+		f->sample_rate = 0;
+		f->channels = 1;
+		f->block_align = 1;
+		f->sample_size = 1;
+		f->fmt = LTC_PCM_U8;
+	}
+
+	if (channel < 0 || channel >= f->channels) {
+		goto fail;
+	}
+
+	if (apv <= 0) {
+		apv = f->sample_rate > 0 ? f->sample_rate / 25 : 1920;
+	}
+
+	f->channel = channel;
+	f->apv = apv;
+	/* decode in chunks of 16 video frames, the queue never overflows */
+	f->block = 16 * (size_t)apv;
+	f->use_mmap = (flags & LTC_FILE_NO_MMAP) ? 0 : 1;
+
+	f->decoder = ltc_decoder_create(apv, LTC_FILE_QUEUE);
+	if (!f->decoder) {
+		goto fail;
+	}
+	return f;
+
+fail:
+	if (f->fp) fclose(f->fp);
+	free(f);
+	return NULL;
+}
+
+int ltc_file_decoder_close(LTCFileDecoder *f) {
+	if (!f) return 1;
+	window_release(f);
+	ltc_decoder_free(f->decoder);
+	fclose(f->fp);
+	free(f);
+	return 0;
+}
+
+/** decode the next block up to end, @return 1 if data was decoded, 0 at the end, -1 on error */
+static int file_decode_block(LTCFileDecoder *f, ltc_off_t end) {
+	const unsigned char *p;
+	size_t n;
+
+	if (end > f->length) {
+		end = f->length;
+	}
+	if (f->pos >= end) {
+		return 0;
+	}
+
+	n = f->block;
+	if ((ltc_off_t)n > end - f->pos) {
+		n = end - f->pos;
+	}
+
+	p = window_get(f, f->data_off + f->pos * f->block_align, n * f->block_align);
+	if (!p) {
+		return -1;
+	}
+	p += f->channel * f->sample_size;
+
+	if (f->fmt == LTC_PCM_U8 && f->channels == 1) {
+		decode_ltc(f->decoder, (ltcsnd_sample_t*) p, n, f->pos);
+	} else {
+		decode_ltc_pcm(f->decoder, p, f->fmt, f->block_align, n, f->pos);
+	}
+	f->pos += n;
+	return 1;
+}
+
+int file_decoder_read_until(LTCFileDecoder *f, LTCFrameExt *frame, ltc_off_t end) {
+	while (!ltc_decoder_read(f->decoder, frame)) {
+		const int rv = file_decode_block(f, end);
+		if (rv <= 0) {
+			return rv;
+		}
+	}
+	return 1;
+}
+
+int ltc_file_decoder_read(LTCFileDecoder *f, LTCFrameExt *frame) {
+	return file_decoder_read_until(f, frame, f->length);
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Probing
+ */
+
+ltc_off_t file_probe_length(LTCFileDecoder *f) {
+	return (ltc_off_t)(LTC_FILE_PROBE_FRAMES + 1) * f->apv;
+}
+
+ltc_off_t file_probe_stride(LTCFileDecoder *f, ltc_off_t stride) {
+	if (stride <= 0) {
+		stride = (ltc_off_t)LTC_FILE_PROBE_STRIDE * f->apv;
+	}
+	if (stride < file_probe_length(f)) {
+		stride = file_probe_length(f);
+	}
+	return stride;
+}
+
+int ltc_file_decoder_find(LTCFileDecoder *f, ltc_off_t stride, LTCFrameExt *frame) {
+	const ltc_off_t probe_len = file_probe_length(f);
+	ltc_off_t lo = f->pos;
+	ltc_off_t p;
+
+	stride = file_probe_stride(f, stride);
+
+	for (p = f->pos; p < f->length; p += stride) {
+		int rv;
+		if (ltc_file_decoder_seek(f, p)) {
+			return -1;
+		}
+		rv = file_decoder_read_until(f, frame, p + probe_len);
+		if (rv < 0) {
+			return -1;
+		}
+		if (rv > 0) {
+			/* LTC starts between the previous and this probe */
+			if (p == lo) {
+				return 1;
+			}
+			if (ltc_file_decoder_seek(f, lo)) {
+				return -1;
+			}
+			return file_decoder_read_until(f, frame, p + probe_len);
+		}
+		lo = p;
+	}
+	return 0;
+}
+
+int ltc_file_decoder_seek(LTCFileDecoder *f, ltc_off_t pos) {
+	if (pos < 0 || pos > f->length) {
+		return -1;
+	}
+	decoder_init(f->decoder, f->apv, f->decoder->queue, f->decoder->queue_len);
+	f->pos = pos;
+	return 0;
+}
+
+ltc_off_t ltc_file_decoder_position(LTCFileDecoder *f) {
+	return f->pos;
+}
+
+ltc_off_t ltc_file_decoder_length(LTCFileDecoder *f) {
+	return f->length;
+}
+
+int ltc_file_decoder_sample_rate(LTCFileDecoder *f) {
+	return f->sample_rate;
+}
+
+int ltc_file_decoder_channels(LTCFileDecoder *f) {
+	return f->channels;
+}
@@ -0,0 +1,76 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LTC_FILE_H
+#define LTC_FILE_H 1
+
+#include <stdio.h>
+#include "decoder.h"
+
+/** size of the file window (mmap or read buffer) */
+#define LTC_FILE_WINDOW (8 << 20)
+
+/** number of frames in the decoder queue */
+#define LTC_FILE_QUEUE 64
+
+/** number of frames to decode when probing for LTC */
+#define LTC_FILE_PROBE_FRAMES 4
+
+/** default distance of probes in video frames */
+#define LTC_FILE_PROBE_STRIDE 250
+
+struct LTCFileDecoder {
+	FILE *fp;
+	ltc_off_t file_size; ///< in bytes
+
+	/* current window of the file, [win_off, win_off + win_len) */
+	unsigned char *win;
+	ltc_off_t win_off;
+	size_t win_len;
+	int use_mmap; ///< the window is mapped, otherwise win is a read buffer
+	size_t buf_size; ///< allocated size of the read buffer
+
+	/* audio data */
+	ltc_off_t data_off; ///< in bytes from start of file
+	ltc_off_t length; ///< in audio-frames (samples per channel)
+	int sample_rate; ///< 0 if unknown (raw files)
+	int channels;
+	int block_align; ///< bytes per audio-frame
+	int sample_size; ///< bytes per sample
+	enum LTCPcmFormat fmt;
+
+	int channel; ///< channel to decode
+	int apv;
+	size_t block; ///< audio-frames per decoder write
+	ltc_off_t pos; ///< next audio-frame to decode
+
+	LTCDecoder *decoder;
+};
+
+/** like ltc_file_decoder_read, but do not decode beyond the audio-frame end */
+int file_decoder_read_until(LTCFileDecoder *f, LTCFrameExt *frame, ltc_off_t end);
+
+/** number of audio-frames to decode for a probe */
+ltc_off_t file_probe_length(LTCFileDecoder *f);
+
+/** default distance of probes for stride <= 0, at least file_probe_length() */
+ltc_off_t file_probe_stride(LTCFileDecoder *f, ltc_off_t stride);
+
+#endif
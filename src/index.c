@@ -0,0 +1,569 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "index.h"
+#include "file.h"
+#include "timecode.h"
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Seek index
+ *
+ * Each checkpoint covers a run of up to `interval` consecutive frames
+ * (frame-numbers increasing, or decreasing for reverse playback).
+ * A new checkpoint is started at every discontinuity.
+ */
+
+/** frame-number of the first frame (in increasing order) covered by the entry */
+static ltc_off_t entry_first(LTCIndex *x, const LTCIndexEntry *e) {
+	const ltc_off_t index = ltc_frame_to_index((LTCFrame*)&e->ltc, x->fps);
+	if (e->reverse) {
+		const ltc_off_t day = frames_per_day(x->fps, e->ltc.dfbit);
+		return (index - (e->n_frames - 1) + day) % day;
+	}
+	return index;
+}
+
+LTCIndex* ltc_index_create(int fps, int interval) {
+	LTCIndex *x;
+	if (fps < 1 || interval < 1) {
+		return NULL;
+	}
+	x = (LTCIndex*) calloc(1, sizeof(LTCIndex));
+	if (!x) return NULL;
+	x->fps = fps;
+	x->interval = interval;
+	return x;
+}
+
+void ltc_index_free(LTCIndex *x) {
+	if (!x) return;
+	free(x->entries);
+	free(x->order);
+	free(x);
+}
+
+int ltc_index_size(LTCIndex *x) {
+	return x->n_entries;
+}
+
+int ltc_index_entry(LTCIndex *x, int i, LTCIndexEntry *entry) {
+	if (i < 0 || i >= x->n_entries) {
+		return -1;
+	}
+	memcpy(entry, &x->entries[i], sizeof(LTCIndexEntry));
+	return 0;
+}
+
+static LTCIndexEntry* index_append(LTCIndex *x) {
+	if (x->n_entries == x->alloc) {
+		const int alloc = x->alloc ? x->alloc * 2 : 256;
+		LTCIndexEntry *e = (LTCIndexEntry*) realloc(x->entries, alloc * sizeof(LTCIndexEntry));
+		if (!e) {
+			return NULL;
+		}
+		x->entries = e;
+		x->alloc = alloc;
+	}
+	x->sorted = 0;
+	return &x->entries[x->n_entries++];
+}
+
+int ltc_index_add(LTCIndex *x, LTCFrameExt *frame) {
+	const ltc_off_t index = ltc_frame_to_index(&frame->ltc, x->fps);
+	const ltc_off_t day = frames_per_day(x->fps, frame->ltc.dfbit);
+	const ltc_off_t len = frame->off_end - frame->off_start + 1;
+	/* the decoder reports reverse frames with a non-zero duration, not 1 */
+	const int reverse = frame->reverse != 0;
+	LTCIndexEntry *e;
+	int discontinuity = 1;
+
+	if (x->have_prev && x->prev_reverse == reverse) {
+		const ltc_off_t expect = (x->prev_index + (reverse ? day - 1 : 1)) % day;
+		/* the frame must follow without a gap (allow for a frame of jitter) */
+		discontinuity = index != expect
+			|| frame->off_start - x->prev_off_end > len
+			|| frame->off_start <= x->prev_off_end - len;
+	}
+
+	x->have_prev = 1;
+	x->prev_index = index;
+	x->prev_off_end = frame->off_end;
+	x->prev_reverse = reverse;
+
+	if (!discontinuity && x->n_entries > 0) {
+		e = &x->entries[x->n_entries - 1];
+		if (e->n_frames < x->interval) {
+			++e->n_frames;
+			x->sorted = 0;
+			return 0;
+		}
+	}
+
+	e = index_append(x);
+	if (!e) {
+		return -1;
+	}
+	memcpy(&e->ltc, &frame->ltc, sizeof(LTCFrame));
+	e->off_start = frame->off_start;
+	e->off_end = frame->off_end;
+	e->n_frames = 1;
+	e->reverse = reverse;
+	e->discontinuity = discontinuity;
+	return 1;
+}
+
+int ltc_index_build(LTCIndex *x, LTCFileDecoder *f) {
+	LTCFrameExt frame;
+	int rv;
+	if (ltc_file_decoder_seek(f, 0)) {
+		return -1;
+	}
+	while ((rv = ltc_file_decoder_read(f, &frame)) > 0) {
+		if (ltc_index_add(x, &frame) < 0) {
+			return -1;
+		}
+	}
+	return rv < 0 ? -1 : x->n_entries;
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Coarse-to-fine scan
+ *
+ * The file is probed at strided positions. If the timecode of a probe is
+ * the one extrapolated from the previous probe, the frames in between
+ * are added to the index without decoding them. Otherwise the region
+ * between the probes is decoded.
+ */
+
+/** decode a probe, @return 1 if two consecutive frames were found (the last is returned) */
+static int scan_probe(LTCIndex *x, LTCFileDecoder *f, ltc_off_t p, LTCFrameExt *anchor) {
+	const ltc_off_t end = p + file_probe_length(f);
+	LTCFrameExt frame, prev;
+	int have_prev = 0;
+	int rv;
+
+	if (ltc_file_decoder_seek(f, p)) {
+		return -1;
+	}
+	while ((rv = file_decoder_read_until(f, &frame, end)) > 0) {
+		if (have_prev && !!prev.reverse == !!frame.reverse) {
+			const ltc_off_t day = frames_per_day(x->fps, frame.ltc.dfbit);
+			const ltc_off_t expect = (ltc_frame_to_index(&prev.ltc, x->fps) + (frame.reverse ? day - 1 : 1)) % day;
+			if (ltc_frame_to_index(&frame.ltc, x->fps) == expect) {
+				memcpy(anchor, &frame, sizeof(LTCFrameExt));
+				return 1;
+			}
+		}
+		memcpy(&prev, &frame, sizeof(LTCFrameExt));
+		have_prev = 1;
+	}
+	return rv;
+}
+
+/** number of frames from a to b if b continues a, otherwise 0 */
+static ltc_off_t scan_continues(LTCIndex *x, const LTCFrameExt *a, const LTCFrameExt *b) {
+	const ltc_off_t len = a->off_end - a->off_start + 1;
+	const ltc_off_t day = frames_per_day(x->fps, a->ltc.dfbit);
+	ltc_off_t n, d;
+
+	/* reverse is a flag, its value depends on the decoder's bit period */
+	if (!!a->reverse != !!b->reverse || a->ltc.dfbit != b->ltc.dfbit || len <= 0) {
+		return 0;
+	}
+	n = (b->off_start - a->off_start + len / 2) / len;
+	if (n <= 0) {
+		return 0;
+	}
+	d = ltc_frame_to_index((LTCFrame*)&b->ltc, x->fps) - ltc_frame_to_index((LTCFrame*)&a->ltc, x->fps);
+	if (a->reverse) {
+		d = -d;
+	}
+	return ((d % day) + day) % day == n ? n : 0;
+}
+
+/** add the n frames after a, the last one is b */
+static int scan_extrapolate(LTCIndex *x, const LTCFrameExt *a, const LTCFrameExt *b, ltc_off_t n) {
+	const ltc_off_t len = a->off_end - a->off_start + 1;
+	const double spf = (b->off_start - a->off_start) / (double) n;
+	LTCFrameExt frame;
+	ltc_off_t k;
+
+	memcpy(&frame, a, sizeof(LTCFrameExt));
+	for (k = 1; k < n; ++k) {
+		ltc_frame_advance(&frame.ltc, a->reverse ? -1 : 1, x->fps, LTC_TV_525_60, LTC_NO_PARITY);
+		frame.off_start = a->off_start + (ltc_off_t)(k * spf + .5);
+		frame.off_end = frame.off_start + len - 1;
+		if (ltc_index_add(x, &frame) < 0) {
+			return -1;
+		}
+	}
+	return ltc_index_add(x, (LTCFrameExt*)b) < 0 ? -1 : 0;
+}
+
+/** decode [start, end) and add frames after last->off_start,
+ * @return 1 if frames were added (last is updated), 0 if not, -1 on error
+ */
+static int scan_dense(LTCIndex *x, LTCFileDecoder *f, ltc_off_t start, ltc_off_t end, LTCFrameExt *last) {
+	LTCFrameExt frame;
+	int added = 0;
+	int rv;
+
+	if (ltc_file_decoder_seek(f, start)) {
+		return -1;
+	}
+	while ((rv = file_decoder_read_until(f, &frame, end)) > 0) {
+		if (frame.off_start <= last->off_start) {
+			continue;
+		}
+		if (ltc_index_add(x, &frame) < 0) {
+			return -1;
+		}
+		memcpy(last, &frame, sizeof(LTCFrameExt));
+		added = 1;
+	}
+	return rv < 0 ? -1 : added;
+}
+
+int ltc_index_scan(LTCIndex *x, LTCFileDecoder *f, ltc_off_t stride) {
+	const ltc_off_t probe_len = file_probe_length(f);
+	LTCFrameExt anchor, probe;
+	ltc_off_t prev_p = 0;
+	ltc_off_t p;
+	int have_anchor = 0;
+
+	/* the last frame that was added to the index */
+	anchor.off_start = -1;
+
+	stride = file_probe_stride(f, stride);
+
+	for (p = 0; p < f->length; p += stride) {
+		ltc_off_t n = 0;
+		const int found = scan_probe(x, f, p, &probe);
+		if (found < 0) {
+			return -1;
+		}
+
+		if (found && have_anchor) {
+			n = scan_continues(x, &anchor, &probe);
+		}
+
+		if (n > 0) {
+			if (scan_extrapolate(x, &anchor, &probe, n)) {
+				return -1;
+			}
+			memcpy(&anchor, &probe, sizeof(LTCFrameExt));
+		} else if (found || have_anchor) {
+			/* LTC started, stopped or jumped since the previous probe */
+			if (scan_dense(x, f, prev_p, p + probe_len, &anchor) < 0) {
+				return -1;
+			}
+			have_anchor = found;
+		}
+		prev_p = p;
+	}
+
+	/* the remainder after the last probe */
+	if (scan_dense(x, f, prev_p, f->length, &anchor) < 0) {
+		return -1;
+	}
+	return x->n_entries;
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Lookup
+ */
+
+static int key_cmp(const void *a, const void *b) {
+	const struct LTCIndexKey *ka = (const struct LTCIndexKey*)a;
+	const struct LTCIndexKey *kb = (const struct LTCIndexKey*)b;
+	if (ka->first != kb->first) {
+		return ka->first < kb->first ? -1 : 1;
+	}
+	return ka->entry - kb->entry;
+}
+
+static int index_sort(LTCIndex *x) {
+	int i;
+	if (x->sorted) {
+		return 0;
+	}
+	free(x->order);
+	x->order = (struct LTCIndexKey*) malloc((x->n_entries + 1) * sizeof(struct LTCIndexKey));
+	if (!x->order) {
+		return -1;
+	}
+	for (i = 0; i < x->n_entries; ++i) {
+		x->order[i].first = entry_first(x, &x->entries[i]);
+		x->order[i].entry = i;
+	}
+	qsort(x->order, x->n_entries, sizeof(struct LTCIndexKey), key_cmp);
+	x->sorted = 1;
+	return 0;
+}
+
+/** first position in x->order with a key >= first */
+static int lower_bound(LTCIndex *x, ltc_off_t first) {
+	int lo = 0, hi = x->n_entries;
+	while (lo < hi) {
+		const int mid = (lo + hi) / 2;
+		if (x->order[mid].first < first) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/** find entries with a key in [lo, hi] that cover the frame-number */
+static void scan_candidates(LTCIndex *x, ltc_off_t lo, ltc_off_t hi, ltc_off_t index, ltc_off_t day, int df, int *best) {
+	int i;
+	for (i = lower_bound(x, lo); i < x->n_entries && x->order[i].first <= hi; ++i) {
+		const int entry = x->order[i].entry;
+		const LTCIndexEntry *e = &x->entries[entry];
+		const ltc_off_t k = (index - x->order[i].first + day) % day;
+		if (e->ltc.dfbit != df) {
+			continue;
+		}
+		if (k < e->n_frames && (*best < 0 || entry < *best)) {
+			/* the earliest occurrence in the file */
+			*best = entry;
+		}
+	}
+}
+
+/** entry that covers the timecode, or -1 */
+static int index_find(LTCIndex *x, LTCFrame *timecode) {
+	const ltc_off_t index = ltc_frame_to_index(timecode, x->fps);
+	const ltc_off_t day = frames_per_day(x->fps, timecode->dfbit);
+	const ltc_off_t lo = index - (x->interval - 1);
+	int best = -1;
+
+	if (index_sort(x)) {
+		return -1;
+	}
+
+	scan_candidates(x, lo, index, index, day, timecode->dfbit, &best);
+	if (lo < 0) {
+		/* runs that cross midnight */
+		scan_candidates(x, lo + day, day - 1, index, day, timecode->dfbit, &best);
+	}
+	return best;
+}
+
+/** offset in frames of the timecode relative to the entry */
+static ltc_off_t entry_distance(LTCIndex *x, const LTCIndexEntry *e, LTCFrame *timecode) {
+	const ltc_off_t day = frames_per_day(x->fps, e->ltc.dfbit);
+	const ltc_off_t d = ltc_frame_to_index(timecode, x->fps) - ltc_frame_to_index((LTCFrame*)&e->ltc, x->fps);
+	return ((e->reverse ? -d : d) % day + day) % day;
+}
+
+ltc_off_t ltc_index_lookup(LTCIndex *x, LTCFrame *timecode) {
+	const int i = index_find(x, timecode);
+	const LTCIndexEntry *e;
+	if (i < 0) {
+		return -1;
+	}
+	e = &x->entries[i];
+	return e->off_start + entry_distance(x, e, timecode) * (e->off_end - e->off_start + 1);
+}
+
+ltc_off_t ltc_index_seek(LTCIndex *x, LTCFileDecoder *f, LTCFrame *timecode, LTCFrameExt *frame) {
+	const ltc_off_t index = ltc_frame_to_index(timecode, x->fps);
+	const int i = index_find(x, timecode);
+	const LTCIndexEntry *e;
+	ltc_off_t len, start, limit;
+	LTCFrameExt tmp;
+
+	if (i < 0) {
+		return -1;
+	}
+	if (!frame) {
+		frame = &tmp;
+	}
+
+	e = &x->entries[i];
+	len = e->off_end - e->off_start + 1;
+	/* decode from two frames before the estimated position */
+	start = e->off_start + (entry_distance(x, e, timecode) - 2) * len;
+	if (start < e->off_start - 2 * len) {
+		start = e->off_start - 2 * len;
+	}
+	if (start < 0) {
+		start = 0;
+	}
+	limit = e->off_start + (e->n_frames + 1) * len;
+
+	if (ltc_file_decoder_seek(f, start)) {
+		return -1;
+	}
+	while (ltc_file_decoder_read(f, frame) > 0 && frame->off_start <= limit) {
+		if (frame->off_start >= e->off_start
+				&& frame->ltc.dfbit == timecode->dfbit
+				&& ltc_frame_to_index(&frame->ltc, x->fps) == index) {
+			return frame->off_start;
+		}
+	}
+	return -1;
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Index file
+ *
+ * little-endian, header: "LTCX", version, fps, interval, entry count (u32 each)
+ * followed by fixed size records of LTC_INDEX_RECORD bytes.
+ */
+
+#define LTC_INDEX_RECORD 32
+
+static void wr_u32(unsigned char *p, uint32_t v) {
+	p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static uint32_t rd_u32(const unsigned char *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void wr_off(unsigned char *p, ltc_off_t v) {
+	wr_u32(p, (uint64_t)v & 0xffffffff);
+	wr_u32(p + 4, (uint64_t)v >> 32);
+}
+
+static ltc_off_t rd_off(const unsigned char *p) {
+	return (ltc_off_t)((uint64_t)rd_u32(p) | ((uint64_t)rd_u32(p + 4) << 32));
+}
+
+static void encode_entry(unsigned char *p, const LTCIndexEntry *e) {
+	const LTCFrame *f = &e->ltc;
+	p[0] = f->frame_units | (f->frame_tens << 4);
+	p[1] = f->secs_units  | (f->secs_tens << 4);
+	p[2] = f->mins_units  | (f->mins_tens << 4);
+	p[3] = f->hours_units | (f->hours_tens << 4);
+	p[4] = f->user1 | (f->user2 << 4);
+	p[5] = f->user3 | (f->user4 << 4);
+	p[6] = f->user5 | (f->user6 << 4);
+	p[7] = f->user7 | (f->user8 << 4);
+	p[8] = (f->dfbit ? 1 : 0) | (f->col_frame ? 2 : 0) | (f->binary_group_flag_bit0 ? 4 : 0)
+		| (f->binary_group_flag_bit1 ? 8 : 0) | (f->biphase_mark_phase_correction ? 16 : 0)
+		| (e->reverse ? 64 : 0) | (e->discontinuity ? 128 : 0);
+	p[9] = p[10] = p[11] = 0;
+	wr_u32(&p[12], e->n_frames);
+	wr_off(&p[16], e->off_start);
+	wr_off(&p[24], e->off_end);
+}
+
+static void decode_entry(const unsigned char *p, LTCIndexEntry *e) {
+	LTCFrame *f = &e->ltc;
+	ltc_frame_reset(f);
+	f->frame_units = p[0] & 0xf; f->frame_tens = p[0] >> 4;
+	f->secs_units  = p[1] & 0xf; f->secs_tens  = p[1] >> 4;
+	f->mins_units  = p[2] & 0xf; f->mins_tens  = p[2] >> 4;
+	f->hours_units = p[3] & 0xf; f->hours_tens = p[3] >> 4;
+	f->user1 = p[4] & 0xf; f->user2 = p[4] >> 4;
+	f->user3 = p[5] & 0xf; f->user4 = p[5] >> 4;
+	f->user5 = p[6] & 0xf; f->user6 = p[6] >> 4;
+	f->user7 = p[7] & 0xf; f->user8 = p[7] >> 4;
+	f->dfbit = (p[8] & 1) ? 1 : 0;
+	f->col_frame = (p[8] & 2) ? 1 : 0;
+	f->binary_group_flag_bit0 = (p[8] & 4) ? 1 : 0;
+	f->binary_group_flag_bit1 = (p[8] & 8) ? 1 : 0;
+	f->biphase_mark_phase_correction = (p[8] & 16) ? 1 : 0;
+	e->reverse = (p[8] & 64) ? 1 : 0;
+	e->discontinuity = (p[8] & 128) ? 1 : 0;
+	e->n_frames = rd_u32(&p[12]);
+	e->off_start = rd_off(&p[16]);
+	e->off_end = rd_off(&p[24]);
+}
+
+int ltc_index_save(LTCIndex *x, const char *path) {
+	unsigned char buf[LTC_INDEX_RECORD];
+	int i, rv = 0;
+	FILE *f = fopen(path, "wb");
+	if (!f) {
+		return -1;
+	}
+
+	memcpy(buf, LTC_INDEX_MAGIC, 4);
+	wr_u32(&buf[4], LTC_INDEX_VERSION);
+	wr_u32(&buf[8], x->fps);
+	wr_u32(&buf[12], x->interval);
+	wr_u32(&buf[16], x->n_entries);
+	if (fwrite(buf, 1, 20, f) != 20) {
+		rv = -1;
+	}
+
+	for (i = 0; i < x->n_entries && rv == 0; ++i) {
+		encode_entry(buf, &x->entries[i]);
+		if (fwrite(buf, 1, LTC_INDEX_RECORD, f) != LTC_INDEX_RECORD) {
+			rv = -1;
+		}
+	}
+
+	if (fclose(f)) {
+		rv = -1;
+	}
+	return rv;
+}
+
+LTCIndex* ltc_index_load(const char *path) {
+	unsigned char buf[LTC_INDEX_RECORD];
+	LTCIndex *x = NULL;
+	uint32_t i, n;
+	FILE *f = fopen(path, "rb");
+	if (!f) {
+		return NULL;
+	}
+
+	if (fread(buf, 1, 20, f) != 20
+			|| memcmp(buf, LTC_INDEX_MAGIC, 4)
+			|| rd_u32(&buf[4]) != LTC_INDEX_VERSION) {
+		goto fail;
+	}
+
+	x = ltc_index_create(rd_u32(&buf[8]), rd_u32(&buf[12]));
+	if (!x) {
+		goto fail;
+	}
+
+	n = rd_u32(&buf[16]);
+	for (i = 0; i < n; ++i) {
+		LTCIndexEntry *e;
+		if (fread(buf, 1, LTC_INDEX_RECORD, f) != LTC_INDEX_RECORD || !(e = index_append(x))) {
+			goto fail;
+		}
+		decode_entry(buf, e);
+	}
+
+	fclose(f);
+	return x;
+
+fail:
+	ltc_index_free(x);
+	fclose(f);
+	return NULL;
+}
@@ -0,0 +1,54 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LTC_INDEX_H
+#define LTC_INDEX_H 1
+
+#include <stdint.h>
+#include "ltc.h"
+
+/** index file magic and version */
+#define LTC_INDEX_MAGIC "LTCX"
+#define LTC_INDEX_VERSION 1
+
+struct LTCIndexKey {
+	ltc_off_t first; ///< lowest frame-number covered by the entry
+	int entry;
+};
+
+struct LTCIndex {
+	int fps;
+	int interval; ///< maximum number of frames covered by one checkpoint
+
+	LTCIndexEntry *entries; ///< ordered by off_start
+	int n_entries;
+	int alloc;
+
+	struct LTCIndexKey *order; ///< entries sorted by the first frame-number they cover
+	int sorted;
+
+	/* builder state */
+	int have_prev;
+	ltc_off_t prev_index;
+	ltc_off_t prev_off_end;
+	int prev_reverse;
+};
+
+#endif
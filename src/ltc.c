@@ -26,6 +26,7 @@
 #include "ltc.h"
 #include "decoder.h"
 #include "encoder.h"
+#include "pool.h"
 
 #if (defined _MSC_VER && _MSC_VER < 1800) || (defined __AVR__)
 static double rint(double v) {
@@ -35,23 +36,51 @@ static double rint(double v) {
 #endif
 
 /* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
- * Decoder
+ * Memory allocation
  */
 
-LTCDecoder* ltc_decoder_create(int apv, int queue_len) {
-	LTCDecoder* d = (LTCDecoder*) calloc(1, sizeof(LTCDecoder));
-	if (!d) return NULL;
+/** offset of data that follows an object in the same block */
+#define MEM_ALIGN(size) (((size) + 15) & ~(size_t)15)
 
-	if (queue_len < 1) {
-		queue_len = 1;
+static void* mem_alloc(const LTCAllocator *a, size_t size) {
+	void *p;
+	if (!a || !a->alloc) {
+		return calloc(1, size);
+	}
+	p = a->alloc(a->arg, size);
+	if (p) {
+		memset(p, 0, size);
 	}
+	return p;
+}
 
-	d->queue_len = queue_len;
-	d->queue = (LTCFrameExt*) calloc(d->queue_len, sizeof(LTCFrameExt));
-	if (!d->queue) {
-		free(d);
-		return NULL;
+static void mem_free(const LTCAllocator *a, void *p) {
+	if (!a || !a->alloc) {
+		free(p);
+	} else if (a->free) {
+		a->free(a->arg, p);
 	}
+}
+
+static int mem_misaligned(const void *mem) {
+	return ((size_t)mem) % sizeof(double) != 0;
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Decoder
+ */
+
+void decoder_init(LTCDecoder *d, int apv, LTCFrameExt *queue, int queue_len) {
+	/* the decoder's memory is retained for re-initialization */
+	const LTCAllocator mem = d->mem;
+	const unsigned char mem_external = d->mem_external;
+
+	memset(d, 0, sizeof(LTCDecoder));
+	d->mem = mem;
+	d->mem_external = mem_external;
+	d->queue_len = queue_len;
+	d->queue = queue;
+
 	d->biphase_state = 1;
 	d->snd_to_biphase_period = apv / 80;
 	d->snd_to_biphase_lmt = (d->snd_to_biphase_period * 3) / 4;
@@ -60,14 +89,98 @@ LTCDecoder* ltc_decoder_create(int apv, int queue_len) {
 	d->snd_to_biphase_max = SAMPLE_CENTER;
 	d->frame_start_prev = -1;
 	d->biphase_tic = 0;
+}
+
+LTCDecoder* ltc_decoder_create(int apv, int queue_len) {
+	return ltc_decoder_create_ex(apv, queue_len, 0);
+}
+
+LTCDecoder* ltc_decoder_create_ex(int apv, int queue_len, int flags) {
+	return ltc_decoder_create_alloc(NULL, apv, queue_len, flags);
+}
+
+/** size of the compact queue's bit timing, following the queue */
+static size_t decoder_tics_size(int queue_len, int flags) {
+	if ((flags & (LTC_DECODER_COMPACT | LTC_DECODER_TICS)) != (LTC_DECODER_COMPACT | LTC_DECODER_TICS)) {
+		return 0;
+	}
+	return (size_t)queue_len * LTC_FRAME_BIT_COUNT * sizeof(float);
+}
+
+size_t ltc_decoder_size(int queue_len, int flags) {
+	if (queue_len < 1) {
+		queue_len = 1;
+	}
+	return MEM_ALIGN(sizeof(LTCDecoder))
+		+ queue_len * ((flags & LTC_DECODER_COMPACT) ? sizeof(LTCFrameCompact) : sizeof(LTCFrameExt))
+		+ decoder_tics_size(queue_len, flags);
+}
+
+LTCDecoder* ltc_decoder_create_in(void *mem, size_t size, int apv, int queue_len, int flags) {
+	LTCDecoder* d = (LTCDecoder*) mem;
+	void* queue;
+
+	if (!mem || mem_misaligned(mem) || size < ltc_decoder_size(queue_len, flags)) {
+		return NULL;
+	}
+	if (queue_len < 1) {
+		queue_len = 1;
+	}
+
+	/* the queue follows the decoder in the same block */
+	memset(mem, 0, ltc_decoder_size(queue_len, flags));
+	queue = (char*)mem + MEM_ALIGN(sizeof(LTCDecoder));
+	d->mem_external = 1;
+
+	if (flags & LTC_DECODER_COMPACT) {
+		decoder_init(d, apv, NULL, queue_len);
+		d->queue_compact = (LTCFrameCompact*) queue;
+		if (decoder_tics_size(queue_len, flags)) {
+			d->queue_tics = (float*) &d->queue_compact[queue_len];
+		}
+	} else {
+		decoder_init(d, apv, (LTCFrameExt*) queue, queue_len);
+	}
+	d->early = (flags & LTC_DECODER_EARLY) ? 1 : 0;
+	d->detect = (flags & LTC_DECODER_AUTODETECT) ? 1 : 0;
+	d->matched = (flags & LTC_DECODER_MATCHED) ? 1 : 0;
+	decoder_detect_restart(d);
 
 	return d;
 }
 
+LTCDecoder* ltc_decoder_create_alloc(const LTCAllocator *allocator, int apv, int queue_len, int flags) {
+	const size_t size = ltc_decoder_size(queue_len, flags);
+	LTCDecoder* d;
+	void* mem = mem_alloc(allocator, size);
+	if (!mem) return NULL;
+
+	d = ltc_decoder_create_in(mem, size, apv, queue_len, flags);
+	if (!d) {
+		mem_free(allocator, mem);
+		return NULL;
+	}
+	d->mem_external = 0;
+	if (allocator) {
+		d->mem = *allocator;
+	}
+	return d;
+}
+
+int ltc_decoder_reconfigure(LTCDecoder *d, int apv) {
+	if (apv < 0) {
+		return -1;
+	}
+	decoder_reconfigure(d, apv);
+	return 0;
+}
+
 int ltc_decoder_free(LTCDecoder *d) {
+	LTCAllocator mem;
 	if (!d) return 1;
-	if (d->queue) free(d->queue);
-	free(d);
+	if (d->mem_external) return 0;
+	mem = d->mem;
+	mem_free(&mem, d);
 
 	return 0;
 }
@@ -76,52 +189,572 @@ void ltc_decoder_write(LTCDecoder *d, ltcsnd_sample_t *buf, size_t size, ltc_off
 	decode_ltc(d, buf, size, posinfo);
 }
 
-#define LTC_CONVERSION_BUF_SIZE 1024
+void ltc_decoder_write_double(LTCDecoder *d, double *buf, size_t size, ltc_off_t posinfo) {
+	decode_ltc_double(d, buf, 1, size, posinfo);
+}
 
-#define LTCWRITE_TEMPLATE(FN, FORMAT, CONV) \
-void ltc_decoder_write_ ## FN (LTCDecoder *d, FORMAT *buf, size_t size, ltc_off_t posinfo) { \
-	ltcsnd_sample_t tmp[LTC_CONVERSION_BUF_SIZE]; \
-	size_t copyStart = 0; \
-	while (copyStart < size) { \
-		int i; \
-		int c = size - copyStart; \
-		c = (c > LTC_CONVERSION_BUF_SIZE) ? LTC_CONVERSION_BUF_SIZE : c; \
-		for (i=0; i < c; i++) { \
-			tmp[i] = CONV; \
-		} \
-		decode_ltc(d, tmp, c, posinfo + (ltc_off_t)copyStart); \
-		copyStart += c; \
-	} \
+void ltc_decoder_write_float(LTCDecoder *d, float *buf, size_t size, ltc_off_t posinfo) {
+	decode_ltc_float(d, buf, 1, size, posinfo);
+}
+
+void ltc_decoder_write_s16(LTCDecoder *d, short *buf, size_t size, ltc_off_t posinfo) {
+	decode_ltc_s16(d, buf, 1, size, posinfo);
+}
+
+void ltc_decoder_write_u16(LTCDecoder *d, unsigned short *buf, size_t size, ltc_off_t posinfo) {
+	decode_ltc_u16(d, buf, 1, size, posinfo);
 }
 
-LTCWRITE_TEMPLATE(double, double, 128 + (buf[copyStart+i] * 127.0))
-LTCWRITE_TEMPLATE(float, float, 128 + (buf[copyStart+i] * 127.f))
-/* this relies on the compiler to use an arithmetic right-shift for signed values */
-LTCWRITE_TEMPLATE(s16, short, 128 + (buf[copyStart+i] >> 8))
-/* this relies on the compiler to use a logical right-shift for unsigned values */
-LTCWRITE_TEMPLATE(u16, unsigned short, (buf[copyStart+i] >> 8))
+/** queue slot of the oldest frame, or -1 if the queue is empty */
+static int queue_head(LTCDecoder* d) {
+	const unsigned int r = ltc_atomic_load_relaxed(&d->queue_read_off);
+	const unsigned int w = ltc_atomic_load_acquire(&d->queue_write_off);
+	if (r == w) {
+		return -1;
+	}
+	return r % d->queue_len;
+}
 
-#undef LTC_CONVERSION_BUF_SIZE
+/** release the oldest frame's slot to the decoder */
+static void queue_pop(LTCDecoder* d) {
+	const unsigned int r = ltc_atomic_load_relaxed(&d->queue_read_off);
+	ltc_atomic_store_release(&d->queue_read_off, (r + 1) % (2 * d->queue_len));
+}
 
 int ltc_decoder_read(LTCDecoder* d, LTCFrameExt* frame) {
+	int slot;
 	if (!frame) return -1;
-	if (d->queue_read_off != d->queue_write_off) {
-		if (d->queue_read_off == d->queue_len) {
-			d->queue_read_off = 0;
+	slot = queue_head(d);
+	if (slot < 0) {
+		return 0;
+	}
+	if (d->queue_compact) {
+		const LTCFrameCompact *f = &d->queue_compact[slot];
+		memset(frame, 0, sizeof(LTCFrameExt));
+		memcpy(&frame->ltc, &f->ltc, sizeof(LTCFrame));
+		frame->off_start = f->off_start;
+		frame->off_end = f->off_end;
+		frame->reverse = f->reverse;
+		frame->sample_min = f->sample_min;
+		frame->sample_max = f->sample_max;
+		frame->volume = f->volume;
+		if (d->queue_tics) {
+			memcpy(frame->biphase_tics, &d->queue_tics[slot * LTC_FRAME_BIT_COUNT], sizeof(frame->biphase_tics));
 		}
-		memcpy(frame, &d->queue[d->queue_read_off], sizeof(LTCFrameExt));
-		d->queue_read_off++;
-		return 1;
+	} else {
+		memcpy(frame, &d->queue[slot], sizeof(LTCFrameExt));
+	}
+	queue_pop(d);
+	return 1;
+}
+
+int ltc_decoder_read_compact(LTCDecoder* d, LTCFrameCompact* frame) {
+	int slot;
+	if (!frame) return -1;
+	slot = queue_head(d);
+	if (slot < 0) {
+		return 0;
+	}
+	if (d->queue_compact) {
+		memcpy(frame, &d->queue_compact[slot], sizeof(LTCFrameCompact));
+	} else {
+		const LTCFrameExt *f = &d->queue[slot];
+		memcpy(&frame->ltc, &f->ltc, sizeof(LTCFrame));
+		frame->off_start = f->off_start;
+		frame->off_end = f->off_end;
+		frame->reverse = f->reverse;
+		frame->sample_min = f->sample_min;
+		frame->sample_max = f->sample_max;
+		frame->volume = f->volume;
+	}
+	queue_pop(d);
+	return 1;
+}
+
+/** number of queued frames in contiguous memory, starting at the queue head */
+static int queue_contiguous(LTCDecoder* d, int *slot) {
+	const unsigned int r = ltc_atomic_load_relaxed(&d->queue_read_off);
+	const unsigned int w = ltc_atomic_load_acquire(&d->queue_write_off);
+	const int n = (w + 2 * d->queue_len - r) % (2 * d->queue_len);
+	*slot = r % d->queue_len;
+	return n < d->queue_len - *slot ? n : d->queue_len - *slot;
+}
+
+int ltc_decoder_read_early(LTCDecoder* d, LTCFrameEarly* frame) {
+	const unsigned int r = ltc_atomic_load_relaxed(&d->early_read_off);
+	const unsigned int w = ltc_atomic_load_acquire(&d->early_write_off);
+	if (!frame) return -1;
+	if (r == w) {
+		return 0;
+	}
+	memcpy(frame, &d->early_queue[r % LTC_EARLY_QUEUE], sizeof(LTCFrameEarly));
+	ltc_atomic_store_release(&d->early_read_off, (r + 1) % (2 * LTC_EARLY_QUEUE));
+	return 1;
+}
+
+int ltc_decoder_peek(LTCDecoder* d, const LTCFrameExt** frames) {
+	int slot;
+	int n;
+	if (!frames || !d->queue) return -1;
+	n = queue_contiguous(d, &slot);
+	*frames = n > 0 ? &d->queue[slot] : NULL;
+	return n;
+}
+
+int ltc_decoder_peek_compact(LTCDecoder* d, const LTCFrameCompact** frames) {
+	int slot;
+	int n;
+	if (!frames || !d->queue_compact) return -1;
+	n = queue_contiguous(d, &slot);
+	*frames = n > 0 ? &d->queue_compact[slot] : NULL;
+	return n;
+}
+
+int ltc_decoder_consume(LTCDecoder* d, int n) {
+	const unsigned int r = ltc_atomic_load_relaxed(&d->queue_read_off);
+	const int len = ltc_decoder_queue_length(d);
+	if (n > len) n = len;
+	if (n <= 0) return 0;
+	ltc_atomic_store_release(&d->queue_read_off, (r + n) % (2 * d->queue_len));
+	return n;
+}
+
+int ltc_decoder_peek_tics(LTCDecoder* d, int i, float* tics) {
+	const unsigned int r = ltc_atomic_load_relaxed(&d->queue_read_off);
+	int slot;
+	if (!tics || (d->queue_compact && !d->queue_tics)) return -1;
+	if (i < 0 || i >= ltc_decoder_queue_length(d)) return -1;
+	slot = (r + i) % d->queue_len;
+	if (d->queue_tics) {
+		memcpy(tics, &d->queue_tics[slot * LTC_FRAME_BIT_COUNT], LTC_FRAME_BIT_COUNT * sizeof(float));
+	} else {
+		memcpy(tics, d->queue[slot].biphase_tics, LTC_FRAME_BIT_COUNT * sizeof(float));
 	}
 	return 0;
 }
 
 void ltc_decoder_queue_flush(LTCDecoder* d) {
-	d->queue_read_off = d->queue_write_off;
+	ltc_atomic_store_release(&d->queue_read_off, ltc_atomic_load_acquire(&d->queue_write_off));
 }
 
 int ltc_decoder_queue_length(LTCDecoder* d) {
-	return (d->queue_write_off - d->queue_read_off + d->queue_len) % d->queue_len;
+	const unsigned int r = ltc_atomic_load_relaxed(&d->queue_read_off);
+	const unsigned int w = ltc_atomic_load_acquire(&d->queue_write_off);
+	return (w + 2 * d->queue_len - r) % (2 * d->queue_len);
+}
+
+unsigned int ltc_decoder_queue_overruns(LTCDecoder* d) {
+	return ltc_atomic_load_acquire(&d->queue_overruns);
+}
+
+void ltc_decoder_stats(LTCDecoder* d, LTCDecoderStats* stats) {
+	memcpy(stats, &d->stats, sizeof(LTCDecoderStats));
+	stats->overruns = ltc_atomic_load_acquire(&d->queue_overruns) - d->stats_overruns;
+}
+
+void ltc_decoder_stats_reset(LTCDecoder* d) {
+	memset(&d->stats, 0, sizeof(LTCDecoderStats));
+	d->stats_overruns = ltc_atomic_load_acquire(&d->queue_overruns);
+}
+
+int ltc_decoder_detect(LTCDecoder* d, double sample_rate, double* fps, int* drop_frame) {
+	static const double rates[] = { 24000.0 / 1001.0, 24, 25, 30000.0 / 1001.0, 30 };
+	double rate = 0;
+	double best = 0;
+	int rv = 1;
+	unsigned int i;
+
+	if (!d->detect || d->detect_edges < LTC_DETECT_EDGES) {
+		return 0;
+	}
+	if (sample_rate > 0) {
+		const double apv = d->detect_len_cnt > 0 ? d->detect_len / d->detect_len_cnt : 80 * d->snd_to_biphase_period;
+		rate = sample_rate / apv;
+	}
+
+	if (d->detect_fps > 0) {
+		rv = 2;
+		best = d->detect_fps;
+		if (d->detect_fps == 30 && d->detect_df) {
+			best = 30000.0 / 1001.0;
+		} else if ((d->detect_fps == 24 || d->detect_fps == 30) && rate > 0) {
+			const double pull = d->detect_fps * 1000.0 / 1001.0;
+			if (fabs(rate - pull) < fabs(rate - d->detect_fps)) {
+				best = pull;
+			}
+		}
+	} else if (rate > 0) {
+		best = rates[0];
+		for (i = 1; i < sizeof(rates) / sizeof(rates[0]); ++i) {
+			if (fabs(rate - rates[i]) < fabs(rate - best)) {
+				best = rates[i];
+			}
+		}
+	} else {
+		return 0;
+	}
+
+	*fps = best;
+	if (drop_frame) {
+		*drop_frame = d->detect_df;
+	}
+	return rv;
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Decoder bank
+ */
+
+LTCDecoderBank* ltc_decoder_bank_create(int channels, int apv, int queue_len) {
+	LTCDecoderBank* b;
+	int c;
+
+	if (channels < 1) return NULL;
+	if (queue_len < 1) {
+		queue_len = 1;
+	}
+
+	b = (LTCDecoderBank*) calloc(1, sizeof(LTCDecoderBank));
+	if (!b) return NULL;
+
+	b->channels = channels;
+	b->decoders = (LTCDecoder*) calloc(channels, sizeof(LTCDecoder));
+	b->queues = (LTCFrameExt*) calloc((size_t)channels * queue_len, sizeof(LTCFrameExt));
+	b->snd_min = (ltcsnd_sample_t*) calloc(channels, sizeof(ltcsnd_sample_t));
+	b->snd_max = (ltcsnd_sample_t*) calloc(channels, sizeof(ltcsnd_sample_t));
+	b->env_min = (float*) calloc(channels, sizeof(float));
+	b->env_max = (float*) calloc(channels, sizeof(float));
+	b->state = (unsigned char*) calloc(channels, sizeof(unsigned char));
+	b->cnt = (int*) calloc(channels, sizeof(int));
+
+	if (!b->decoders || !b->queues || !b->snd_min || !b->snd_max
+			|| !b->env_min || !b->env_max || !b->state || !b->cnt) {
+		ltc_decoder_bank_free(b);
+		return NULL;
+	}
+
+	for (c = 0; c < channels; ++c) {
+		decoder_init(&b->decoders[c], apv, &b->queues[(size_t)c * queue_len], queue_len);
+		b->snd_min[c] = SAMPLE_CENTER;
+		b->snd_max[c] = SAMPLE_CENTER;
+	}
+	return b;
+}
+
+int ltc_decoder_bank_free(LTCDecoderBank *b) {
+	if (!b) return 1;
+	pool_free(b->pool);
+	free(b->decoders);
+	free(b->queues);
+	free(b->snd_min);
+	free(b->snd_max);
+	free(b->env_min);
+	free(b->env_max);
+	free(b->state);
+	free(b->cnt);
+	free(b);
+	return 0;
+}
+
+int ltc_decoder_bank_channels(LTCDecoderBank *b) {
+	return b->channels;
+}
+
+int ltc_decoder_bank_set_threads(LTCDecoderBank *b, int threads) {
+	if (threads > b->channels) {
+		threads = b->channels;
+	}
+	if (threads == pool_size(b->pool)) {
+		return threads;
+	}
+	pool_free(b->pool);
+	b->pool = pool_create(threads);
+	return pool_size(b->pool);
+}
+
+enum BankFormat {
+	BANK_U8,
+	BANK_FLOAT,
+	BANK_S16,
+	BANK_PLANAR_U8,
+	BANK_PLANAR_FLOAT,
+	BANK_PLANAR_S16
+};
+
+struct BankJob {
+	LTCDecoderBank *b;
+	enum BankFormat fmt;
+	void *buf;
+	size_t size;
+	ltc_off_t posinfo;
+};
+
+/* decode a contiguous range of channels, one range per worker */
+static void bank_job(void *arg, int job, int n_jobs) {
+	struct BankJob *j = (struct BankJob*) arg;
+	const int c0 = (job * j->b->channels) / n_jobs;
+	const int c1 = ((job + 1) * j->b->channels) / n_jobs;
+	switch (j->fmt) {
+		case BANK_U8:
+			decode_ltc_bank(j->b, (ltcsnd_sample_t*) j->buf, c0, c1, j->size, j->posinfo);
+			break;
+		case BANK_FLOAT:
+			decode_ltc_bank_float(j->b, (float*) j->buf, c0, c1, j->size, j->posinfo);
+			break;
+		case BANK_S16:
+			decode_ltc_bank_s16(j->b, (short*) j->buf, c0, c1, j->size, j->posinfo);
+			break;
+		case BANK_PLANAR_U8:
+			decode_ltc_bank_planar(j->b, (ltcsnd_sample_t**) j->buf, c0, c1, j->size, j->posinfo);
+			break;
+		case BANK_PLANAR_FLOAT:
+			decode_ltc_bank_planar_float(j->b, (float**) j->buf, c0, c1, j->size, j->posinfo);
+			break;
+		case BANK_PLANAR_S16:
+			decode_ltc_bank_planar_s16(j->b, (short**) j->buf, c0, c1, j->size, j->posinfo);
+			break;
+	}
+}
+
+static void bank_write(LTCDecoderBank *b, enum BankFormat fmt, void *buf, size_t size, ltc_off_t posinfo) {
+	struct BankJob j;
+	j.b = b;
+	j.fmt = fmt;
+	j.buf = buf;
+	j.size = size;
+	j.posinfo = posinfo;
+	pool_run(b->pool, bank_job, &j);
+}
+
+void ltc_decoder_bank_write(LTCDecoderBank *b, ltcsnd_sample_t *buf, size_t size, ltc_off_t posinfo) {
+	bank_write(b, BANK_U8, buf, size, posinfo);
+}
+
+void ltc_decoder_bank_write_float(LTCDecoderBank *b, float *buf, size_t size, ltc_off_t posinfo) {
+	bank_write(b, BANK_FLOAT, buf, size, posinfo);
+}
+
+void ltc_decoder_bank_write_s16(LTCDecoderBank *b, short *buf, size_t size, ltc_off_t posinfo) {
+	bank_write(b, BANK_S16, buf, size, posinfo);
+}
+
+void ltc_decoder_bank_write_planar(LTCDecoderBank *b, ltcsnd_sample_t **bufs, size_t size, ltc_off_t posinfo) {
+	bank_write(b, BANK_PLANAR_U8, bufs, size, posinfo);
+}
+
+void ltc_decoder_bank_write_planar_float(LTCDecoderBank *b, float **bufs, size_t size, ltc_off_t posinfo) {
+	bank_write(b, BANK_PLANAR_FLOAT, bufs, size, posinfo);
+}
+
+void ltc_decoder_bank_write_planar_s16(LTCDecoderBank *b, short **bufs, size_t size, ltc_off_t posinfo) {
+	bank_write(b, BANK_PLANAR_S16, bufs, size, posinfo);
+}
+
+int ltc_decoder_bank_read(LTCDecoderBank *b, LTCFrameExt *frame, int *channel) {
+	int c;
+	int best = -1;
+	ltc_off_t best_off = 0;
+
+	if (!frame) return -1;
+
+	/* return the oldest frame of all channels */
+	for (c = 0; c < b->channels; ++c) {
+		const int slot = queue_head(&b->decoders[c]);
+		if (slot < 0) {
+			continue;
+		}
+		if (best < 0 || b->decoders[c].queue[slot].off_start < best_off) {
+			best = c;
+			best_off = b->decoders[c].queue[slot].off_start;
+		}
+	}
+
+	if (best < 0) {
+		return 0;
+	}
+	if (channel) {
+		*channel = best;
+	}
+	return ltc_decoder_read(&b->decoders[best], frame);
+}
+
+int ltc_decoder_bank_queue_length(LTCDecoderBank *b) {
+	int c;
+	int len = 0;
+	for (c = 0; c < b->channels; ++c) {
+		len += ltc_decoder_queue_length(&b->decoders[c]);
+	}
+	return len;
+}
+
+void ltc_decoder_bank_queue_flush(LTCDecoderBank *b) {
+	int c;
+	for (c = 0; c < b->channels; ++c) {
+		ltc_decoder_queue_flush(&b->decoders[c]);
+	}
+}
+
+int ltc_decoder_bank_stats(LTCDecoderBank *b, int channel, LTCDecoderStats* stats) {
+	if (channel < 0 || channel >= b->channels) {
+		return -1;
+	}
+	ltc_decoder_stats(&b->decoders[channel], stats);
+	return 0;
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Offline parallel decoding
+ *
+ * The buffer is split into one chunk per job. Every chunk is decoded
+ * with a separate decoder, starting LTC_CHUNK_OVERLAP video-frames
+ * before and ending LTC_CHUNK_OVERLAP video-frames after the chunk, so
+ * that the decoder is locked at the chunk boundary and frames crossing
+ * the end are completed. A chunk only keeps the frames starting inside
+ * it, so concatenating the results in chunk order yields each frame
+ * exactly once. If the overlap ends while a frame that started inside the
+ * chunk is still being received (e.g. the frame is followed by silence),
+ * decoding continues until the frame completes.
+ */
+
+#define LTC_CHUNK_OVERLAP 2
+#define LTC_CHUNK_BLOCK 1024
+
+struct ChunkJob {
+	void *buf;
+	int is_float;
+	size_t size;
+	int apv;
+	int n_chunks;
+	struct {
+		LTCFrameExt *frames;
+		int n_frames;
+		int alloc;
+		int error;
+	} result[1]; // [n_chunks]
+};
+
+static void chunk_job(void *arg, int job, int n_jobs) {
+	struct ChunkJob *j = (struct ChunkJob*) arg;
+	const size_t overlap = (size_t)j->apv * LTC_CHUNK_OVERLAP;
+	int chunk;
+
+	/* a pool may have fewer jobs than chunks */
+	for (chunk = job; chunk < j->n_chunks; chunk += n_jobs) {
+		const size_t start = (j->size / j->n_chunks) * chunk;
+		const size_t end = (chunk == j->n_chunks - 1) ? j->size : start + j->size / j->n_chunks;
+		const size_t from = start > overlap ? start - overlap : 0;
+		const size_t to = j->size - end > overlap ? end + overlap : j->size;
+		LTCDecoder *d = ltc_decoder_create(j->apv, 32);
+		LTCFrameExt frame;
+		int done = 0;
+		size_t pos;
+
+		if (!d) {
+			j->result[chunk].error = 1;
+			continue;
+		}
+
+		for (pos = from; pos < j->size; pos += LTC_CHUNK_BLOCK) {
+			const size_t n = (j->size - pos) < LTC_CHUNK_BLOCK ? (j->size - pos) : LTC_CHUNK_BLOCK;
+			if (pos >= to && (done || d->bit_cnt == 0)) {
+				/* a frame that is followed by silence completes only with the next edge */
+				break;
+			}
+			if (j->is_float) {
+				ltc_decoder_write_float(d, &((float*)j->buf)[pos], n, pos);
+			} else {
+				ltc_decoder_write(d, &((ltcsnd_sample_t*)j->buf)[pos], n, pos);
+			}
+
+			while (ltc_decoder_read(d, &frame)) {
+				if (chunk > 0 && frame.off_start < (ltc_off_t)start) continue;
+				if (chunk < j->n_chunks - 1 && frame.off_start >= (ltc_off_t)end) {
+					done = 1;
+					continue;
+				}
+				if (j->result[chunk].n_frames == j->result[chunk].alloc) {
+					const int alloc = j->result[chunk].alloc ? j->result[chunk].alloc * 2 : 64;
+					LTCFrameExt *f = (LTCFrameExt*) realloc(j->result[chunk].frames, alloc * sizeof(LTCFrameExt));
+					if (!f) {
+						j->result[chunk].error = 1;
+						break;
+					}
+					j->result[chunk].frames = f;
+					j->result[chunk].alloc = alloc;
+				}
+				memcpy(&j->result[chunk].frames[j->result[chunk].n_frames++], &frame, sizeof(LTCFrameExt));
+			}
+			if (j->result[chunk].error) break;
+		}
+
+		ltc_decoder_free(d);
+	}
+}
+
+static int decode_parallel(void *buf, int is_float, size_t size, int apv, int threads, LTCFrameExt **frames) {
+	struct ChunkJob *j;
+	LTCPool *pool;
+	int n_chunks;
+	int n_frames = 0;
+	int error = 0;
+	int c;
+
+	if (!frames || apv < 80) return -1;
+	*frames = NULL;
+
+	/* chunks must be considerably longer than the overlap */
+	n_chunks = threads < 1 ? 1 : threads;
+	while (n_chunks > 1 && size / n_chunks < (size_t)apv * LTC_CHUNK_OVERLAP * 8) {
+		--n_chunks;
+	}
+
+	j = (struct ChunkJob*) calloc(1, sizeof(struct ChunkJob) + (n_chunks - 1) * sizeof(j->result[0]));
+	if (!j) return -1;
+	j->buf = buf;
+	j->is_float = is_float;
+	j->size = size;
+	j->apv = apv;
+	j->n_chunks = n_chunks;
+
+	pool = pool_create(n_chunks);
+	pool_run(pool, chunk_job, j);
+	pool_free(pool);
+
+	for (c = 0; c < n_chunks; ++c) {
+		n_frames += j->result[c].n_frames;
+		error |= j->result[c].error;
+	}
+
+	if (!error && n_frames > 0) {
+		*frames = (LTCFrameExt*) malloc(n_frames * sizeof(LTCFrameExt));
+		if (*frames) {
+			LTCFrameExt *f = *frames;
+			for (c = 0; c < n_chunks; ++c) {
+				memcpy(f, j->result[c].frames, j->result[c].n_frames * sizeof(LTCFrameExt));
+				f += j->result[c].n_frames;
+			}
+		} else {
+			error = 1;
+		}
+	}
+
+	for (c = 0; c < n_chunks; ++c) {
+		free(j->result[c].frames);
+	}
+	free(j);
+	return error ? -1 : n_frames;
+}
+
+int ltc_decode_parallel(ltcsnd_sample_t *buf, size_t size, int apv, int threads, LTCFrameExt **frames) {
+	return decode_parallel(buf, 0, size, apv, threads, frames);
+}
+
+int ltc_decode_parallel_float(float *buf, size_t size, int apv, int threads, LTCFrameExt **frames) {
+	return decode_parallel(buf, 1, size, apv, threads, frames);
+}
+
+void ltc_frames_free(LTCFrameExt *frames) {
+	free(frames);
 }
 
 /* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -129,33 +762,75 @@ int ltc_decoder_queue_length(LTCDecoder* d) {
  */
 
 LTCEncoder* ltc_encoder_create(double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags) {
-	if (sample_rate < 1)
-		return NULL;
+	return ltc_encoder_create_alloc(NULL, sample_rate, fps, standard, flags);
+}
 
-	LTCEncoder* e = (LTCEncoder*) calloc(1, sizeof(LTCEncoder));
-	if (!e)
+size_t ltc_encoder_size(double sample_rate, double fps) {
+	if (sample_rate < 1 || !(fps > 0))
+		return 0;
+	return MEM_ALIGN(sizeof(LTCEncoder)) + (size_t)(1 + ceil(sample_rate / fps)) * sizeof(ltcsnd_sample_t);
+}
+
+LTCEncoder* ltc_encoder_create_in(void *mem, size_t size, double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags) {
+	LTCEncoder* e = (LTCEncoder*) mem;
+	const size_t need = ltc_encoder_size(sample_rate, fps);
+
+	if (!mem || mem_misaligned(mem) || need == 0 || size < need)
 		return NULL;
 
+	memset(mem, 0, size);
+	e->mem_external = 1;
+
 	/*-3.0 dBFS default */
 	e->enc_lo = 38;
 	e->enc_hi = 218;
+	e->enc_level = pow(10, -3.0 / 20.0);
 
+	/* the buffer follows the encoder in the same block and uses all remaining space */
 	e->bufsize = 1 + ceil(sample_rate / fps);
-	e->buf = (ltcsnd_sample_t*) calloc(e->bufsize, sizeof(ltcsnd_sample_t));
-	if (!e->buf) {
-		free(e);
-		return NULL;
-	}
+	e->buf = (ltcsnd_sample_t*) ((char*)mem + MEM_ALIGN(sizeof(LTCEncoder)));
+	e->buf_alloc = (size - MEM_ALIGN(sizeof(LTCEncoder))) / sizeof(ltcsnd_sample_t);
+	e->buf_inline = 1;
 
 	ltc_frame_reset(&e->f);
 	ltc_encoder_reinit(e, sample_rate, fps, standard, flags);
 	return e;
 }
 
+LTCEncoder* ltc_encoder_create_alloc(const LTCAllocator *allocator, double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags) {
+	const size_t size = ltc_encoder_size(sample_rate, fps);
+	LTCEncoder* e;
+	void* mem;
+
+	if (size == 0)
+		return NULL;
+
+	mem = mem_alloc(allocator, size);
+	if (!mem)
+		return NULL;
+
+	e = ltc_encoder_create_in(mem, size, sample_rate, fps, standard, flags);
+	if (!e) {
+		mem_free(allocator, mem);
+		return NULL;
+	}
+	e->mem_external = 0;
+	if (allocator) {
+		e->mem = *allocator;
+	}
+	return e;
+}
+
 void ltc_encoder_free(LTCEncoder *e) {
+	LTCAllocator mem;
 	if (!e) return;
-	if (e->buf) free(e->buf);
-	free(e);
+	mem = e->mem;
+	if (!e->buf_inline) {
+		mem_free(&mem, e->buf);
+	}
+	if (!e->mem_external) {
+		mem_free(&mem, e);
+	}
 }
 
 int ltc_encoder_reinit(LTCEncoder *e, double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags) {
@@ -163,9 +838,13 @@ int ltc_encoder_reinit(LTCEncoder *e, double sample_rate, double fps, enum LTC_T
 		return -1;
 
 	size_t bufsize = 1 + ceil(sample_rate / fps);
-	if (bufsize > e->bufsize) {
+	if (bufsize > e->buf_alloc) {
 		return -1;
 	}
+	if (bufsize > e->bufsize) {
+		/* use the reserved capacity, see ltc_encoder_reserve */
+		e->bufsize = bufsize;
+	}
 
 	e->state = 0;
 	e->offset = 0;
@@ -177,6 +856,7 @@ int ltc_encoder_reinit(LTCEncoder *e, double sample_rate, double fps, enum LTC_T
 	e->samples_per_clock = sample_rate / (fps * 80.0);
 	e->samples_per_clock_2 = e->samples_per_clock / 2.0;
 	e->sample_remainder = 0.5;
+	encode_stream_reset(e, 0);
 
 	if (flags & LTC_BGF_DONT_TOUCH) {
 		e->f.col_frame = 0;
@@ -207,10 +887,75 @@ int ltc_encoder_reinit(LTCEncoder *e, double sample_rate, double fps, enum LTC_T
 	return 0;
 }
 
+int ltc_encoder_reconfigure(LTCEncoder *e, double sample_rate, double fps) {
+	const double rise_time = e->filter_const > 0 ? ltc_encoder_get_filter(e) : 0;
+	size_t bufsize;
+
+	if (sample_rate < 1 || !(fps > 0))
+		return -1;
+
+	/* keep audio that was not yet read */
+	bufsize = 1 + ceil(sample_rate / fps);
+	if (bufsize < e->offset) {
+		bufsize = e->offset;
+	}
+	if (bufsize > e->buf_alloc) {
+		return -1;
+	}
+	if (bufsize > e->bufsize) {
+		e->bufsize = bufsize;
+	}
+
+	e->sample_rate = sample_rate;
+	e->fps = fps;
+	e->samples_per_clock = sample_rate / (fps * 80.0);
+	e->samples_per_clock_2 = e->samples_per_clock / 2.0;
+	ltc_encoder_set_filter(e, rise_time);
+
+	if ((int)rint(fps * 100.0) == 2997)
+		e->f.dfbit = 1;
+	else
+		e->f.dfbit = 0;
+	if ((e->flags & LTC_NO_PARITY) == 0) {
+		ltc_frame_set_parity(&e->f, e->standard);
+	}
+	return 0;
+}
+
+int ltc_encoder_reserve(LTCEncoder *e, double sample_rate, double fps) {
+	const size_t size = ltc_encoder_size(sample_rate, fps);
+	const size_t alloc = size > 0 ? size - MEM_ALIGN(sizeof(LTCEncoder)) : 0;
+	ltcsnd_sample_t *buf;
+
+	if (size == 0) {
+		return -1;
+	}
+	if (alloc <= e->buf_alloc) {
+		return 0;
+	}
+	if (e->mem_external) {
+		return -1;
+	}
+
+	buf = (ltcsnd_sample_t*) mem_alloc(&e->mem, alloc * sizeof(ltcsnd_sample_t));
+	if (!buf) {
+		return -1;
+	}
+	memcpy(buf, e->buf, e->offset * sizeof(ltcsnd_sample_t));
+	if (!e->buf_inline) {
+		mem_free(&e->mem, e->buf);
+	}
+	e->buf = buf;
+	e->buf_alloc = alloc;
+	e->buf_inline = 0;
+	return 0;
+}
+
 void ltc_encoder_reset(LTCEncoder *e) {
 	e->state = 0;
 	e->sample_remainder = 0.5;
 	e->offset = 0;
+	encode_stream_reset(e, 0);
 }
 
 double ltc_encoder_get_volume(LTCEncoder *e) {
@@ -227,6 +972,8 @@ int ltc_encoder_set_volume(LTCEncoder *e, double dBFS) {
 	ltcsnd_sample_t diff = ((ltcsnd_sample_t) pp)&0x7f;
 	e->enc_lo = SAMPLE_CENTER - diff;
 	e->enc_hi = SAMPLE_CENTER + diff;
+	e->enc_level = pow(10, dBFS/20.0);
+	encoder_update_ramps(e);
 	return 0;
 }
 
@@ -249,16 +996,32 @@ void ltc_encoder_set_filter(LTCEncoder *e, double rise_time) {
 		e->filter_const = 0;
 	else
 		e->filter_const = 1.0 - exp( -1.0 / (e->sample_rate * rise_time / 2000000.0 / exp(1.0)) );
+	encoder_update_ramps(e);
 }
 
 int ltc_encoder_set_buffersize(LTCEncoder *e, double sample_rate, double fps) {
-	free (e->buf);
+	const size_t bufsize = 1 + ceil(sample_rate / fps);
 	e->offset = 0;
-	e->bufsize = 1 + ceil(sample_rate / fps);
-	e->buf = (ltcsnd_sample_t*) calloc(e->bufsize, sizeof(ltcsnd_sample_t));
-	if (!e->buf) {
-		return -1;
+
+	if (bufsize > e->buf_alloc) {
+		ltcsnd_sample_t *buf;
+		if (e->mem_external) {
+			return -1;
+		}
+		buf = (ltcsnd_sample_t*) mem_alloc(&e->mem, bufsize * sizeof(ltcsnd_sample_t));
+		if (!buf) {
+			return -1;
+		}
+		if (!e->buf_inline) {
+			mem_free(&e->mem, e->buf);
+		}
+		e->buf = buf;
+		e->buf_alloc = bufsize;
+		e->buf_inline = 0;
+	} else {
+		memset(e->buf, 0, bufsize * sizeof(ltcsnd_sample_t));
 	}
+	e->bufsize = bufsize;
 	return 0;
 }
 
@@ -288,6 +1051,116 @@ void ltc_encoder_encode_reversed_frame(LTCEncoder *e) {
 	}
 }
 
+int ltc_encoder_encode_frame_varispeed(LTCEncoder *e, double speed_start, double speed_end) {
+	return encode_frame_varispeed(e, speed_start, speed_end);
+}
+
+int ltc_encoder_set_min_speed(LTCEncoder *e, double min_speed) {
+	if (!(min_speed > 0)) {
+		return -1;
+	}
+	if (min_speed > 1) {
+		min_speed = 1;
+	}
+	return ltc_encoder_set_buffersize(e, e->sample_rate, e->fps * min_speed);
+}
+
+static size_t encode_frames(LTCEncoder *e, int n_frames, void *buf, size_t size, enum LTCEncoderFormat fmt) {
+	ltcsnd_sample_t *ibuf = e->buf;
+	const size_t ibufsize = e->bufsize;
+	const size_t ioffset = e->offset;
+	/* upper bound of samples per frame, including fractional remainder */
+	const size_t frame_len = 1 + ceil(e->samples_per_clock * LTC_FRAME_BIT_COUNT);
+	size_t len;
+	int i;
+
+	if (!buf) return 0;
+
+	/* render directly into the caller's buffer,
+	 * addvalues() needs one extra sample of headroom
+	 */
+	if (fmt == LTC_ENC_U8) {
+		e->buf = (ltcsnd_sample_t*) buf;
+	} else {
+		e->out = buf;
+	}
+	e->out_fmt = fmt;
+	e->bufsize = size + 1;
+	e->offset = 0;
+
+	for (i = 0; i < n_frames; ++i) {
+		if (size - e->offset < frame_len) {
+			break;
+		}
+		ltc_encoder_encode_frame(e);
+		ltc_encoder_inc_timecode(e);
+	}
+
+	len = e->offset;
+	e->buf = ibuf;
+	e->bufsize = ibufsize;
+	e->offset = ioffset;
+	e->out_fmt = LTC_ENC_U8;
+	e->out = NULL;
+	return len;
+}
+
+size_t ltc_encoder_encode_frames(LTCEncoder *e, int n_frames, ltcsnd_sample_t *buf, size_t size) {
+	return encode_frames(e, n_frames, buf, size, LTC_ENC_U8);
+}
+
+size_t ltc_encoder_encode_frames_float(LTCEncoder *e, int n_frames, float *buf, size_t size) {
+	return encode_frames(e, n_frames, buf, size, LTC_ENC_FLOAT);
+}
+
+size_t ltc_encoder_encode_frames_s16(LTCEncoder *e, int n_frames, short *buf, size_t size) {
+	return encode_frames(e, n_frames, buf, size, LTC_ENC_S16);
+}
+
+size_t ltc_encoder_encode_frames_s24(LTCEncoder *e, int n_frames, unsigned char *buf, size_t size) {
+	return encode_frames(e, n_frames, buf, size, LTC_ENC_S24);
+}
+
+void ltc_encoder_render_reset(LTCEncoder *e, int align) {
+	ltc_off_t preroll = 0;
+	if (align) {
+		preroll = ltc_frame_alignment(e->samples_per_clock * LTC_FRAME_BIT_COUNT, e->standard);
+	}
+	encode_stream_reset(e, preroll > 0 ? preroll : 0);
+}
+
+void ltc_encoder_render(LTCEncoder *e, ltcsnd_sample_t *buf, size_t n_samples) {
+	encode_stream(e, buf, LTC_ENC_U8, 1, n_samples);
+}
+
+void ltc_encoder_render_float(LTCEncoder *e, float *buf, size_t n_samples) {
+	encode_stream(e, buf, LTC_ENC_FLOAT, 1, n_samples);
+}
+
+void ltc_encoder_render_s16(LTCEncoder *e, short *buf, size_t n_samples) {
+	encode_stream(e, buf, LTC_ENC_S16, 1, n_samples);
+}
+
+void ltc_encoder_render_s24(LTCEncoder *e, unsigned char *buf, size_t n_samples) {
+	encode_stream(e, buf, LTC_ENC_S24, 1, n_samples);
+}
+
+void ltc_encoder_render_interleaved(LTCEncoder *e, ltcsnd_sample_t *buf, int stride, int channel, size_t n_samples) {
+	encode_stream(e, &buf[channel], LTC_ENC_U8, stride, n_samples);
+}
+
+void ltc_encoder_render_interleaved_float(LTCEncoder *e, float *buf, int stride, int channel, size_t n_samples) {
+	encode_stream(e, &buf[channel], LTC_ENC_FLOAT, stride, n_samples);
+}
+
+void ltc_encoder_render_interleaved_s16(LTCEncoder *e, short *buf, int stride, int channel, size_t n_samples) {
+	encode_stream(e, &buf[channel], LTC_ENC_S16, stride, n_samples);
+}
+
+void ltc_encoder_render_interleaved_s24(LTCEncoder *e, unsigned char *buf, int stride, int channel, size_t n_samples) {
+	encode_stream(e, &buf[3 * channel], LTC_ENC_S24, stride, n_samples);
+}
+
 void ltc_encoder_get_timecode(LTCEncoder *e, SMPTETimecode *t) {
 	ltc_frame_to_time(t, &e->f, e->flags);
 }
@@ -383,6 +1256,81 @@ int ltc_encoder_get_buffer(LTCEncoder *e, ltcsnd_sample_t *buf) {
 	return ltc_encoder_copy_buffer(e, buf);
 }
 
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Encoder bank
+ */
+
+LTCEncoderBank* ltc_encoder_bank_create(int channels, double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags) {
+	LTCEncoderBank* b;
+	int c;
+
+	if (channels < 1) return NULL;
+
+	b = (LTCEncoderBank*) calloc(1, sizeof(LTCEncoderBank));
+	if (!b) return NULL;
+
+	b->channels = channels;
+	b->encoders = (LTCEncoder**) calloc(channels, sizeof(LTCEncoder*));
+	if (!b->encoders) {
+		free(b);
+		return NULL;
+	}
+
+	for (c = 0; c < channels; ++c) {
+		b->encoders[c] = ltc_encoder_create(sample_rate, fps, standard, flags);
+		if (!b->encoders[c]) {
+			ltc_encoder_bank_free(b);
+			return NULL;
+		}
+	}
+	return b;
+}
+
+void ltc_encoder_bank_free(LTCEncoderBank *b) {
+	int c;
+	if (!b) return;
+	for (c = 0; c < b->channels; ++c) {
+		ltc_encoder_free(b->encoders[c]);
+	}
+	free(b->encoders);
+	free(b);
+}
+
+int ltc_encoder_bank_channels(LTCEncoderBank *b) {
+	return b->channels;
+}
+
+LTCEncoder* ltc_encoder_bank_encoder(LTCEncoderBank *b, int channel) {
+	if (channel < 0 || channel >= b->channels) return NULL;
+	return b->encoders[channel];
+}
+
+/* The buffer is traversed once, in blocks of LTC_BANK_BLOCK audio-frames.
+ * All channels of a block are rendered while it is in cache, each encoder
+ * resumes its current edge at the start of the block.
+ */
+#define LTC_BANK_BLOCK 256
+
+#define ENCODER_BANK_RENDER(FN, FORMAT, FMT, SIZE) \
+void ltc_encoder_bank_render ## FN (LTCEncoderBank *b, FORMAT *buf, size_t n_samples) { \
+	size_t off; \
+	int c; \
+	for (off = 0; off < n_samples; off += LTC_BANK_BLOCK) { \
+		const size_t n = n_samples - off < LTC_BANK_BLOCK ? n_samples - off : LTC_BANK_BLOCK; \
+		FORMAT *block = &buf[SIZE * off * b->channels]; \
+		for (c = 0; c < b->channels; ++c) { \
+			encode_stream(b->encoders[c], &block[SIZE * c], FMT, b->channels, n); \
+		} \
+	} \
+}
+
+ENCODER_BANK_RENDER(, ltcsnd_sample_t, LTC_ENC_U8, 1)
+ENCODER_BANK_RENDER(_float, float, LTC_ENC_FLOAT, 1)
+ENCODER_BANK_RENDER(_s16, short, LTC_ENC_S16, 1)
+ENCODER_BANK_RENDER(_s24, unsigned char, LTC_ENC_S24, 3)
+
+#undef ENCODER_BANK_RENDER
+
 void ltc_frame_set_parity(LTCFrame *frame, enum LTC_TV_STANDARD standard) {
 	int i;
 	unsigned char p = 0;
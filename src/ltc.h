@@ -267,6 +267,55 @@ enum LTC_TV_STANDARD {
 	LTC_TV_FILM_24 ///< 24fps
 };
 
+/** decoder flags, see \ref ltc_decoder_create_ex */
+enum LTC_DECODER_FLAGS {
+	LTC_DECODER_COMPACT = 1, ///< queue \ref LTCFrameCompact records, biphase timing is not retained per frame
+	LTC_DECODER_EARLY = 2, ///< report provisional frames before the sync word is received, see \ref ltc_decoder_read_early
+	LTC_DECODER_AUTODETECT = 4, ///< estimate the bit period from the signal at startup and after silence, see \ref ltc_decoder_detect
+	LTC_DECODER_MATCHED = 8, ///< correlate the input with the biphase pulse before level detection, for noisy or band-limited signals, see \ref ltc_decoder_create_ex
+	LTC_DECODER_TICS = 16 ///< with LTC_DECODER_COMPACT, keep the biphase timing of queued frames, see \ref ltc_decoder_peek_tics
+};
+
+/** status of a \ref LTCFrameEarly event */
+enum LTC_EARLY_STATUS {
+	LTC_EARLY_PROVISIONAL = 1, ///< the 64 data bits of a frame are received, a plausible frame with valid parity
+	LTC_EARLY_CONFIRMED = 2, ///< the sync word of the provisional frame was received, the frame is also queued as usual
+	LTC_EARLY_RETRACTED = 3 ///< the provisional frame was not completed (no sync word, signal lost)
+};
+
+/**
+ * flags for \ref ltc_file_decoder_open
+ */
+enum LTC_FILE_FLAGS {
+	LTC_FILE_RAW = 1, ///< do not parse a header, the file is headerless unsigned 8 bit mono audio
+	LTC_FILE_NO_MMAP = 2 ///< read the file into a buffer instead of memory-mapping it
+};
+
+/**
+ * status flags returned by \ref ltc_tracker_update and \ref ltc_tracker_status
+ */
+enum LTC_TRACKER_STATUS {
+	LTC_TRACKER_LOCKED = 1, ///< the tracker has followed a number of consecutive frames, the estimate is valid
+	LTC_TRACKER_DROPOUT = 2, ///< one or more frames are missing
+	LTC_TRACKER_JUMP = 4 ///< the timecode is discontinuous or the direction changed, the tracker re-locks
+};
+
+/**
+ * flags for \ref ltc_publisher_create
+ */
+enum LTC_PUBLISHER_FLAGS {
+	LTC_PUBLISHER_REPLACE = 1 ///< replace an existing shared memory object of the same name, e.g. left by a publisher that crashed
+};
+
+/** version of the frame serialization format, see \ref ltc_frames_pack */
+#define LTC_PACKET_VERSION 1
+
+/** optional fields of serialized frames, see \ref ltc_frames_pack */
+enum LTC_PACKET_FIELDS {
+	LTC_PACKET_OFFSETS = 1, ///< off_start and off_end
+	LTC_PACKET_QUALITY = 2 ///< sample_min, sample_max and volume (as 32 bit float)
+};
+
 /** encoder and LTCframe <> timecode operation flags */
 enum LTC_BG_FLAGS {
 	LTC_USE_DATE  = 1, ///< LTCFrame <> SMPTETimecode converter and LTCFrame increment/decrement use date, also set BGF2 to '1' when encoder is initialized or re-initialized (unless LTC_BGF_DONT_TOUCH is given)
@@ -312,6 +361,68 @@ struct LTCFrameExt {
  */
 typedef struct LTCFrameExt LTCFrameExt;
 
+/**
+ * Compact variant of \ref LTCFrameExt without the biphase timing array.
+ * see \ref ltc_decoder_read_compact and \ref LTC_DECODER_COMPACT
+ */
+struct LTCFrameCompact {
+	LTCFrame ltc; ///< the actual LTC frame. see \ref LTCFrame
+	ltc_off_t off_start; ///< the approximate sample in the stream corresponding to the start of the LTC frame, see \ref off_start
+	ltc_off_t off_end; ///< the sample in the stream corresponding to the end of the LTC frame, see \ref off_end
+	int reverse; ///< if non-zero, a reverse played LTC frame was detected, see \ref LTCFrameExt
+	ltcsnd_sample_t sample_min; ///< the minimum input sample signal for this frame (0..255)
+	ltcsnd_sample_t sample_max; ///< the maximum input sample signal for this frame (0..255)
+	double volume; ///< the volume of the input signal in dbFS
+};
+
+/**
+ * see \ref LTCFrameCompact
+ */
+typedef struct LTCFrameCompact LTCFrameCompact;
+
+/**
+ * Early frame event, see \ref LTC_DECODER_EARLY and \ref ltc_decoder_read_early
+ *
+ * A provisional frame is reported as soon as its timecode bits are known,
+ * about a fifth of a frame before the frame is complete.
+ * It is followed by a confirmation or retraction of the same frame.
+ */
+struct LTCFrameEarly {
+	LTCFrame ltc; ///< the LTC frame, including the expected sync word
+	ltc_off_t off_start; ///< the approximate sample in the stream corresponding to the start of the LTC frame, see \ref off_start
+	ltc_off_t off_end; ///< the end of the LTC frame; for provisional frames this is extrapolated
+	ltc_off_t off_event; ///< the sample in the stream at which the event was detected
+	int status; ///< see \ref LTC_EARLY_STATUS
+};
+
+/**
+ * see \ref LTCFrameEarly
+ */
+typedef struct LTCFrameEarly LTCFrameEarly;
+
+/**
+ * Decoder statistics, see \ref ltc_decoder_stats
+ *
+ * All counters start at zero when the decoder is created
+ * and can be reset with \ref ltc_decoder_stats_reset.
+ */
+struct LTCDecoderStats {
+	unsigned long long samples; ///< number of audio samples that were processed
+	unsigned long long edges; ///< number of detected signal transitions (biphase state changes)
+	unsigned long long bits; ///< number of decoded bits
+	unsigned long long frames; ///< number of complete frames, forward and reverse (including frames dropped by queue overruns)
+	unsigned long long frames_reverse; ///< number of complete frames decoded in reverse direction
+	unsigned long long sync_errors; ///< a sync-word was found, but not after 80 bits (incomplete frame)
+	unsigned long long bit_overflows; ///< bits that were discarded, because no sync-word followed the 80th bit
+	unsigned long long silence_resets; ///< the bit-parser was reset after a long period without a transition
+	unsigned long long overruns; ///< frames that were dropped because the queue was full, see \ref ltc_decoder_queue_overruns
+};
+
+/**
+ * see \ref LTCDecoderStats
+ */
+typedef struct LTCDecoderStats LTCDecoderStats;
+
 /**
  * Human readable time representation, decimal values.
  */
@@ -330,185 +441,1181 @@ struct SMPTETimecode {
 /**
  * see \ref SMPTETimecode
  */
-typedef struct SMPTETimecode SMPTETimecode;
-
+typedef struct SMPTETimecode SMPTETimecode;
+
+
+/**
+ * Opaque structure
+ * see: \ref ltc_decoder_create, \ref ltc_decoder_free
+ */
+typedef struct LTCDecoder LTCDecoder;
+
+/**
+ * Opaque structure
+ * see: \ref ltc_decoder_bank_create, \ref ltc_decoder_bank_free
+ */
+typedef struct LTCDecoderBank LTCDecoderBank;
+
+/**
+ * Opaque structure
+ * see: \ref ltc_encoder_create, \ref ltc_encoder_free
+ */
+typedef struct LTCEncoder LTCEncoder;
+
+/**
+ * Opaque structure
+ * see: \ref ltc_encoder_bank_create, \ref ltc_encoder_bank_free
+ */
+typedef struct LTCEncoderBank LTCEncoderBank;
+
+/**
+ * Opaque structure
+ * see: \ref ltc_file_decoder_open, \ref ltc_file_decoder_close
+ */
+typedef struct LTCFileDecoder LTCFileDecoder;
+
+/**
+ * Opaque structure
+ * see: \ref ltc_index_create, \ref ltc_index_free
+ */
+typedef struct LTCIndex LTCIndex;
+
+/**
+ * Opaque structure
+ * see: \ref ltc_tracker_create, \ref ltc_tracker_free
+ */
+typedef struct LTCTracker LTCTracker;
+
+/**
+ * Opaque structure
+ * see: \ref ltc_publisher_create, \ref ltc_publisher_free
+ */
+typedef struct LTCPublisher LTCPublisher;
+
+/**
+ * Opaque structure
+ * see: \ref ltc_subscriber_open, \ref ltc_subscriber_close
+ */
+typedef struct LTCSubscriber LTCSubscriber;
+
+/**
+ * Memory allocator callbacks, see \ref ltc_decoder_create_alloc and \ref ltc_encoder_create_alloc
+ *
+ * The callbacks are used for all memory of the object, also for later
+ * allocations (e.g. \ref ltc_encoder_set_buffersize) and to release it
+ * with \ref ltc_decoder_free or \ref ltc_encoder_free.
+ */
+struct LTCAllocator {
+	void* (*alloc)(void* arg, size_t size); ///< return memory suitably aligned for any type, or NULL; it does not need to be cleared
+	void (*free)(void* arg, void* ptr); ///< release memory, may be NULL (e.g. for an arena that is released as a whole)
+	void* arg; ///< passed to the callbacks
+};
+
+/**
+ * see \ref LTCAllocator
+ */
+typedef struct LTCAllocator LTCAllocator;
+
+/**
+ * Checkpoint of a \ref LTCIndex
+ *
+ * Each checkpoint covers a run of consecutive frames, starting with the frame
+ * given here. During reverse playback the frame-numbers decrease.
+ */
+struct LTCIndexEntry {
+	LTCFrame ltc; ///< the first frame of the run
+	ltc_off_t off_start; ///< the first sample of the first frame
+	ltc_off_t off_end; ///< the last sample of the first frame
+	int n_frames; ///< number of consecutive frames in the run
+	int reverse; ///< the run was decoded in reverse direction
+	int discontinuity; ///< the first frame does not continue the previous frame (jump, dropout or change of direction)
+};
+
+/**
+ * see \ref LTCIndexEntry
+ */
+typedef struct LTCIndexEntry LTCIndexEntry;
+
+/**
+ * Convert binary LTCFrame into SMPTETimecode struct
+ *
+ * @param stime output
+ * @param frame input
+ * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE is relevant.
+ * if LTC_USE_DATE is set, the user-fields in LTCFrame will be parsed into the date variable of SMPTETimecode.
+ * otherwise the date information in the SMPTETimecode is set to zero.
+ */
+void ltc_frame_to_time(SMPTETimecode* stime, LTCFrame* frame, int flags);
+
+/**
+ * Translate SMPTETimecode struct into its binary LTC representation
+ * and set the LTC frame's parity bit accordingly (see \ref ltc_frame_set_parity)
+ *
+ * @param frame output - the frame to be set
+ * @param stime input - timecode input
+ * @param standard the TV standard to use for parity bit assignment
+ * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE and LTC_NO_PARITY are relevant.
+ * if LTC_USE_DATE is given, user-fields in LTCFrame will be set from the date in SMPTETimecode,
+ * otherwise the user-bits are not modified. All non-timecode fields remain untouched - except for the parity bit
+ * unless LTC_NO_PARITY is given.
+ */
+void ltc_time_to_frame(LTCFrame* frame, SMPTETimecode* stime, enum LTC_TV_STANDARD standard, int flags);
+
+/**
+ * Convert an array of binary LTCFrames into SMPTETimecode structs.
+ * This is equivalent to calling \ref ltc_frame_to_time for each frame.
+ *
+ * @param stimes output, array of at least count elements
+ * @param frames input, array of count frames
+ * @param count number of frames to convert
+ * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE is relevant.
+ */
+void ltc_frames_to_time(SMPTETimecode* stimes, LTCFrame* frames, int count, int flags);
+
+/**
+ * Translate an array of SMPTETimecode structs into LTCFrames.
+ * This is equivalent to calling \ref ltc_time_to_frame for each timecode.
+ *
+ * @param frames output, array of at least count frames to be set
+ * @param stimes input, array of count timecodes
+ * @param count number of timecodes to convert
+ * @param standard the TV standard to use for parity bit assignment
+ * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE and LTC_NO_PARITY are relevant.
+ */
+void ltc_time_to_frames(LTCFrame* frames, SMPTETimecode* stimes, int count, enum LTC_TV_STANDARD standard, int flags);
+
+/**
+ * length of the string written by \ref ltc_frame_to_string, excluding the terminating zero.
+ */
+#define LTC_TIMECODE_STRLEN 11
+
+/**
+ * Format the timecode of a LTCFrame as fixed-width "HH:MM:SS:FF" string.
+ * For drop-frame timecode the last separator is a dot: "HH:MM:SS.FF".
+ *
+ * This function does not use stdio and is safe to call from realtime context.
+ *
+ * @param buf output, at least LTC_TIMECODE_STRLEN + 1 bytes, the string is zero terminated
+ * @param frame input
+ * @return number of characters written, excluding the terminating zero (LTC_TIMECODE_STRLEN)
+ */
+int ltc_frame_to_string(char* buf, LTCFrame* frame);
+
+/**
+ * Reset all values of a LTC FRAME to zero, except for the sync-word (0x3FFD) at the end.
+ * The sync word is set according to architecture (big/little endian).
+ * Also set the Frame's parity bit accordingly (see \ref ltc_frame_set_parity)
+ * @param frame the LTCFrame to reset
+ */
+void ltc_frame_reset(LTCFrame* frame);
+
+/**
+ * Increment the timecode by one Frame (1/framerate seconds)
+ * and set the Frame's parity bit accordingly (see \ref ltc_frame_set_parity)
+ *
+ * @param frame the LTC-timecode to increment
+ * @param fps integer framerate (for drop-frame-timecode set frame->dfbit and round-up the fps).
+ * @param standard the TV standard to use for parity bit assignment
+ * if set to 1 the 25fps standard is enabled and LTC Frame bit 59 instead of 27 is used for the parity. It only has only has effect flag bit 4 (LTC_NO_PARITY) is cleared.
+ * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE and LTC_NO_PARITY are relevant.
+ * If the bit 0 (1) is set (1) interpret user-data as date and increment date if timecode wraps after 24h.
+ * (Note: leap-years are taken into account, but since the year is two-digit only, the 100,400yr rules are ignored.
+ * "00" is assumed to be year 2000 which was a leap year.)
+ * @return 1 if timecode was wrapped around after 23:59:59:ff, 0 otherwise
+ */
+int ltc_frame_increment(LTCFrame* frame, int fps, enum LTC_TV_STANDARD standard, int flags);
+
+/**
+ * Decrement the timecode by one Frame (1/framerate seconds)
+ * and set the Frame's parity bit accordingly (see \ref ltc_frame_set_parity)
+ *
+ * @param frame the LTC-timecode to decrement
+ * @param fps integer framerate (for drop-frame-timecode set frame->dfbit and round-up the fps).
+ * @param standard the TV standard to use for parity bit assignment
+ * if set to 1 the 25fps standard is enabled and LTC Frame bit 59 instead of 27 is used for the parity. It only has only has effect flag bit 4 (LTC_NO_PARITY) is cleared.
+ * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE and LTC_NO_PARITY are relevant.
+ * if the bit 0 is set (1) interpret user-data as date and decrement date if timecode wraps at 24h.
+ * (Note: leap-years are taken into account, but since the year is two-digit only, the 100,400yr rules are ignored.
+ * "00" is assumed to be year 2000 which was a leap year.)
+ * bit 3 (8) indicates that the parity bit should not be touched
+ * @return 1 if timecode was wrapped around at 23:59:59:ff, 0 otherwise
+ */
+int ltc_frame_decrement(LTCFrame* frame, int fps, enum LTC_TV_STANDARD standard, int flags);
+
+/**
+ * Calculate the frame-number of the timecode, counting frames since 00:00:00:00.
+ *
+ * For drop-frame timecode (frame->dfbit is set) the skipped frame numbers
+ * are not counted, so the index is an actual count of frames.
+ * The date (user-bits) is not taken into account.
+ *
+ * @param frame the LTC-timecode
+ * @param fps integer framerate (for drop-frame-timecode set frame->dfbit and round-up the fps).
+ * @return frame index, 0 <= index < frames per 24h
+ */
+ltc_off_t ltc_frame_to_index(LTCFrame* frame, int fps);
+
+/**
+ * Set the timecode to a given frame-number, the inverse of \ref ltc_frame_to_index.
+ * The index wraps around at 24h (negative values count from 24:00:00:00),
+ * the date is not modified.
+ *
+ * @param frame the LTC-timecode to set; frame->dfbit selects drop-frame timecode
+ * @param index frame-number since 00:00:00:00
+ * @param fps integer framerate (for drop-frame-timecode set frame->dfbit and round-up the fps).
+ * @param standard the TV standard to use for parity bit assignment
+ * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_NO_PARITY is relevant.
+ */
+void ltc_index_to_frame(LTCFrame* frame, ltc_off_t index, int fps, enum LTC_TV_STANDARD standard, int flags);
+
+/**
+ * Advance or rewind the timecode by a number of frames in constant time.
+ *
+ * This is equivalent to calling \ref ltc_frame_increment (or
+ * \ref ltc_frame_decrement for negative values) n_frames times, including
+ * drop-frame timecode and the date (by whole days) if LTC_USE_DATE is given.
+ *
+ * @param frame the LTC-timecode to modify
+ * @param n_frames number of frames to advance, negative values rewind
+ * @param fps integer framerate (for drop-frame-timecode set frame->dfbit and round-up the fps).
+ * @param standard the TV standard to use for parity bit assignment
+ * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE and LTC_NO_PARITY are relevant.
+ * @return 1 if timecode wrapped around at 24h, 0 otherwise, -1 if LTC_USE_DATE
+ * was given and the date is invalid (the date is then not modified)
+ */
+int ltc_frame_advance(LTCFrame* frame, ltc_off_t n_frames, int fps, enum LTC_TV_STANDARD standard, int flags);
+
+/**
+ * Create a new LTC decoder.
+ *
+ * @param apv audio-frames per video frame. This is just used for initial settings, the speed is tracked dynamically. setting this in the right ballpark is needed to properly decode the first LTC frame in a sequence.
+ * @param queue_size length of the internal queue to store decoded frames
+ * to SMPTEDecoderWrite.
+ * @return decoder handle or NULL if out-of-memory
+ */
+LTCDecoder * ltc_decoder_create(int apv, int queue_size);
+
+/**
+ * Create a new LTC decoder with additional options.
+ *
+ * With \ref LTC_DECODER_COMPACT the queue holds \ref LTCFrameCompact records,
+ * this reduces the memory footprint of the queue to about an eighth.
+ * Frames are best retrieved with \ref ltc_decoder_read_compact,
+ * \ref ltc_decoder_read still works but leaves the LTCFrameExt biphase_tics zeroed.
+ * Adding \ref LTC_DECODER_TICS retains the timing in a separate array, which
+ * is accessed with \ref ltc_decoder_peek_tics (and copied by \ref ltc_decoder_read).
+ *
+ * With \ref LTC_DECODER_MATCHED the input is filtered with a moving
+ * average over half a bit period (tracked like the bit period itself)
+ * before the level detection. This matched filter greatly improves
+ * decoding of LTC with broadband noise, or after lossy audio codecs and
+ * RF transmission, at less than twice the CPU cost. Frame offsets account for
+ * the filter delay. LTCFrameExt::volume and the sample_min/max
+ * values then describe the filtered signal, which is lower than the input
+ * level for noisy signals. A \ref LTCDecoderBank does not use the filter.
+ *
+ * @param apv audio-frames per video frame, see \ref ltc_decoder_create
+ * @param queue_size length of the internal queue to store decoded frames
+ * @param flags binary combination of \ref LTC_DECODER_FLAGS
+ * @return decoder handle or NULL if out-of-memory
+ */
+LTCDecoder * ltc_decoder_create_ex(int apv, int queue_size, int flags);
+
+/**
+ * Calculate the memory needed for a decoder, see \ref ltc_decoder_create_in.
+ *
+ * @param queue_size length of the internal queue to store decoded frames
+ * @param flags binary combination of \ref LTC_DECODER_FLAGS
+ * @return size in bytes
+ */
+size_t ltc_decoder_size(int queue_size, int flags);
+
+/**
+ * Create a decoder in caller-provided memory.
+ * The decoder does not allocate memory, \ref ltc_decoder_free
+ * does nothing, the memory can be reused once the decoder is no longer used.
+ *
+ * @param mem memory for the decoder, aligned for any type (e.g. from malloc)
+ * @param size size of mem, at least \ref ltc_decoder_size bytes
+ * @param apv audio-frames per video frame, see \ref ltc_decoder_create
+ * @param queue_size length of the internal queue to store decoded frames
+ * @param flags binary combination of \ref LTC_DECODER_FLAGS
+ * @return decoder handle (equal to mem) or NULL if the memory is too small or not aligned
+ */
+LTCDecoder * ltc_decoder_create_in(void *mem, size_t size, int apv, int queue_size, int flags);
+
+/**
+ * Create a decoder using custom memory allocation.
+ * The decoder is allocated as a single block of \ref ltc_decoder_size bytes.
+ *
+ * @param allocator the allocator callbacks, they are copied; NULL uses the standard library
+ * @param apv audio-frames per video frame, see \ref ltc_decoder_create
+ * @param queue_size length of the internal queue to store decoded frames
+ * @param flags binary combination of \ref LTC_DECODER_FLAGS
+ * @return decoder handle or NULL if out-of-memory
+ */
+LTCDecoder * ltc_decoder_create_alloc(const LTCAllocator *allocator, int apv, int queue_size, int flags);
+
+
+/**
+ * Change the decoder's nominal audio-frames per video frame in place,
+ * e.g. after a sample-rate switch. No memory is allocated.
+ *
+ * The frame that is currently being decoded is discarded, but frames in
+ * the queue, statistics and decoder flags are kept.
+ * With \ref LTC_DECODER_AUTODETECT, detection is restarted and apv may be 0.
+ *
+ * @param d decoder handle
+ * @param apv audio-frames per video frame, see \ref ltc_decoder_create
+ * @return 0 on success, -1 if apv is invalid
+ */
+int ltc_decoder_reconfigure(LTCDecoder *d, int apv);
+
+/**
+ * Release memory of decoder.
+ * @param d decoder handle
+ */
+int ltc_decoder_free(LTCDecoder *d);
+
+/**
+ * Feed the LTC decoder with new audio samples.
+ *
+ * Parse raw audio for LTC timestamps. Once a complete LTC frame has been
+ * decoded it is pushed into a queue (\ref ltc_decoder_read)
+ *
+ * @param d decoder handle
+ * @param buf pointer to ltcsnd_sample_t - unsigned 8 bit mono audio data
+ * @param size size number of samples to parse
+ * @param posinfo (optional, recommended) sample-offset in the audio-stream. It is added to \ref off_start, \ref off_end in \ref LTCFrameExt and should be monotonic (ie incremented by \p size for every call to ltc_decoder_write)
+ */
+void ltc_decoder_write(LTCDecoder *d,
+		ltcsnd_sample_t *buf, size_t size,
+		ltc_off_t posinfo);
+
+/**
+ * Variant of \ref ltc_decoder_write that accepts 64-bit floating point
+ * audio samples. The samples are decoded natively, without intermediate
+ * conversion to 8 bit. The signal envelope is tracked at full resolution,
+ * signals below -60 dBFS are treated as silence.
+ *
+ * @param d decoder handle
+ * @param buf pointer to audio sample data
+ * @param size number of samples to parse
+ * @param posinfo (optional, recommended) sample-offset in the audio-stream.
+ */
+void ltc_decoder_write_double(LTCDecoder *d, double *buf, size_t size, ltc_off_t posinfo);
+
+/**
+ * Variant of \ref ltc_decoder_write that accepts 32-bit floating point
+ * audio samples. The samples are decoded natively, without intermediate
+ * conversion to 8 bit. The signal envelope is tracked at full resolution,
+ * signals below -60 dBFS are treated as silence.
+ *
+ * @param d decoder handle
+ * @param buf pointer to audio sample data
+ * @param size number of samples to parse
+ * @param posinfo (optional, recommended) sample-offset in the audio-stream.
+ */
+void ltc_decoder_write_float(LTCDecoder *d, float *buf, size_t size, ltc_off_t posinfo);
+
+/**
+ * Variant of \ref ltc_decoder_write that accepts signed 16 bit
+ * audio samples. The samples are decoded natively, without intermediate
+ * conversion to 8 bit. The signal envelope is tracked at full resolution,
+ * signals below -60 dBFS are treated as silence.
+ *
+ * @param d decoder handle
+ * @param buf pointer to audio sample data
+ * @param size number of samples to parse
+ * @param posinfo (optional, recommended) sample-offset in the audio-stream.
+ */
+void ltc_decoder_write_s16(LTCDecoder *d, short *buf, size_t size, ltc_off_t posinfo);
+
+/**
+ * Variant of \ref ltc_decoder_write that accepts unsigned 16 bit
+ * audio samples. The samples are decoded natively, without intermediate
+ * conversion to 8 bit. The signal envelope is tracked at full resolution,
+ * signals below -60 dBFS are treated as silence.
+ *
+ * @param d decoder handle
+ * @param buf pointer to audio sample data
+ * @param size number of samples to parse
+ * @param posinfo (optional, recommended) sample-offset in the audio-stream.
+ */
+void ltc_decoder_write_u16(LTCDecoder *d, unsigned short *buf, size_t size, ltc_off_t posinfo);
+
+/**
+ * Decoded LTC frames are placed in a queue. This function retrieves
+ * a frame from the queue, and stores it at LTCFrameExt*
+ *
+ * The queue is lock-free: a single thread may call ltc_decoder_write()
+ * (or any of its variants) while another single thread concurrently
+ * reads frames, without additional locking.
+ *
+ * @param d decoder handle
+ * @param frame the decoded LTC frame is copied there
+ * @return 1 on success or 0 when no frames queued.
+ */
+int ltc_decoder_read(LTCDecoder *d, LTCFrameExt *frame);
+
+/**
+ * Variant of \ref ltc_decoder_read that retrieves a compact frame
+ * record, without the biphase timing array.
+ * This works regardless of \ref LTC_DECODER_COMPACT, but avoids all copies
+ * of timing information if the flag is given.
+ *
+ * @param d decoder handle
+ * @param frame the decoded LTC frame is copied there
+ * @return 1 on success or 0 when no frames queued.
+ */
+int ltc_decoder_read_compact(LTCDecoder *d, LTCFrameCompact *frame);
+
+/**
+ * Retrieve an early frame event, for decoders that are created with
+ * \ref LTC_DECODER_EARLY.
+ *
+ * Forward playing frames are reported as \ref LTC_EARLY_PROVISIONAL after
+ * 64 bits, if the previous frame was decoded and the timecode digits
+ * and the parity bit (either TV standard) are valid. Signals that do not
+ * set the parity bit are not reported early.
+ * When the frame completes, a \ref LTC_EARLY_CONFIRMED event follows and the frame is
+ * queued as usual (see \ref ltc_decoder_read), otherwise it is \ref LTC_EARLY_RETRACTED.
+ *
+ * Events are kept in a separate small queue, which is lock-free like the frame queue.
+ * If it is full, new events are discarded.
+ *
+ * @param d decoder handle
+ * @param frame the event is copied there
+ * @return 1 on success or 0 when no events are queued.
+ */
+int ltc_decoder_read_early(LTCDecoder *d, LTCFrameEarly *frame);
+
+/**
+ * Access decoded frames in-place, without copying them.
+ *
+ * The returned frames remain valid until they are released with
+ * \ref ltc_decoder_consume. Since the queue is a ring-buffer only
+ * frames in contiguous memory are returned; after consuming them,
+ * a subsequent call returns the frames that wrapped around.
+ *
+ * Note that the decoder may add frames concurrently, but never
+ * modifies frames that have not been consumed.
+ *
+ * @param d decoder handle
+ * @param frames pointer to the oldest queued frame is stored there (NULL if none)
+ * @return number of frames available at *frames, or -1 if the decoder
+ * was created with \ref LTC_DECODER_COMPACT
+ */
+int ltc_decoder_peek(LTCDecoder *d, const LTCFrameExt **frames);
+
+/**
+ * Variant of \ref ltc_decoder_peek for decoders that are created
+ * with \ref LTC_DECODER_COMPACT.
+ *
+ * @param d decoder handle
+ * @param frames pointer to the oldest queued frame is stored there (NULL if none)
+ * @return number of frames available at *frames, or -1 if the decoder
+ * was not created with \ref LTC_DECODER_COMPACT
+ */
+int ltc_decoder_peek_compact(LTCDecoder *d, const LTCFrameCompact **frames);
+
+/**
+ * Remove frames from the queue, after they were processed in-place
+ * (see \ref ltc_decoder_peek).
+ *
+ * @param d decoder handle
+ * @param n number of frames to remove, oldest first
+ * @return number of frames removed (limited to \ref ltc_decoder_queue_length)
+ */
+int ltc_decoder_consume(LTCDecoder *d, int n);
+
+/**
+ * Retrieve the bit timing of a queued frame, the biphase_tics of
+ * \ref LTCFrameExt, without removing the frame from the queue.
+ *
+ * Frames are addressed by queue position, 0 is the frame that
+ * \ref ltc_decoder_read_compact or \ref ltc_decoder_peek_compact returns next.
+ * Compact decoders must be created with \ref LTC_DECODER_TICS.
+ *
+ * Like \ref ltc_decoder_peek this must be called from the thread that reads
+ * frames, the timing of queued frames is not modified by the decoder.
+ *
+ * @param d decoder handle
+ * @param i queue position, 0 <= i < \ref ltc_decoder_queue_length
+ * @param tics array of \ref LTC_FRAME_BIT_COUNT elements to receive the bit timing
+ * @return 0 on success, -1 if there is no frame at the position or the
+ * decoder does not retain the timing
+ */
+int ltc_decoder_peek_tics(LTCDecoder *d, int i, float *tics);
+
+/**
+ * Remove all LTC frames from the internal queue.
+ *
+ * This must only be called from the thread that reads frames.
+ * @param d decoder handle
+ */
+void ltc_decoder_queue_flush(LTCDecoder* d);
+
+/**
+ * Count number of LTC frames currently in the queue.
+ * @param d decoder handle
+ * @return number of queued frames
+ */
+int ltc_decoder_queue_length(LTCDecoder* d);
+
+/**
+ * Count number of LTC frames that were dropped because the queue was full.
+ *
+ * If the queue is full when a new frame is decoded, the new frame is
+ * discarded; queued frames are never overwritten.
+ * @param d decoder handle
+ * @return number of dropped frames since the decoder was created
+ */
+unsigned int ltc_decoder_queue_overruns(LTCDecoder* d);
+
+/**
+ * Retrieve a snapshot of the decoder statistics.
+ *
+ * The counters are updated by \ref ltc_decoder_write and friends without
+ * synchronization. This function has to be called from the thread that
+ * writes audio to the decoder (or when no write is in progress).
+ *
+ * @param d decoder handle
+ * @param stats the current counters are copied there
+ */
+void ltc_decoder_stats(LTCDecoder* d, LTCDecoderStats* stats);
+
+/**
+ * Reset all statistics counters to zero.
+ * The same threading restrictions as for \ref ltc_decoder_stats apply.
+ * This does not affect \ref ltc_decoder_queue_overruns.
+ *
+ * @param d decoder handle
+ */
+void ltc_decoder_stats_reset(LTCDecoder* d);
+
+/**
+ * Query the signal parameters found by auto-detection, for decoders
+ * that are created with \ref LTC_DECODER_AUTODETECT.
+ *
+ * The bit period is estimated from a histogram of the first transition
+ * intervals, independent of the apv given to \ref ltc_decoder_create_ex
+ * (which may be 0). This is repeated after a silence (e.g. a source switch).
+ * The framerate is counted from the timecode, once a second-boundary
+ * was decoded. Until then, and to tell 30000/1001 from 30 fps non-drop-frame
+ * (or 24000/1001 from 24), the measured frame duration is used if the
+ * sample rate is known.
+ *
+ * The same threading restrictions as for \ref ltc_decoder_stats apply.
+ *
+ * @param d decoder handle
+ * @param sample_rate audio sample rate, or 0 if it is not known
+ * @param fps the detected framerate is stored there (24, 25, 30, 30000/1001, ...)
+ * @param drop_frame if not NULL, the drop-frame flag of the last decoded frame is stored there
+ * @return 2 if the framerate was counted from the timecode, 1 if it was estimated
+ * from the signal and the sample rate only, 0 if no framerate is known (yet)
+ */
+int ltc_decoder_detect(LTCDecoder* d, double sample_rate, double* fps, int* drop_frame);
+
+/**
+ * Allocate a bank of LTC decoders, one per audio channel.
+ *
+ * A decoder bank decodes multiple independent LTC streams of a
+ * multi-channel audio stream in a single pass. The level detectors
+ * of all channels are kept together and are processed sample by sample
+ * across channels; each channel has its own frame queue.
+ *
+ * @param channels number of audio channels
+ * @param apv audio-frames per video frame, see \ref ltc_decoder_create
+ * @param queue_size length of the per channel frame queue
+ * @return decoder bank handle or NULL if out-of-memory
+ */
+LTCDecoderBank* ltc_decoder_bank_create(int channels, int apv, int queue_size);
+
+/**
+ * Release memory of a decoder bank.
+ * @param b decoder bank handle
+ */
+int ltc_decoder_bank_free(LTCDecoderBank *b);
+
+/**
+ * @param b decoder bank handle
+ * @return number of channels of the bank
+ */
+int ltc_decoder_bank_channels(LTCDecoderBank *b);
+
+/**
+ * Decode the channels of the bank using a pool of worker threads.
+ *
+ * The channels are partitioned into contiguous ranges, one per thread,
+ * and each write call processes all ranges concurrently, returning
+ * when all channels are decoded. The calling thread takes part in
+ * decoding. Frames are still read using \ref ltc_decoder_bank_read.
+ *
+ * This is only worthwhile for a large number of channels and
+ * sufficiently long buffers.
+ *
+ * @param b decoder bank handle
+ * @param threads number of concurrent threads; 1 to decode in the calling
+ * thread only. The value is limited to the number of channels.
+ * @return number of threads in use. This is 1 if libltc was built
+ * without thread support or threads could not be created.
+ */
+int ltc_decoder_bank_set_threads(LTCDecoderBank *b, int threads);
+
+/**
+ * Feed interleaved 8 bit unsigned audio to the decoder bank.
+ *
+ * @param b decoder bank handle
+ * @param buf pointer to interleaved audio sample data
+ * @param size number of audio-frames (samples per channel) to parse
+ * @param posinfo (optional, recommended) sample-offset in the audio-stream.
+ */
+void ltc_decoder_bank_write(LTCDecoderBank *b, ltcsnd_sample_t *buf, size_t size, ltc_off_t posinfo);
+
+/**
+ * Variant of \ref ltc_decoder_bank_write for interleaved 32-bit floating point audio.
+ * see \ref ltc_decoder_write_float
+ */
+void ltc_decoder_bank_write_float(LTCDecoderBank *b, float *buf, size_t size, ltc_off_t posinfo);
+
+/**
+ * Variant of \ref ltc_decoder_bank_write for interleaved signed 16 bit audio.
+ * see \ref ltc_decoder_write_s16
+ */
+void ltc_decoder_bank_write_s16(LTCDecoderBank *b, short *buf, size_t size, ltc_off_t posinfo);
+
+/**
+ * Feed non-interleaved 8 bit unsigned audio to the decoder bank.
+ *
+ * @param b decoder bank handle
+ * @param bufs array of \ref ltc_decoder_bank_channels pointers to audio sample data
+ * @param size number of samples per channel to parse
+ * @param posinfo (optional, recommended) sample-offset in the audio-stream.
+ */
+void ltc_decoder_bank_write_planar(LTCDecoderBank *b, ltcsnd_sample_t **bufs, size_t size, ltc_off_t posinfo);
+
+/**
+ * Variant of \ref ltc_decoder_bank_write_planar for 32-bit floating point audio.
+ */
+void ltc_decoder_bank_write_planar_float(LTCDecoderBank *b, float **bufs, size_t size, ltc_off_t posinfo);
+
+/**
+ * Variant of \ref ltc_decoder_bank_write_planar for signed 16 bit audio.
+ */
+void ltc_decoder_bank_write_planar_s16(LTCDecoderBank *b, short **bufs, size_t size, ltc_off_t posinfo);
+
+/**
+ * Pop the oldest LTC frame (lowest off_start) from the queues of all channels.
+ *
+ * @param b decoder bank handle
+ * @param frame the decoded LTC frame is copied there
+ * @param channel (optional, may be NULL) the channel of the frame is stored there
+ * @return 1 on success or 0 when no frames queued.
+ */
+int ltc_decoder_bank_read(LTCDecoderBank *b, LTCFrameExt *frame, int *channel);
+
+/**
+ * @param b decoder bank handle
+ * @return total number of LTC frames in the queues of all channels
+ */
+int ltc_decoder_bank_queue_length(LTCDecoderBank *b);
+
+/**
+ * Remove all LTC frames from the queues of all channels.
+ * @param b decoder bank handle
+ */
+void ltc_decoder_bank_queue_flush(LTCDecoderBank *b);
+
+/**
+ * Retrieve a snapshot of the statistics of one channel, see \ref ltc_decoder_stats.
+ * @param b decoder bank handle
+ * @param channel channel 0 <= channel < channels
+ * @param stats the current counters are copied there
+ * @return 0 on success, -1 if the channel is out of range
+ */
+int ltc_decoder_bank_stats(LTCDecoderBank *b, int channel, LTCDecoderStats* stats);
+
+/**
+ * Decode all LTC frames of a complete single channel audio buffer,
+ * using multiple threads.
+ *
+ * The buffer is split into overlapping chunks that are decoded
+ * concurrently. The partial results are joined at frame boundaries
+ * (using the frame's off_start), so that every frame is reported once.
+ * Offsets are relative to the start of the buffer.
+ *
+ * @param buf pointer to audio sample data
+ * @param size number of samples in the buffer
+ * @param apv audio-frames per video frame, see \ref ltc_decoder_create
+ * @param threads number of concurrent threads
+ * @param frames the decoded frames, sorted by off_start are stored there.
+ * The array is allocated by libltc and must be released
+ * with \ref ltc_frames_free. It is NULL if no frames were found.
+ * @return number of frames or -1 on error
+ */
+int ltc_decode_parallel(ltcsnd_sample_t *buf, size_t size, int apv, int threads, LTCFrameExt **frames);
+
+/**
+ * Variant of \ref ltc_decode_parallel that accepts 32-bit floating point
+ * audio samples, see \ref ltc_decoder_write_float
+ */
+int ltc_decode_parallel_float(float *buf, size_t size, int apv, int threads, LTCFrameExt **frames);
+
+/**
+ * Release frames returned by \ref ltc_decode_parallel
+ * @param frames array to free
+ */
+void ltc_frames_free(LTCFrameExt *frames);
+
+/**
+ * Open an audio file for decoding LTC.
+ *
+ * RIFF/WAVE (including BWF), RF64 and BW64 files with 8, 16, 24 or 32 bit
+ * integer or 32 or 64 bit floating point samples are supported.
+ * Files without a RIFF header are read as raw unsigned 8 bit mono audio
+ * (the format used by \ref ltc_decoder_write).
+ *
+ * The audio data is memory-mapped in windows that move sequentially through the
+ * file (unless LTC_FILE_NO_MMAP is given, or mapping fails), and the selected channel
+ * is decoded directly from the file's sample format.
+ *
+ * @param path file to open
+ * @param channel the channel that contains LTC, 0 <= channel < number of channels
+ * @param apv audio-frames per video frame, see \ref ltc_decoder_create. If zero or negative
+ * sample-rate / 25 is used, or 1920 if the sample-rate is not known (raw files).
+ * @param flags binary combination of \ref LTC_FILE_FLAGS
+ * @return file decoder or NULL if the file cannot be opened, or the format is not supported.
+ */
+LTCFileDecoder* ltc_file_decoder_open(const char* path, int channel, int apv, int flags);
+
+/**
+ * Close the file and release the decoder.
+ * @param f file decoder
+ * @return 0 on success, 1 if f is NULL
+ */
+int ltc_file_decoder_close(LTCFileDecoder* f);
+
+/**
+ * Decode the next LTC frame of the file.
+ *
+ * The file is decoded on demand, frame.off_start and frame.off_end are
+ * absolute offsets in audio-frames from the start of the audio data.
+ *
+ * @param f file decoder
+ * @param frame returned LTC frame
+ * @return 1 if a frame was returned, 0 at the end of the file, -1 on read errors
+ */
+int ltc_file_decoder_read(LTCFileDecoder* f, LTCFrameExt* frame);
+
+/**
+ * Continue decoding at the given position.
+ * The decoder state is reset, frames that were decoded but not yet read are discarded.
+ *
+ * @param f file decoder
+ * @param pos position in audio-frames, 0 <= pos <= length
+ * @return 0 on success, -1 if the position is out of range
+ */
+int ltc_file_decoder_seek(LTCFileDecoder* f, ltc_off_t pos);
+
+/**
+ * Find the first LTC frame at or after the current position, without decoding
+ * the complete file.
+ *
+ * The file is probed at strided positions, only the region between the last
+ * probe without and the first probe with LTC is decoded completely.
+ * Note that LTC shorter than the stride may be missed.
+ *
+ * @param f file decoder
+ * @param stride distance of probes in audio-frames, if zero or negative 250 video frames
+ * (10 seconds at 25 fps) are used
+ * @param frame returned LTC frame
+ * @return 1 if a frame was found, 0 if the file contains no (more) LTC, -1 on read errors
+ */
+int ltc_file_decoder_find(LTCFileDecoder* f, ltc_off_t stride, LTCFrameExt* frame);
+
+/**
+ * @param f file decoder
+ * @return the position (in audio-frames) up to which the file has been decoded
+ */
+ltc_off_t ltc_file_decoder_position(LTCFileDecoder* f);
+
+/**
+ * @param f file decoder
+ * @return the length of the audio data in audio-frames (samples per channel)
+ */
+ltc_off_t ltc_file_decoder_length(LTCFileDecoder* f);
+
+/**
+ * @param f file decoder
+ * @return the sample-rate of the file, or 0 if it is not known (raw files)
+ */
+int ltc_file_decoder_sample_rate(LTCFileDecoder* f);
+
+/**
+ * @param f file decoder
+ * @return the number of channels of the file
+ */
+int ltc_file_decoder_channels(LTCFileDecoder* f);
+
+/**
+ * Create an empty seek index.
+ *
+ * A seek index records sparse checkpoints of decoded LTC, that allow
+ * to locate a timecode in a recording without decoding it again.
+ *
+ * @param fps integer framerate of the timecode (for drop-frame-timecode round-up the fps),
+ * used to calculate frame-numbers, see \ref ltc_frame_to_index
+ * @param interval maximum number of frames per checkpoint, e.g. fps for one checkpoint
+ * per second. A new checkpoint is always added at discontinuities.
+ * @return index or NULL on error
+ */
+LTCIndex* ltc_index_create(int fps, int interval);
+
+/**
+ * Release memory of the seek index.
+ * @param x index to free
+ */
+void ltc_index_free(LTCIndex* x);
+
+/**
+ * Add a decoded frame to the index.
+ * Frames have to be added in the order they were decoded.
+ *
+ * @param x the index
+ * @param frame decoded frame, see \ref ltc_decoder_read
+ * @return 1 if a checkpoint was added, 0 if the frame extended the last checkpoint,
+ * -1 on memory allocation failure
+ */
+int ltc_index_add(LTCIndex* x, LTCFrameExt* frame);
+
+/**
+ * Decode a complete file and add all frames to the index.
+ *
+ * @param x the index
+ * @param f file decoder, decoding restarts at the beginning of the file
+ * @return number of checkpoints in the index, -1 on error
+ */
+int ltc_index_build(LTCIndex* x, LTCFileDecoder* f);
+
+/**
+ * Add LTC of a file to the index, using coarse-to-fine probing.
+ *
+ * The file is probed at strided positions. If the timecode found at a probe is
+ * the one predicted from the previous probe (using the measured frame duration),
+ * the frames in between are added without decoding them. The file is only decoded
+ * completely around discontinuities (jumps, start and end of LTC).
+ * Offsets of extrapolated frames are estimated, which is sufficient for \ref ltc_index_seek.
+ *
+ * Note that discontinuities shorter than the stride may be missed, if the timecode
+ * returns to the predicted value (e.g. a short dropout).
+ *
+ * @param x an empty index
+ * @param f file decoder of the file to index
+ * @param stride distance of probes in audio-frames, see \ref ltc_file_decoder_find
+ * @return number of checkpoints in the index, -1 on error
+ */
+int ltc_index_scan(LTCIndex* x, LTCFileDecoder* f, ltc_off_t stride);
+
+/**
+ * @param x the index
+ * @return number of checkpoints in the index
+ */
+int ltc_index_size(LTCIndex* x);
+
+/**
+ * Retrieve a checkpoint, checkpoints are ordered by offset.
+ *
+ * @param x the index
+ * @param i checkpoint number 0 <= i < ltc_index_size()
+ * @param entry returned checkpoint
+ * @return 0 on success, -1 if i is out of range
+ */
+int ltc_index_entry(LTCIndex* x, int i, LTCIndexEntry* entry);
+
+/**
+ * Estimate the sample offset of a timecode, using the index only.
+ *
+ * The checkpoint is found by binary search, the offset is extrapolated
+ * from its frame-length. If the timecode occurs more than once, the first
+ * occurrence is returned. The date (user-bits) is not taken into account.
+ *
+ * @param x the index
+ * @param timecode the timecode to find
+ * @return sample offset, or -1 if the timecode is not covered by the index
+ */
+ltc_off_t ltc_index_lookup(LTCIndex* x, LTCFrame* timecode);
+
+/**
+ * Find the exact sample offset of a timecode.
+ *
+ * Like \ref ltc_index_lookup, but the file is decoded around the
+ * estimated position (a few frames) to return the exact offset.
+ *
+ * @param x the index
+ * @param f file decoder of the file that was indexed, it is left positioned after the frame
+ * @param timecode the timecode to find
+ * @param frame if not NULL, the decoded frame is returned here
+ * @return the frame's off_start, or -1 if the timecode was not found
+ */
+ltc_off_t ltc_index_seek(LTCIndex* x, LTCFileDecoder* f, LTCFrame* timecode, LTCFrameExt* frame);
+
+/**
+ * Write the index to a file.
+ * The file format is platform independent.
+ *
+ * @param x the index
+ * @param path file to write
+ * @return 0 on success, -1 on error
+ */
+int ltc_index_save(LTCIndex* x, const char* path);
+
+/**
+ * Read an index that was written with \ref ltc_index_save.
+ *
+ * @param path file to read
+ * @return index or NULL on error
+ */
+LTCIndex* ltc_index_load(const char* path);
+
+/**
+ * Serialize an array of frames into a compact, platform independent packet.
+ *
+ * Every frame is stored as the 10 bytes of its \ref LTCFrame and a byte
+ * of flags (reverse), optionally followed by the offsets (variable length,
+ * relative to the previous frame) and the signal quality. biphase_tics are
+ * not stored. A packet can be sent as-is, e.g. as a single UDP datagram,
+ * or be appended to a file.
+ *
+ * @param buf destination
+ * @param size size of buf in bytes, \ref ltc_frames_packed_size is sufficient
+ * @param frames frames to store
+ * @param count number of frames
+ * @param fields binary combination of \ref LTC_PACKET_FIELDS
+ * @return length of the packet in bytes, 0 on error or if buf is too small
+ */
+size_t ltc_frames_pack(unsigned char* buf, size_t size, const LTCFrameExt* frames, int count, int fields);
+
+/**
+ * Upper bound of the length of a packet, see \ref ltc_frames_pack
+ *
+ * @param count number of frames
+ * @param fields binary combination of \ref LTC_PACKET_FIELDS
+ * @return size in bytes
+ */
+size_t ltc_frames_packed_size(int count, int fields);
+
+/**
+ * Number of frames in a packet, without decoding it.
+ *
+ * @param buf the packet
+ * @param size length of the packet in bytes
+ * @return number of frames, -1 if this is not a valid packet header
+ */
+int ltc_frames_packed_count(const unsigned char* buf, size_t size);
+
+/**
+ * Deserialize a packet written by \ref ltc_frames_pack.
+ *
+ * Fields that were not stored in the packet are set to zero.
+ * Packets of a newer, unknown \ref LTC_PACKET_VERSION are rejected.
+ *
+ * @param frames destination array
+ * @param count number of elements in the frames array
+ * @param buf the packet
+ * @param size length of the packet in bytes
+ * @param fields if not NULL, the \ref LTC_PACKET_FIELDS of the packet are returned here
+ * @return number of frames, -1 if the packet is invalid, truncated or
+ * contains more than count frames
+ */
+int ltc_frames_unpack(LTCFrameExt* frames, int count, const unsigned char* buf, size_t size, int* fields);
+
+/**
+ * Create a timecode tracker.
+ *
+ * The tracker follows decoded frames with a delay-locked loop and
+ * provides a filtered estimate of speed and position, that can be
+ * queried for any sample, also between frames.
+ *
+ * @param sample_rate audio sample rate (eg. 48000)
+ * @param fps video-frames per second (e.g. 25.0)
+ * @param standard the TV standard to use for parity bit assignment, see \ref ltc_tracker_timecode
+ * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE and LTC_NO_PARITY are relevant.
+ * @return tracker or NULL on error
+ */
+LTCTracker* ltc_tracker_create(double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags);
 
 /**
- * Opaque structure
- * see: \ref ltc_decoder_create, \ref ltc_decoder_free
+ * Release memory of the tracker.
+ * @param t tracker to free
  */
-typedef struct LTCDecoder LTCDecoder;
+void ltc_tracker_free(LTCTracker* t);
 
 /**
- * Opaque structure
- * see: \ref ltc_encoder_create, \ref ltc_encoder_free
+ * Discard the current estimate, the next frame starts a new lock.
+ * @param t the tracker
  */
-typedef struct LTCEncoder LTCEncoder;
+void ltc_tracker_reset(LTCTracker* t);
 
 /**
- * Convert binary LTCFrame into SMPTETimecode struct
+ * Set the bandwidth of the loop filter.
+ * Lower values result in a smoother estimate, higher values follow speed changes faster.
  *
- * @param stime output
- * @param frame input
- * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE is relevant.
- * if LTC_USE_DATE is set, the user-fields in LTCFrame will be parsed into the date variable of SMPTETimecode.
- * otherwise the date information in the SMPTETimecode is set to zero.
+ * @param t the tracker
+ * @param bandwidth in Hz, default 1.0; at most 1/8 of the framerate
+ * @return 0 on success, -1 if the value is out of range
  */
-void ltc_frame_to_time(SMPTETimecode* stime, LTCFrame* frame, int flags);
+int ltc_tracker_set_bandwidth(LTCTracker* t, double bandwidth);
 
 /**
- * Translate SMPTETimecode struct into its binary LTC representation
- * and set the LTC frame's parity bit accordingly (see \ref ltc_frame_set_parity)
+ * Update the estimate with a decoded frame.
+ * Frames have to be passed in the order they were decoded.
  *
- * @param frame output - the frame to be set
- * @param stime input - timecode input
- * @param standard the TV standard to use for parity bit assignment
- * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE and LTC_NO_PARITY are relevant.
- * if LTC_USE_DATE is given, user-fields in LTCFrame will be set from the date in SMPTETimecode,
- * otherwise the user-bits are not modified. All non-timecode fields remain untouched - except for the parity bit
- * unless LTC_NO_PARITY is given.
+ * A gap of a few frames with continuous timecode is bridged (\ref LTC_TRACKER_DROPOUT).
+ * On a jump, a change of direction or a longer gap, the tracker re-locks to the new frame.
+ *
+ * @param t the tracker
+ * @param frame decoded frame, see \ref ltc_decoder_read
+ * @return binary combination of \ref LTC_TRACKER_STATUS
  */
-void ltc_time_to_frame(LTCFrame* frame, SMPTETimecode* stime, enum LTC_TV_STANDARD standard, int flags);
+int ltc_tracker_update(LTCTracker* t, LTCFrameExt* frame);
 
 /**
- * Reset all values of a LTC FRAME to zero, except for the sync-word (0x3FFD) at the end.
- * The sync word is set according to architecture (big/little endian).
- * Also set the Frame's parity bit accordingly (see \ref ltc_frame_set_parity)
- * @param frame the LTCFrame to reset
+ * Query the state of the tracker at a given sample.
+ *
+ * @param t the tracker
+ * @param sample audio sample position
+ * @return LTC_TRACKER_LOCKED, or LTC_TRACKER_DROPOUT if no frame was received
+ * for a longer time before the sample, 0 if the tracker is not (yet) locked
  */
-void ltc_frame_reset(LTCFrame* frame);
+int ltc_tracker_status(LTCTracker* t, ltc_off_t sample);
 
 /**
- * Increment the timecode by one Frame (1/framerate seconds)
- * and set the Frame's parity bit accordingly (see \ref ltc_frame_set_parity)
- *
- * @param frame the LTC-timecode to increment
- * @param fps integer framerate (for drop-frame-timecode set frame->dfbit and round-up the fps).
- * @param standard the TV standard to use for parity bit assignment
- * if set to 1 the 25fps standard is enabled and LTC Frame bit 59 instead of 27 is used for the parity. It only has only has effect flag bit 4 (LTC_NO_PARITY) is cleared.
- * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE and LTC_NO_PARITY are relevant.
- * If the bit 0 (1) is set (1) interpret user-data as date and increment date if timecode wraps after 24h.
- * (Note: leap-years are taken into account, but since the year is two-digit only, the 100,400yr rules are ignored.
- * "00" is assumed to be year 2000 which was a leap year.)
- * @return 1 if timecode was wrapped around after 23:59:59:ff, 0 otherwise
+ * @param t the tracker
+ * @return the estimated playback speed, 1.0 is nominal speed,
+ * negative values indicate reverse playback, 0 if no frame was received
  */
-int ltc_frame_increment(LTCFrame* frame, int fps, enum LTC_TV_STANDARD standard, int flags);
+double ltc_tracker_speed(LTCTracker* t);
 
 /**
- * Decrement the timecode by one Frame (1/framerate seconds)
- * and set the Frame's parity bit accordingly (see \ref ltc_frame_set_parity)
+ * Estimate the frame-number at a given sample in constant time.
  *
- * @param frame the LTC-timecode to decrement
- * @param fps integer framerate (for drop-frame-timecode set frame->dfbit and round-up the fps).
- * @param standard the TV standard to use for parity bit assignment
- * if set to 1 the 25fps standard is enabled and LTC Frame bit 59 instead of 27 is used for the parity. It only has only has effect flag bit 4 (LTC_NO_PARITY) is cleared.
- * @param flags binary combination of \ref LTC_BG_FLAGS - here only LTC_USE_DATE and LTC_NO_PARITY are relevant.
- * if the bit 0 is set (1) interpret user-data as date and decrement date if timecode wraps at 24h.
- * (Note: leap-years are taken into account, but since the year is two-digit only, the 100,400yr rules are ignored.
- * "00" is assumed to be year 2000 which was a leap year.)
- * bit 3 (8) indicates that the parity bit should not be touched
- * @return 1 if timecode was wrapped around at 23:59:59:ff, 0 otherwise
+ * The position is extrapolated from the last frame, using the filtered speed.
+ *
+ * @param t the tracker
+ * @param sample audio sample position
+ * @return fractional frame-number since 00:00:00:00, see \ref ltc_frame_to_index,
+ * or -1 if no frame was received
  */
-int ltc_frame_decrement(LTCFrame* frame, int fps, enum LTC_TV_STANDARD standard, int flags);
+double ltc_tracker_position(LTCTracker* t, ltc_off_t sample);
 
 /**
- * Create a new LTC decoder.
+ * Estimate the timecode at a given sample in constant time.
  *
- * @param apv audio-frames per video frame. This is just used for initial settings, the speed is tracked dynamically. setting this in the right ballpark is needed to properly decode the first LTC frame in a sequence.
- * @param queue_size length of the internal queue to store decoded frames
- * to SMPTEDecoderWrite.
- * @return decoder handle or NULL if out-of-memory
+ * @param t the tracker
+ * @param sample audio sample position
+ * @param frame the timecode at the given sample, user-bits are copied from the last frame
+ * @param subframe if not NULL, the position in the frame is returned here (0 <= subframe < 1)
+ * @return 0 on success, -1 if no frame was received
  */
-LTCDecoder * ltc_decoder_create(int apv, int queue_size);
-
+int ltc_tracker_timecode(LTCTracker* t, ltc_off_t sample, LTCFrame* frame, double* subframe);
 
 /**
- * Release memory of decoder.
- * @param d decoder handle
+ * Create a shared memory frame publisher.
+ *
+ * Decoded frames are published to a POSIX shared memory object, a ring
+ * of seqlock protected slots. Subscribers in other processes poll it with
+ * \ref ltc_subscriber_read or \ref ltc_subscriber_latest without system
+ * calls and without ever blocking the publisher, so one decoder can serve
+ * any number of processes on the same host.
+ *
+ * Creation fails if an object of the same name exists, e.g. of another
+ * publisher that is still running, unless \ref LTC_PUBLISHER_REPLACE is given.
+ * Subscribers of a replaced object keep reading it, but no longer receive frames.
+ * Publisher and subscribers must use the same build of libltc (the
+ * layout of \ref LTCFrameExt is checked by \ref ltc_subscriber_open).
+ *
+ * This is not available on all platforms.
+ *
+ * @param name name of the shared memory object, e.g. "/ltc-in1", see shm_open(3)
+ * @param queue_size number of frames a subscriber may lag behind,
+ * rounded up to a power of two
+ * @param flags binary combination of \ref LTC_PUBLISHER_FLAGS
+ * @return publisher handle or NULL on error
  */
-int ltc_decoder_free(LTCDecoder *d);
+LTCPublisher* ltc_publisher_create(const char* name, int queue_size, int flags);
 
 /**
- * Feed the LTC decoder with new audio samples.
- *
- * Parse raw audio for LTC timestamps. Once a complete LTC frame has been
- * decoded it is pushed into a queue (\ref ltc_decoder_read)
+ * Remove the shared memory object and release the publisher.
+ * Subscribers keep their mapping, but no longer receive frames.
+ * If the object was replaced by another publisher, the name is not removed.
  *
- * @param d decoder handle
- * @param buf pointer to ltcsnd_sample_t - unsigned 8 bit mono audio data
- * @param size size number of samples to parse
- * @param posinfo (optional, recommended) sample-offset in the audio-stream. It is added to \ref off_start, \ref off_end in \ref LTCFrameExt and should be monotonic (ie incremented by \p size for every call to ltc_decoder_write)
+ * @param p publisher handle
  */
-void ltc_decoder_write(LTCDecoder *d,
-		ltcsnd_sample_t *buf, size_t size,
-		ltc_off_t posinfo);
+void ltc_publisher_free(LTCPublisher* p);
 
 /**
- * Wrapper around \ref ltc_decoder_write that accepts 64-bit floating point
- * audio samples. Note: internally libltc uses 8 bit only.
+ * Publish a frame. This is realtime safe and lock-free,
+ * but must only be called from one thread at a time.
  *
- * @param d decoder handle
- * @param buf pointer to audio sample data
- * @param size number of samples to parse
- * @param posinfo (optional, recommended) sample-offset in the audio-stream.
+ * @param p publisher handle
+ * @param frame the frame to publish
  */
-void ltc_decoder_write_double(LTCDecoder *d, double *buf, size_t size, ltc_off_t posinfo);
+void ltc_publisher_write(LTCPublisher* p, const LTCFrameExt* frame);
 
 /**
- * Wrapper around \ref ltc_decoder_write that accepts 32-bit floating point
- * audio samples. Note: internally libltc uses 8 bit only.
+ * Read all frames from the decoder's queue (see \ref ltc_decoder_read)
+ * and publish them.
  *
+ * @param p publisher handle
  * @param d decoder handle
- * @param buf pointer to audio sample data
- * @param size number of samples to parse
- * @param posinfo (optional, recommended) sample-offset in the audio-stream.
+ * @return number of published frames, -1 if not supported
  */
-void ltc_decoder_write_float(LTCDecoder *d, float *buf, size_t size, ltc_off_t posinfo);
+int ltc_publisher_forward(LTCPublisher* p, LTCDecoder* d);
 
 /**
- * Wrapper around \ref ltc_decoder_write that accepts signed 16 bit
- * audio samples. Note: internally libltc uses 8 bit only.
+ * Attach to a frame publisher, see \ref ltc_publisher_create.
+ * Only frames that are published after this call are returned.
  *
- * @param d decoder handle
- * @param buf pointer to audio sample data
- * @param size number of samples to parse
- * @param posinfo (optional, recommended) sample-offset in the audio-stream.
+ * @param name name of the shared memory object
+ * @return subscriber handle or NULL if there is no compatible publisher
  */
-void ltc_decoder_write_s16(LTCDecoder *d, short *buf, size_t size, ltc_off_t posinfo);
+LTCSubscriber* ltc_subscriber_open(const char* name);
 
 /**
- * Wrapper around \ref ltc_decoder_write that accepts unsigned 16 bit
- * audio samples. Note: internally libltc uses 8 bit only.
+ * Detach from the publisher and release the subscriber.
  *
- * @param d decoder handle
- * @param buf pointer to audio sample data
- * @param size number of samples to parse
- * @param posinfo (optional, recommended) sample-offset in the audio-stream.
+ * @param s subscriber handle
  */
-void ltc_decoder_write_u16(LTCDecoder *d, unsigned short *buf, size_t size, ltc_off_t posinfo);
+void ltc_subscriber_close(LTCSubscriber* s);
 
 /**
- * Decoded LTC frames are placed in a queue. This function retrieves
- * a frame from the queue, and stores it at LTCFrameExt*
+ * Read the next published frame.
  *
- * @param d decoder handle
- * @param frame the decoded LTC frame is copied there
- * @return 1 on success or 0 when no frames queued.
+ * If the subscriber lags behind by more than the queue_size of the
+ * publisher, the oldest frames are skipped, see \ref ltc_subscriber_overruns.
+ *
+ * @param s subscriber handle
+ * @param frame the frame is copied here
+ * @return 1 if a frame was read, 0 if there is no new frame
  */
-int ltc_decoder_read(LTCDecoder *d, LTCFrameExt *frame);
+int ltc_subscriber_read(LTCSubscriber* s, LTCFrameExt* frame);
 
 /**
- * Remove all LTC frames from the internal queue.
- * @param d decoder handle
+ * Read the most recently published frame, skipping all older frames
+ * that were not read yet.
+ *
+ * @param s subscriber handle
+ * @param frame the frame is copied here
+ * @return 1 if a frame was read, 0 if no frame was published since the last read
  */
-void ltc_decoder_queue_flush(LTCDecoder* d);
+int ltc_subscriber_latest(LTCSubscriber* s, LTCFrameExt* frame);
 
 /**
- * Count number of LTC frames currently in the queue.
- * @param d decoder handle
- * @return number of queued frames
+ * @param s subscriber handle
+ * @return number of frames that were overwritten before \ref ltc_subscriber_read reached them
  */
-int ltc_decoder_queue_length(LTCDecoder* d);
+unsigned int ltc_subscriber_overruns(LTCSubscriber* s);
 
 
 
@@ -524,6 +1631,48 @@ int ltc_decoder_queue_length(LTCDecoder* d);
  */
 LTCEncoder* ltc_encoder_create(double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags);
 
+/**
+ * Calculate the memory needed for an encoder, including its internal buffer,
+ * see \ref ltc_encoder_create_in.
+ *
+ * @param sample_rate the highest audio sample rate that will be used
+ * @param fps the lowest framerate that will be used
+ * @return size in bytes, 0 if the parameters are invalid
+ */
+size_t ltc_encoder_size(double sample_rate, double fps);
+
+/**
+ * Create an encoder in caller-provided memory.
+ *
+ * The internal buffer is also placed in the given memory: all space after
+ * the encoder object is used, so that the buffer can later be enlarged with
+ * \ref ltc_encoder_set_buffersize (e.g. before \ref ltc_encoder_reinit) up to that size.
+ * The encoder never allocates memory, \ref ltc_encoder_free does nothing.
+ *
+ * @param mem memory for the encoder, aligned for any type (e.g. from malloc)
+ * @param size size of mem, at least \ref ltc_encoder_size bytes
+ * @param sample_rate audio sample rate (eg. 48000)
+ * @param fps video-frames per second (e.g. 25.0)
+ * @param standard the TV standard to use for Binary Group Flag bit position
+ * @param flags binary combination of \ref LTC_BG_FLAGS
+ * @return encoder handle (equal to mem) or NULL if the memory is too small or not aligned
+ */
+LTCEncoder* ltc_encoder_create_in(void *mem, size_t size, double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags);
+
+/**
+ * Create an encoder using custom memory allocation.
+ * The encoder and its internal buffer are allocated as a single block
+ * of \ref ltc_encoder_size bytes.
+ *
+ * @param allocator the allocator callbacks, they are copied; NULL uses the standard library
+ * @param sample_rate audio sample rate (eg. 48000)
+ * @param fps video-frames per second (e.g. 25.0)
+ * @param standard the TV standard to use for Binary Group Flag bit position
+ * @param flags binary combination of \ref LTC_BG_FLAGS
+ * @return encoder handle or NULL if out-of-memory
+ */
+LTCEncoder* ltc_encoder_create_alloc(const LTCAllocator *allocator, double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags);
+
 /**
  * Release memory of the encoder.
  * @param e encoder handle
@@ -681,9 +1830,9 @@ size_t ltc_encoder_get_buffersize(LTCEncoder *e);
  * and biphase state reset.
  *
  * This call will fail if the internal buffer is too small
- * to hold one full LTC frame. Use \ref ltc_encoder_set_buffersize to
- * prepare an internal buffer large enough to accommodate all
- * sample_rate, fps combinations that you would like to re-init to.
+ * to hold one full LTC frame. Use \ref ltc_encoder_reserve (or
+ * \ref ltc_encoder_set_buffersize) to prepare an internal buffer large enough
+ * to accommodate all sample_rate, fps combinations that you would like to re-init to.
  *
  * The LTC frame payload data is not modified by this call, however,
  * the flag-bits of the LTC-Frame are updated:
@@ -702,6 +1851,38 @@ size_t ltc_encoder_get_buffersize(LTCEncoder *e);
  */
 int ltc_encoder_reinit(LTCEncoder *e, double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags);
 
+/**
+ * Change sample-rate and fps, without resetting the encoder (realtime safe).
+ *
+ * Unlike \ref ltc_encoder_reinit audio that was not yet read from the
+ * internal buffer, the biphase state, the frame being encoded, volume and
+ * filter rise time are kept. The dfbit and parity are updated as with
+ * \ref ltc_encoder_reinit.
+ *
+ * The internal buffer is enlarged in place if needed, which fails if it
+ * was not reserved before, see \ref ltc_encoder_reserve.
+ *
+ * @param e encoder handle
+ * @param sample_rate audio sample rate (eg. 48000)
+ * @param fps video-frames per second (e.g. 25.0)
+ * @return 0 on success, -1 if the internal buffer is too small
+ */
+int ltc_encoder_reconfigure(LTCEncoder *e, double sample_rate, double fps);
+
+/**
+ * Reserve capacity of the internal buffer for the given highest sample-rate
+ * and lowest fps, so that \ref ltc_encoder_reinit and \ref ltc_encoder_reconfigure
+ * do not need to allocate memory. Unlike \ref ltc_encoder_set_buffersize
+ * buffered data is retained and the buffer-size is unchanged.
+ *
+ * @param e encoder handle
+ * @param sample_rate highest audio sample rate that will be used
+ * @param fps lowest framerate that will be used
+ * @return 0 on success, -1 if allocation fails or the encoder was created
+ * with \ref ltc_encoder_create_in and the memory is too small
+ */
+int ltc_encoder_reserve(LTCEncoder *e, double sample_rate, double fps);
+
 /**
  * reset ecoder state.
  * flushes buffer, reset biphase state
@@ -742,11 +1923,15 @@ int ltc_encoder_set_bufsize(LTCEncoder *e, double sample_rate, double fps) DEPRE
  * resizing the internal buffer will flush all existing data
  * in it - alike \ref ltc_encoder_buffer_flush.
  *
+ * Memory is only allocated if the buffer grows beyond its largest size so far
+ * (or the size that was provided to \ref ltc_encoder_create_in).
+ *
  * @param e encoder handle
  * @param sample_rate audio sample rate (eg. 48000)
  * @param fps video-frames per second (e.g. 25.0)
- * @return 0 on success, -1 if allocation fails (which makes the
- *   encoder unusable, call \ref ltc_encoder_free or realloc the buffer)
+ * @return 0 on success, -1 if allocation fails or the encoder was created
+ * with \ref ltc_encoder_create_in and the memory is too small (the previous
+ * buffer is kept in this case)
  */
 int ltc_encoder_set_buffersize(LTCEncoder *e, double sample_rate, double fps);
 
@@ -875,6 +2060,247 @@ void ltc_encoder_encode_frame(LTCEncoder *e);
  */
 void ltc_encoder_encode_reversed_frame(LTCEncoder *e);
 
+/**
+ * Encode a full LTC frame at variable playback speed.
+ *
+ * The speed changes linearly from speed_start at the beginning of the frame
+ * to speed_end at its end, the length of every bit is scaled individually.
+ * This allows shuttle and jog without resampling the generated signal:
+ * consecutive frames are continuous if the speed_end of one frame is
+ * the speed_start of the next.
+ *
+ * Unlike \ref ltc_encoder_encode_byte, speed is the playback speed:
+ * 1.0 is nominal speed, 0.5 is half speed (the frame is twice as long),
+ * negative values encode the frame in reverse (like
+ * \ref ltc_encoder_encode_reversed_frame).
+ *
+ * The internal buffer must be large enough to hold the frame, see
+ * \ref ltc_encoder_set_min_speed. If it is not, nothing is encoded.
+ *
+ * @param e encoder handle
+ * @param speed_start playback speed at the start of the frame, must be != 0
+ * @param speed_end playback speed at the end of the frame, must be != 0
+ * and have the same sign as speed_start
+ * @return 0 on success, -1 if the speed is invalid or the frame does not fit into the buffer
+ */
+int ltc_encoder_encode_frame_varispeed(LTCEncoder *e, double speed_start, double speed_end);
+
+/**
+ * Size the internal buffer for \ref ltc_encoder_encode_frame_varispeed,
+ * so that one frame at the given minimum playback speed fits.
+ *
+ * This is equivalent to \ref ltc_encoder_set_buffersize with the encoder's
+ * sample-rate and fps * min_speed, and flushes the buffer.
+ * Speeds above 1.0 are treated as 1.0. Call it again after changing
+ * the sample-rate or fps.
+ *
+ * @param e encoder handle
+ * @param min_speed lowest absolute playback speed that will be used, > 0
+ * @return 0 on success, -1 if min_speed is invalid or allocation fails
+ */
+int ltc_encoder_set_min_speed(LTCEncoder *e, double min_speed);
+
+/**
+ * Encode consecutive LTC frames directly into a given buffer.
+ *
+ * This is equivalent to repeatedly calling \ref ltc_encoder_encode_frame,
+ * \ref ltc_encoder_copy_buffer and \ref ltc_encoder_inc_timecode, but
+ * without using the internal buffer. The encoder's internal buffer
+ * is not modified.
+ *
+ * Encoding stops early if the remaining space is not sufficient for
+ * another frame. To encode all frames, size must be at least
+ * n_frames * \ref ltc_encoder_get_buffersize.
+ *
+ * @param e encoder handle
+ * @param n_frames number of frames to encode
+ * @param buf destination buffer
+ * @param size number of samples that fit into the buffer
+ * @return number of samples written to buf
+ */
+size_t ltc_encoder_encode_frames(LTCEncoder *e, int n_frames, ltcsnd_sample_t *buf, size_t size);
+
+/**
+ * Variant of \ref ltc_encoder_encode_frames that renders 32-bit floating
+ * point samples (-1..+1).
+ *
+ * The waveform is computed at full resolution, without 8 bit quantization.
+ * The peak level is the exact linear gain of the value given to
+ * \ref ltc_encoder_set_volume.
+ *
+ * @param e encoder handle
+ * @param n_frames number of frames to encode
+ * @param buf destination buffer
+ * @param size number of samples that fit into the buffer
+ * @return number of samples written to buf
+ */
+size_t ltc_encoder_encode_frames_float(LTCEncoder *e, int n_frames, float *buf, size_t size);
+
+/**
+ * Variant of \ref ltc_encoder_encode_frames_float that renders signed 16 bit samples.
+ */
+size_t ltc_encoder_encode_frames_s16(LTCEncoder *e, int n_frames, short *buf, size_t size);
+
+/**
+ * Variant of \ref ltc_encoder_encode_frames_float that renders packed
+ * signed 24 bit little-endian samples (3 bytes per sample).
+ *
+ * @param e encoder handle
+ * @param n_frames number of frames to encode
+ * @param buf destination buffer, must hold 3 * size bytes
+ * @param size number of samples that fit into the buffer
+ * @return number of samples written to buf
+ */
+size_t ltc_encoder_encode_frames_s24(LTCEncoder *e, int n_frames, unsigned char *buf, size_t size);
+
+/**
+ * Render exactly n_samples of continuous LTC.
+ *
+ * This is a pull-style alternative to \ref ltc_encoder_encode_frame
+ * for realtime use with arbitrary block-sizes: every call continues
+ * the signal where the previous call ended, sample accurate.
+ * Frames are started and the timecode is incremented internally:
+ * the encoder's frame is latched when its first sample is rendered and
+ * the timecode is advanced at the same time. So \ref ltc_encoder_set_timecode
+ * and \ref ltc_encoder_get_timecode refer to the next frame to be started.
+ *
+ * The output is identical to consecutive calls of
+ * \ref ltc_encoder_encode_frame and \ref ltc_encoder_inc_timecode.
+ * The internal buffer is not used.
+ *
+ * @param e encoder handle
+ * @param buf destination buffer
+ * @param n_samples number of samples to render
+ */
+void ltc_encoder_render(LTCEncoder *e, ltcsnd_sample_t *buf, size_t n_samples);
+
+/**
+ * Variant of \ref ltc_encoder_render, rendering floating point samples,
+ * see \ref ltc_encoder_encode_frames_float
+ */
+void ltc_encoder_render_float(LTCEncoder *e, float *buf, size_t n_samples);
+
+/**
+ * Variant of \ref ltc_encoder_render, rendering signed 16 bit samples
+ */
+void ltc_encoder_render_s16(LTCEncoder *e, short *buf, size_t n_samples);
+
+/**
+ * Variant of \ref ltc_encoder_render, rendering packed 24 bit samples
+ * (3 * n_samples bytes)
+ */
+void ltc_encoder_render_s24(LTCEncoder *e, unsigned char *buf, size_t n_samples);
+
+/**
+ * Variant of \ref ltc_encoder_render that writes a single channel
+ * of an interleaved buffer. Other channels are not modified.
+ *
+ * @param e encoder handle
+ * @param buf interleaved destination buffer
+ * @param stride number of interleaved channels
+ * @param channel channel to write to, 0 <= channel < stride
+ * @param n_samples number of samples (audio-frames) to render
+ */
+void ltc_encoder_render_interleaved(LTCEncoder *e, ltcsnd_sample_t *buf, int stride, int channel, size_t n_samples);
+
+/**
+ * Variant of \ref ltc_encoder_render_interleaved for floating point samples.
+ */
+void ltc_encoder_render_interleaved_float(LTCEncoder *e, float *buf, int stride, int channel, size_t n_samples);
+
+/**
+ * Variant of \ref ltc_encoder_render_interleaved for signed 16 bit samples.
+ */
+void ltc_encoder_render_interleaved_s16(LTCEncoder *e, short *buf, int stride, int channel, size_t n_samples);
+
+/**
+ * Variant of \ref ltc_encoder_render_interleaved for packed 24 bit samples,
+ * an audio-frame is 3 * stride bytes.
+ */
+void ltc_encoder_render_interleaved_s24(LTCEncoder *e, unsigned char *buf, int stride, int channel, size_t n_samples);
+
+/**
+ * Restart rendering with \ref ltc_encoder_render.
+ *
+ * A partially rendered frame is discarded, the next sample starts
+ * a new frame with the encoder's current timecode.
+ * This is also implied by \ref ltc_encoder_reset.
+ *
+ * @param e encoder handle
+ * @param align if non-zero, the stream starts with \ref ltc_frame_alignment
+ * samples of silence. If the first sample corresponds to the start
+ * of a video frame, the LTC frames are then aligned to the video frames
+ * as defined by the TV standard.
+ */
+void ltc_encoder_render_reset(LTCEncoder *e, int align);
+
+/**
+ * Allocate a bank of LTC encoders, rendering to an interleaved buffer.
+ *
+ * Every channel has its own encoder which can be configured individually,
+ * see \ref ltc_encoder_bank_encoder (e.g. different or offset timecode).
+ *
+ * @param channels number of channels
+ * @param sample_rate audio sample rate (eg. 48000)
+ * @param fps video-frames per second (e.g. 25.0)
+ * @param standard the TV standard to use for Binary Group Flag bit position
+ * @param flags binary combination of \ref LTC_BG_FLAGS
+ * @return encoder bank handle or NULL if out-of-memory
+ */
+LTCEncoderBank* ltc_encoder_bank_create(int channels, double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags);
+
+/**
+ * Release memory of the encoder bank and all its encoders.
+ * @param b encoder bank handle
+ */
+void ltc_encoder_bank_free(LTCEncoderBank *b);
+
+/**
+ * @param b encoder bank handle
+ * @return number of channels of the bank
+ */
+int ltc_encoder_bank_channels(LTCEncoderBank *b);
+
+/**
+ * Get the encoder of a given channel.
+ * The encoder is owned by the bank and must not be freed.
+ *
+ * @param b encoder bank handle
+ * @param channel channel index
+ * @return encoder handle or NULL if the channel is out of range
+ */
+LTCEncoder* ltc_encoder_bank_encoder(LTCEncoderBank *b, int channel);
+
+/**
+ * Render n_samples of all channels into an interleaved buffer,
+ * see \ref ltc_encoder_render.
+ *
+ * The buffer is written in a single pass: it is processed in blocks of
+ * a few hundred audio-frames, and all channels of a block are rendered
+ * before advancing to the next block.
+ *
+ * @param b encoder bank handle
+ * @param buf interleaved destination buffer,
+ * n_samples * \ref ltc_encoder_bank_channels samples
+ * @param n_samples number of audio-frames to render
+ */
+void ltc_encoder_bank_render(LTCEncoderBank *b, ltcsnd_sample_t *buf, size_t n_samples);
+
+/**
+ * Variant of \ref ltc_encoder_bank_render for floating point samples.
+ */
+void ltc_encoder_bank_render_float(LTCEncoderBank *b, float *buf, size_t n_samples);
+
+/**
+ * Variant of \ref ltc_encoder_bank_render for signed 16 bit samples.
+ */
+void ltc_encoder_bank_render_s16(LTCEncoderBank *b, short *buf, size_t n_samples);
+
+/**
+ * Variant of \ref ltc_encoder_bank_render for packed 24 bit samples.
+ */
+void ltc_encoder_bank_render_s24(LTCEncoderBank *b, unsigned char *buf, size_t n_samples);
+
 /**
  * Set the parity of the LTC frame.
  *
@@ -0,0 +1,563 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file ltc.hpp
+ * @brief header-only C++17 interface to libltc
+ *
+ * RAII handles for \ref LTCDecoder and \ref LTCEncoder, constexpr
+ * timecode <> frame-index arithmetic and a square-wave encoder that is
+ * specialized at compile time on the sample format, sample-rate, framerate
+ * and TV standard.
+ *
+ * Nothing in this file needs to be compiled into the library, it only
+ * uses the C API declared in ltc.h.
+ */
+
+#ifndef LTC_HPP
+#define LTC_HPP 1
+
+#if !defined(__cplusplus) || __cplusplus < 201703L
+#error "ltc.hpp requires C++17, use ltc.h from C"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "ltc.h"
+
+namespace ltc {
+
+namespace detail {
+template <typename T> struct dependent_false : std::false_type {};
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Framerates and timecode arithmetic
+ */
+
+/**
+ * Framerate as exact rational number Num / Den.
+ *
+ * @tparam Num numerator, e.g. 30000
+ * @tparam Den denominator, e.g. 1001
+ * @tparam DropFrame use drop-frame timecode (only valid for 29.97 fps)
+ */
+template <int Num, int Den = 1, bool DropFrame = false>
+struct Rate {
+	static_assert(Num > 0 && Den > 0, "invalid framerate");
+	static constexpr int num = Num;
+	static constexpr int den = Den;
+	/** framerate as used by \ref ltc_encoder_create */
+	static constexpr double value = (double) Num / (double) Den;
+	/** integer framerate, rounded up, as used for frame-numbers */
+	static constexpr int fps = (Num + Den - 1) / Den;
+	static constexpr bool drop_frame = DropFrame;
+	static_assert(!DropFrame || fps == 30, "drop-frame timecode requires 29.97 fps");
+};
+
+typedef Rate<24000, 1001>       Rate23976;
+typedef Rate<24>                Rate24;
+typedef Rate<25>                Rate25;
+typedef Rate<30000, 1001>       Rate2997;
+typedef Rate<30000, 1001, true> Rate2997DF;
+typedef Rate<30>                Rate30;
+
+/** TV standard that is commonly used with the given framerate */
+template <typename FrameRate>
+constexpr LTC_TV_STANDARD default_standard() {
+	return FrameRate::fps == 25 ? LTC_TV_625_50 : (FrameRate::fps == 24 ? LTC_TV_FILM_24 : LTC_TV_525_60);
+}
+
+/** decimal timecode, see also \ref SMPTETimecode */
+struct Timecode {
+	int hours;
+	int mins;
+	int secs;
+	int frame;
+};
+
+constexpr bool operator==(const Timecode &a, const Timecode &b) {
+	return a.hours == b.hours && a.mins == b.mins && a.secs == b.secs && a.frame == b.frame;
+}
+
+constexpr bool operator!=(const Timecode &a, const Timecode &b) {
+	return !(a == b);
+}
+
+/** number of frames in 24 hours */
+constexpr ltc_off_t frames_per_day(int fps, bool drop_frame) {
+	return drop_frame ? 144 * (600 * (ltc_off_t)fps - 18) : 86400 * (ltc_off_t)fps;
+}
+
+/**
+ * Check if the timecode is in range. For drop-frame timecode the
+ * skipped frame-numbers 0 and 1 (except every 10th minute) are invalid.
+ */
+constexpr bool is_valid(const Timecode &t, int fps, bool drop_frame) {
+	if (t.hours < 0 || t.hours > 23 || t.mins < 0 || t.mins > 59) return false;
+	if (t.secs < 0 || t.secs > 59 || t.frame < 0 || t.frame >= fps) return false;
+	return !(drop_frame && t.secs == 0 && t.frame < 2 && (t.mins % 10) != 0);
+}
+
+/**
+ * Frame-number since 00:00:00:00, see \ref ltc_frame_to_index
+ */
+constexpr ltc_off_t timecode_to_index(const Timecode &t, int fps, bool drop_frame) {
+	const ltc_off_t total_mins = 60 * (ltc_off_t)t.hours + t.mins;
+	ltc_off_t index = ((total_mins * 60) + t.secs) * fps + t.frame;
+	if (drop_frame) {
+		index -= 2 * (total_mins - total_mins / 10);
+	}
+	return index;
+}
+
+/**
+ * Timecode of a given frame-number, the inverse of \ref timecode_to_index.
+ * The index wraps around at 24h, see \ref ltc_index_to_frame
+ */
+constexpr Timecode index_to_timecode(ltc_off_t index, int fps, bool drop_frame) {
+	const ltc_off_t day = frames_per_day(fps, drop_frame);
+	index %= day;
+	if (index < 0) {
+		index += day;
+	}
+	if (drop_frame) {
+		const ltc_off_t per_10min = 600 * (ltc_off_t)fps - 18;
+		const ltc_off_t per_min = 60 * (ltc_off_t)fps - 2;
+		const ltc_off_t d = index / per_10min;
+		const ltc_off_t m = index % per_10min;
+		/* re-insert the skipped frame numbers */
+		index += 18 * d;
+		if (m > 1) {
+			index += 2 * ((m - 2) / per_min);
+		}
+	}
+	Timecode t = { 0, 0, 0, 0 };
+	t.frame = (int)(index % fps);
+	index /= fps;
+	t.secs = (int)(index % 60);
+	index /= 60;
+	t.mins = (int)(index % 60);
+	t.hours = (int)(index / 60);
+	return t;
+}
+
+/** Advance or rewind the timecode by n_frames, wrapping around at 24h */
+constexpr Timecode advance(const Timecode &t, ltc_off_t n_frames, int fps, bool drop_frame) {
+	return index_to_timecode(timecode_to_index(t, fps, drop_frame) + n_frames, fps, drop_frame);
+}
+
+template <typename FrameRate>
+constexpr ltc_off_t timecode_to_index(const Timecode &t) {
+	return timecode_to_index(t, FrameRate::fps, FrameRate::drop_frame);
+}
+
+template <typename FrameRate>
+constexpr Timecode index_to_timecode(ltc_off_t index) {
+	return index_to_timecode(index, FrameRate::fps, FrameRate::drop_frame);
+}
+
+/** audio-samples per timecode-frame */
+template <typename FrameRate>
+constexpr double samples_per_frame(double sample_rate) {
+	return sample_rate * FrameRate::den / FrameRate::num;
+}
+
+/**
+ * Audio-sample position of the start of a frame, relative to frame 0.
+ * Computed exactly in integer arithmetic, rounded down.
+ */
+template <typename FrameRate>
+constexpr ltc_off_t frame_to_sample(ltc_off_t index, long sample_rate) {
+	const ltc_off_t p = index * (ltc_off_t)sample_rate * FrameRate::den;
+	return p >= 0 ? p / FrameRate::num : -((-p + FrameRate::num - 1) / FrameRate::num);
+}
+
+/** decimal timecode of an LTC frame, ignoring the date */
+inline Timecode to_timecode(const LTCFrame &f) {
+	Timecode t = {
+		(int)(f.hours_units + f.hours_tens * 10),
+		(int)(f.mins_units + f.mins_tens * 10),
+		(int)(f.secs_units + f.secs_tens * 10),
+		(int)(f.frame_units + f.frame_tens * 10)
+	};
+	return t;
+}
+
+/**
+ * Set the timecode of an LTC frame, including dfbit and parity.
+ * The date and other bits are not modified.
+ */
+template <typename FrameRate, LTC_TV_STANDARD Standard = default_standard<FrameRate> ()>
+inline void set_timecode(LTCFrame &f, const Timecode &t, int flags = 0) {
+	f.dfbit = FrameRate::drop_frame ? 1 : 0;
+	ltc_index_to_frame(&f, timecode_to_index<FrameRate>(t), FrameRate::fps, Standard, flags);
+}
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Decoder
+ */
+
+/**
+ * Owning handle of an \ref LTCDecoder.
+ *
+ * The constructor throws std::bad_alloc if the decoder cannot be created.
+ */
+class Decoder {
+public:
+	/** see \ref ltc_decoder_create_ex */
+	explicit Decoder(int apv, int queue_size = 32, int flags = 0)
+		: d_(ltc_decoder_create_ex(apv, queue_size, flags))
+	{
+		if (!d_) throw std::bad_alloc();
+	}
+
+	/** see \ref ltc_decoder_create_alloc */
+	Decoder(const LTCAllocator &allocator, int apv, int queue_size = 32, int flags = 0)
+		: d_(ltc_decoder_create_alloc(&allocator, apv, queue_size, flags))
+	{
+		if (!d_) throw std::bad_alloc();
+	}
+
+	~Decoder() {
+		if (d_) ltc_decoder_free(d_);
+	}
+
+	Decoder(const Decoder &) = delete;
+	Decoder &operator=(const Decoder &) = delete;
+
+	Decoder(Decoder &&other) noexcept : d_(other.d_) {
+		other.d_ = nullptr;
+	}
+
+	Decoder &operator=(Decoder &&other) noexcept {
+		std::swap(d_, other.d_);
+		return *this;
+	}
+
+	LTCDecoder *get() const noexcept { return d_; }
+
+	/**
+	 * Decode audio. The sample format is selected at compile time:
+	 * ltcsnd_sample_t (unsigned 8 bit), unsigned short, short, float or double.
+	 */
+	template <typename Sample>
+	void write(const Sample *buf, size_t size, ltc_off_t posinfo) {
+		if constexpr (std::is_same<Sample, ltcsnd_sample_t>::value) {
+			ltc_decoder_write(d_, const_cast<ltcsnd_sample_t *>(buf), size, posinfo);
+		} else if constexpr (std::is_same<Sample, unsigned short>::value) {
+			ltc_decoder_write_u16(d_, const_cast<unsigned short *>(buf), size, posinfo);
+		} else if constexpr (std::is_same<Sample, short>::value) {
+			ltc_decoder_write_s16(d_, const_cast<short *>(buf), size, posinfo);
+		} else if constexpr (std::is_same<Sample, float>::value) {
+			ltc_decoder_write_float(d_, const_cast<float *>(buf), size, posinfo);
+		} else if constexpr (std::is_same<Sample, double>::value) {
+			ltc_decoder_write_double(d_, const_cast<double *>(buf), size, posinfo);
+		} else {
+			static_assert(detail::dependent_false<Sample>::value, "unsupported sample format");
+		}
+	}
+
+	/** @return true if a frame was read, see \ref ltc_decoder_read */
+	bool read(LTCFrameExt &frame) { return ltc_decoder_read(d_, &frame) > 0; }
+	bool read(LTCFrameCompact &frame) { return ltc_decoder_read_compact(d_, &frame) > 0; }
+	/** see \ref ltc_decoder_read_early */
+	bool read_early(LTCFrameEarly &frame) { return ltc_decoder_read_early(d_, &frame) > 0; }
+
+	int queue_length() const { return ltc_decoder_queue_length(d_); }
+	void queue_flush() { ltc_decoder_queue_flush(d_); }
+	int reconfigure(int apv) { return ltc_decoder_reconfigure(d_, apv); }
+
+	LTCDecoderStats stats() const {
+		LTCDecoderStats s;
+		ltc_decoder_stats(d_, &s);
+		return s;
+	}
+
+	/** see \ref ltc_decoder_detect */
+	int detect(double sample_rate, double &fps, bool &drop_frame) const {
+		int df = 0;
+		const int rv = ltc_decoder_detect(d_, sample_rate, &fps, &df);
+		drop_frame = df != 0;
+		return rv;
+	}
+
+private:
+	LTCDecoder *d_;
+};
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Encoder
+ */
+
+/**
+ * Owning handle of an \ref LTCEncoder for a fixed TV standard.
+ *
+ * The constructor throws std::bad_alloc if the encoder cannot be created.
+ */
+template <LTC_TV_STANDARD Standard = LTC_TV_525_60>
+class Encoder {
+public:
+	static constexpr LTC_TV_STANDARD standard = Standard;
+
+	/** see \ref ltc_encoder_create */
+	Encoder(double sample_rate, double fps, int flags = 0)
+		: e_(ltc_encoder_create(sample_rate, fps, Standard, flags))
+	{
+		if (!e_) throw std::bad_alloc();
+	}
+
+	/** see \ref ltc_encoder_create_alloc */
+	Encoder(const LTCAllocator &allocator, double sample_rate, double fps, int flags = 0)
+		: e_(ltc_encoder_create_alloc(&allocator, sample_rate, fps, Standard, flags))
+	{
+		if (!e_) throw std::bad_alloc();
+	}
+
+	~Encoder() {
+		if (e_) ltc_encoder_free(e_);
+	}
+
+	Encoder(const Encoder &) = delete;
+	Encoder &operator=(const Encoder &) = delete;
+
+	Encoder(Encoder &&other) noexcept : e_(other.e_) {
+		other.e_ = nullptr;
+	}
+
+	Encoder &operator=(Encoder &&other) noexcept {
+		std::swap(e_, other.e_);
+		return *this;
+	}
+
+	LTCEncoder *get() const noexcept { return e_; }
+
+	int reinit(double sample_rate, double fps, int flags = 0) {
+		return ltc_encoder_reinit(e_, sample_rate, fps, Standard, flags);
+	}
+	int reconfigure(double sample_rate, double fps) { return ltc_encoder_reconfigure(e_, sample_rate, fps); }
+	void reset() { ltc_encoder_reset(e_); }
+
+	void set_timecode(const SMPTETimecode &t) { ltc_encoder_set_timecode(e_, const_cast<SMPTETimecode *>(&t)); }
+	SMPTETimecode timecode() const {
+		SMPTETimecode t;
+		ltc_encoder_get_timecode(e_, &t);
+		return t;
+	}
+
+	void set_frame(const LTCFrame &f) { ltc_encoder_set_frame(e_, const_cast<LTCFrame *>(&f)); }
+	LTCFrame frame() const {
+		LTCFrame f;
+		ltc_encoder_get_frame(e_, &f);
+		return f;
+	}
+
+	int inc_timecode() { return ltc_encoder_inc_timecode(e_); }
+	int dec_timecode() { return ltc_encoder_dec_timecode(e_); }
+
+	int set_volume(double dBFS) { return ltc_encoder_set_volume(e_, dBFS); }
+	void set_filter(double rise_time) { ltc_encoder_set_filter(e_, rise_time); }
+
+	/**
+	 * Render continuous LTC, see \ref ltc_encoder_render. The sample format
+	 * is selected at compile time: ltcsnd_sample_t, short or float.
+	 */
+	template <typename Sample>
+	void render(Sample *buf, size_t n_samples) {
+		if constexpr (std::is_same<Sample, ltcsnd_sample_t>::value) {
+			ltc_encoder_render(e_, buf, n_samples);
+		} else if constexpr (std::is_same<Sample, short>::value) {
+			ltc_encoder_render_s16(e_, buf, n_samples);
+		} else if constexpr (std::is_same<Sample, float>::value) {
+			ltc_encoder_render_float(e_, buf, n_samples);
+		} else {
+			static_assert(detail::dependent_false<Sample>::value, "unsupported sample format");
+		}
+	}
+
+	/** see \ref ltc_encoder_render_interleaved */
+	template <typename Sample>
+	void render_interleaved(Sample *buf, int stride, int channel, size_t n_samples) {
+		if constexpr (std::is_same<Sample, ltcsnd_sample_t>::value) {
+			ltc_encoder_render_interleaved(e_, buf, stride, channel, n_samples);
+		} else if constexpr (std::is_same<Sample, short>::value) {
+			ltc_encoder_render_interleaved_s16(e_, buf, stride, channel, n_samples);
+		} else if constexpr (std::is_same<Sample, float>::value) {
+			ltc_encoder_render_interleaved_float(e_, buf, stride, channel, n_samples);
+		} else {
+			static_assert(detail::dependent_false<Sample>::value, "unsupported sample format");
+		}
+	}
+
+	/** packed 24 bit variant of \ref render (3 * n_samples bytes) */
+	void render_s24(unsigned char *buf, size_t n_samples) { ltc_encoder_render_s24(e_, buf, n_samples); }
+
+	void render_reset(bool align = false) { ltc_encoder_render_reset(e_, align ? 1 : 0); }
+
+	/** see \ref ltc_encoder_encode_frames */
+	template <typename Sample>
+	size_t encode_frames(int n_frames, Sample *buf, size_t size) {
+		if constexpr (std::is_same<Sample, ltcsnd_sample_t>::value) {
+			return ltc_encoder_encode_frames(e_, n_frames, buf, size);
+		} else if constexpr (std::is_same<Sample, short>::value) {
+			return ltc_encoder_encode_frames_s16(e_, n_frames, buf, size);
+		} else if constexpr (std::is_same<Sample, float>::value) {
+			return ltc_encoder_encode_frames_float(e_, n_frames, buf, size);
+		} else {
+			static_assert(detail::dependent_false<Sample>::value, "unsupported sample format");
+			return 0;
+		}
+	}
+
+private:
+	LTCEncoder *e_;
+};
+
+/**
+ * LTC square-wave generator, specialized at compile time.
+ *
+ * This is a header-only equivalent of an \ref LTCEncoder without low-pass
+ * filter (\ref ltc_encoder_set_filter 0). Since sample format, sample-rate
+ * and framerate are template parameters, the samples per bit are constants
+ * and each bit is rendered by a fill without further branches.
+ *
+ * The output is identical to \ref ltc_encoder_encode_frame
+ * of an encoder with the same settings and volume.
+ *
+ * @tparam Sample ltcsnd_sample_t, short or float
+ * @tparam SampleRate audio sample-rate
+ * @tparam FrameRate a \ref Rate
+ * @tparam Standard TV standard for parity bit assignment
+ * @tparam Flags \ref LTC_BG_FLAGS used to increment the timecode
+ */
+template <typename Sample, long SampleRate, typename FrameRate,
+					LTC_TV_STANDARD Standard = default_standard<FrameRate> (), int Flags = 0>
+class SquareEncoder {
+	static_assert(std::is_same<Sample, ltcsnd_sample_t>::value
+			|| std::is_same<Sample, short>::value
+			|| std::is_same<Sample, float>::value, "unsupported sample format");
+
+public:
+	/** audio-samples per bit, computed as \ref ltc_encoder_create does */
+	static constexpr double samples_per_clock = SampleRate / (FrameRate::value * LTC_FRAME_BIT_COUNT);
+	static constexpr double samples_per_clock_2 = samples_per_clock / 2.0;
+	/** upper bound of samples produced by \ref encode_frame */
+	static constexpr size_t max_frame_samples = 1 + (size_t)(samples_per_clock * LTC_FRAME_BIT_COUNT + 1.0);
+
+	static_assert(samples_per_clock_2 >= 1.0, "sample-rate too low for the framerate");
+
+	SquareEncoder() {
+		std::memset(&f_, 0, sizeof(LTCFrame));
+		set_timecode(Timecode { 0, 0, 0, 0 });
+		set_volume(-3.0);
+		reset();
+	}
+
+	/** reset the biphase state, see \ref ltc_encoder_reset */
+	void reset() {
+		state_ = false;
+		remainder_ = 0.5;
+	}
+
+	/** see \ref ltc_encoder_set_volume */
+	int set_volume(double dBFS) {
+		if (dBFS > 0) return -1;
+		const double level = std::pow(10.0, dBFS / 20.0);
+		const double pp = std::rint(127.0 * level);
+		if (pp < 1 || pp > 127) return -1;
+		if constexpr (std::is_same<Sample, ltcsnd_sample_t>::value) {
+			hi_ = (ltcsnd_sample_t) (128 + (int) pp);
+			lo_ = (ltcsnd_sample_t) (128 - (int) pp);
+		} else if constexpr (std::is_same<Sample, short>::value) {
+			const float l = (float) level;
+			hi_ = (short) (l * 32767.f + .5f);
+			lo_ = (short) (-l * 32767.f - .5f);
+		} else {
+			hi_ = (float) level;
+			lo_ = (float) -level;
+		}
+		return 0;
+	}
+
+	void set_frame(const LTCFrame &f) { f_ = f; }
+	const LTCFrame &frame() const { return f_; }
+
+	void set_timecode(const Timecode &t) { ltc::set_timecode<FrameRate, Standard>(f_, t, Flags); }
+	Timecode timecode() const { return to_timecode(f_); }
+
+	/** @return 1 if the timecode wrapped around at 24h, see \ref ltc_frame_increment */
+	int increment() { return ltc_frame_increment(&f_, FrameRate::fps, Standard, Flags); }
+
+	/**
+	 * Encode the current frame.
+	 *
+	 * @param out destination, must hold \ref max_frame_samples
+	 * @return number of samples written
+	 */
+	size_t encode_frame(Sample *out) {
+		const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&f_);
+		size_t off = 0;
+		for (int i = 0; i < LTC_FRAME_BIT_COUNT; ++i) {
+			const int bit = (bytes[i >> 3] >> (i & 7)) & 1;
+			/* a '1' is two half-clock edges, a '0' one full clock */
+			const double len = bit ? samples_per_clock_2 : samples_per_clock;
+			for (int h = 0; h <= bit; ++h) {
+				const int n = (int) (len + remainder_);
+				remainder_ = len + remainder_ - n;
+				state_ = !state_;
+				std::fill_n(&out[off], n, state_ ? hi_ : lo_);
+				off += n;
+			}
+		}
+		return off;
+	}
+
+	/**
+	 * Encode n_frames consecutive frames, incrementing the timecode after each.
+	 *
+	 * @param out destination, must hold n_frames * \ref max_frame_samples
+	 * @return number of samples written
+	 */
+	size_t encode_frames(int n_frames, Sample *out) {
+		size_t off = 0;
+		for (int i = 0; i < n_frames; ++i) {
+			off += encode_frame(&out[off]);
+			increment();
+		}
+		return off;
+	}
+
+private:
+	LTCFrame f_;
+	double remainder_;
+	bool state_;
+	Sample hi_;
+	Sample lo_;
+};
+
+} /* namespace ltc */
+
+#endif
@@ -0,0 +1,227 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "ltc.h"
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Frame serialization
+ *
+ * header: "LTCP", version (u8), fields (u8), frame count (varint)
+ * per frame:
+ *   10 bytes LTCFrame, in the order the bits are transmitted
+ *   flags (u8): bit 0 reverse
+ *   LTC_PACKET_OFFSETS: off_start relative to the previous frame's
+ *     off_end + 1 (signed varint), off_end - off_start (signed varint)
+ *   LTC_PACKET_QUALITY: sample_min, sample_max (u8), volume (float32 LE)
+ *
+ * Varints are little-endian base-128, signed values are zigzag encoded.
+ */
+
+#define LTC_PACKET_MAGIC "LTCP"
+#define LTC_PACKET_HEADER 6
+#define LTC_FRAME_BYTES (LTC_FRAME_BIT_COUNT / 8)
+
+/** maximum length of a 64 bit varint */
+#define VARINT_MAX 10
+
+#define PACKET_FIELDS (LTC_PACKET_OFFSETS | LTC_PACKET_QUALITY)
+
+static size_t wr_varint(unsigned char *p, uint64_t v) {
+	size_t n = 0;
+	while (v >= 0x80) {
+		p[n++] = (v & 0x7f) | 0x80;
+		v >>= 7;
+	}
+	p[n++] = v;
+	return n;
+}
+
+/** @return number of bytes read, 0 if the varint is truncated or too long */
+static size_t rd_varint(const unsigned char *p, size_t size, uint64_t *v) {
+	size_t n = 0;
+	*v = 0;
+	while (n < size && n < VARINT_MAX) {
+		*v |= (uint64_t)(p[n] & 0x7f) << (7 * n);
+		if (!(p[n++] & 0x80)) {
+			return n;
+		}
+	}
+	return 0;
+}
+
+static uint64_t zigzag(ltc_off_t v) {
+	return ((uint64_t)v << 1) ^ (uint64_t)(v < 0 ? -1 : 0);
+}
+
+static ltc_off_t unzigzag(uint64_t v) {
+	return (ltc_off_t)(v >> 1) ^ -(ltc_off_t)(v & 1);
+}
+
+static void wr_float(unsigned char *p, float f) {
+	uint32_t v;
+	memcpy(&v, &f, 4);
+	p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static float rd_float(const unsigned char *p) {
+	const uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+	float f;
+	memcpy(&f, &v, 4);
+	return f;
+}
+
+static size_t frame_size_max(int fields) {
+	size_t n = LTC_FRAME_BYTES + 1;
+	if (fields & LTC_PACKET_OFFSETS) n += 2 * VARINT_MAX;
+	if (fields & LTC_PACKET_QUALITY) n += 6;
+	return n;
+}
+
+/** parse the header, @return header length, 0 on error */
+static size_t read_header(const unsigned char *buf, size_t size, int *fields, int *count) {
+	uint64_t n;
+	size_t len;
+	if (size < LTC_PACKET_HEADER + 1 || memcmp(buf, LTC_PACKET_MAGIC, 4)) {
+		return 0;
+	}
+	if (buf[4] != LTC_PACKET_VERSION || (buf[5] & ~PACKET_FIELDS)) {
+		return 0;
+	}
+	len = rd_varint(&buf[LTC_PACKET_HEADER], size - LTC_PACKET_HEADER, &n);
+	if (len == 0 || n > 0x7fffffff) {
+		return 0;
+	}
+	*fields = buf[5];
+	*count = n;
+	return LTC_PACKET_HEADER + len;
+}
+
+size_t ltc_frames_packed_size(int count, int fields) {
+	if (count < 0) return 0;
+	return LTC_PACKET_HEADER + 5 + count * frame_size_max(fields & PACKET_FIELDS);
+}
+
+size_t ltc_frames_pack(unsigned char *buf, size_t size, const LTCFrameExt *frames, int count, int fields) {
+	const size_t frame_max = frame_size_max(fields & PACKET_FIELDS);
+	ltc_off_t next = 0;
+	size_t off;
+	int i;
+
+	if (!buf || count < 0 || (count > 0 && !frames) || (fields & ~PACKET_FIELDS)) {
+		return 0;
+	}
+	if (size < LTC_PACKET_HEADER + 5) {
+		return 0;
+	}
+
+	memcpy(buf, LTC_PACKET_MAGIC, 4);
+	buf[4] = LTC_PACKET_VERSION;
+	buf[5] = fields;
+	off = LTC_PACKET_HEADER + wr_varint(&buf[LTC_PACKET_HEADER], count);
+
+	for (i = 0; i < count; ++i) {
+		const LTCFrameExt *f = &frames[i];
+		if (size - off < frame_max) {
+			return 0;
+		}
+		memcpy(&buf[off], &f->ltc, LTC_FRAME_BYTES);
+		off += LTC_FRAME_BYTES;
+		buf[off++] = f->reverse ? 1 : 0;
+		if (fields & LTC_PACKET_OFFSETS) {
+			off += wr_varint(&buf[off], zigzag(f->off_start - next));
+			off += wr_varint(&buf[off], zigzag(f->off_end - f->off_start));
+			next = f->off_end + 1;
+		}
+		if (fields & LTC_PACKET_QUALITY) {
+			buf[off++] = f->sample_min;
+			buf[off++] = f->sample_max;
+			wr_float(&buf[off], f->volume);
+			off += 4;
+		}
+	}
+	return off;
+}
+
+int ltc_frames_packed_count(const unsigned char *buf, size_t size) {
+	int fields, count;
+	if (!buf || !read_header(buf, size, &fields, &count)) {
+		return -1;
+	}
+	return count;
+}
+
+int ltc_frames_unpack(LTCFrameExt *frames, int count, const unsigned char *buf, size_t size, int *fields) {
+	ltc_off_t next = 0;
+	size_t off;
+	int i, n, flags;
+
+	if (!buf || !(off = read_header(buf, size, &flags, &n)) || n > count || (n > 0 && !frames)) {
+		return -1;
+	}
+
+	for (i = 0; i < n; ++i) {
+		LTCFrameExt *f = &frames[i];
+		uint64_t v;
+		size_t len;
+
+		if (size - off < LTC_FRAME_BYTES + 1) {
+			return -1;
+		}
+		memset(f, 0, sizeof(LTCFrameExt));
+		memcpy(&f->ltc, &buf[off], LTC_FRAME_BYTES);
+		off += LTC_FRAME_BYTES;
+		f->reverse = buf[off++] & 1;
+
+		if (flags & LTC_PACKET_OFFSETS) {
+			if (!(len = rd_varint(&buf[off], size - off, &v))) {
+				return -1;
+			}
+			off += len;
+			f->off_start = next + unzigzag(v);
+			if (!(len = rd_varint(&buf[off], size - off, &v))) {
+				return -1;
+			}
+			off += len;
+			f->off_end = f->off_start + unzigzag(v);
+			next = f->off_end + 1;
+		}
+		if (flags & LTC_PACKET_QUALITY) {
+			if (size - off < 6) {
+				return -1;
+			}
+			f->sample_min = buf[off];
+			f->sample_max = buf[off + 1];
+			f->volume = rd_float(&buf[off + 2]);
+			off += 6;
+		}
+	}
+
+	if (fields) {
+		*fields = flags;
+	}
+	return n;
+}
@@ -0,0 +1,186 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include "pool.h"
+
+#if defined HAVE_PTHREAD_H && !defined LTC_NO_THREADS
+#include <pthread.h>
+
+/*
+ * Workers wait for the generation counter to change, process
+ * their job and the last one to finish signals completion.
+ */
+
+struct LTCPool {
+	int n_jobs;
+	pthread_t *threads;
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	pthread_cond_t done;
+	unsigned int generation;
+	int pending;
+	int quit;
+	pool_job fn;
+	void *arg;
+};
+
+struct LTCPoolWorker {
+	LTCPool *p;
+	int job;
+};
+
+static void* pool_worker(void *data) {
+	LTCPool *p = ((struct LTCPoolWorker*)data)->p;
+	const int job = ((struct LTCPoolWorker*)data)->job;
+	unsigned int generation = 0;
+	free(data);
+
+	pthread_mutex_lock(&p->lock);
+	for (;;) {
+		while (p->generation == generation && !p->quit) {
+			pthread_cond_wait(&p->wake, &p->lock);
+		}
+		if (p->quit) {
+			break;
+		}
+		generation = p->generation;
+		pthread_mutex_unlock(&p->lock);
+
+		p->fn(p->arg, job, p->n_jobs);
+
+		pthread_mutex_lock(&p->lock);
+		if (--p->pending == 0) {
+			pthread_cond_signal(&p->done);
+		}
+	}
+	pthread_mutex_unlock(&p->lock);
+	return NULL;
+}
+
+static void pool_stop(LTCPool *p, int n_threads) {
+	int i;
+	pthread_mutex_lock(&p->lock);
+	p->quit = 1;
+	pthread_cond_broadcast(&p->wake);
+	pthread_mutex_unlock(&p->lock);
+	for (i = 0; i < n_threads; ++i) {
+		pthread_join(p->threads[i], NULL);
+	}
+}
+
+LTCPool* pool_create(int n_jobs) {
+	LTCPool *p;
+	int i;
+
+	if (n_jobs < 2) return NULL;
+
+	p = (LTCPool*) calloc(1, sizeof(LTCPool));
+	if (!p) return NULL;
+
+	p->threads = (pthread_t*) calloc(n_jobs - 1, sizeof(pthread_t));
+	if (!p->threads) {
+		free(p);
+		return NULL;
+	}
+
+	p->n_jobs = n_jobs;
+	pthread_mutex_init(&p->lock, NULL);
+	pthread_cond_init(&p->wake, NULL);
+	pthread_cond_init(&p->done, NULL);
+
+	for (i = 0; i < n_jobs - 1; ++i) {
+		struct LTCPoolWorker *w = (struct LTCPoolWorker*) malloc(sizeof(struct LTCPoolWorker));
+		if (w) {
+			w->p = p;
+			w->job = i + 1;
+		}
+		if (!w || pthread_create(&p->threads[i], NULL, pool_worker, w)) {
+			free(w);
+			pool_stop(p, i);
+			p->n_jobs = 0;
+			pool_free(p);
+			return NULL;
+		}
+	}
+	return p;
+}
+
+void pool_free(LTCPool *p) {
+	if (!p) return;
+	if (p->n_jobs > 0) {
+		pool_stop(p, p->n_jobs - 1);
+	}
+	pthread_cond_destroy(&p->done);
+	pthread_cond_destroy(&p->wake);
+	pthread_mutex_destroy(&p->lock);
+	free(p->threads);
+	free(p);
+}
+
+int pool_size(LTCPool *p) {
+	return p ? p->n_jobs : 1;
+}
+
+void pool_run(LTCPool *p, pool_job fn, void *arg) {
+	if (!p) {
+		fn(arg, 0, 1);
+		return;
+	}
+
+	pthread_mutex_lock(&p->lock);
+	p->fn = fn;
+	p->arg = arg;
+	p->pending = p->n_jobs - 1;
+	p->generation++;
+	pthread_cond_broadcast(&p->wake);
+	pthread_mutex_unlock(&p->lock);
+
+	fn(arg, 0, p->n_jobs);
+
+	pthread_mutex_lock(&p->lock);
+	while (p->pending > 0) {
+		pthread_cond_wait(&p->done, &p->lock);
+	}
+	pthread_mutex_unlock(&p->lock);
+}
+
+#else /* no threads */
+
+LTCPool* pool_create(int n_jobs) {
+	return NULL;
+}
+
+void pool_free(LTCPool *p) {
+}
+
+int pool_size(LTCPool *p) {
+	return 1;
+}
+
+void pool_run(LTCPool *p, pool_job fn, void *arg) {
+	fn(arg, 0, 1);
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LTC_POOL_H
+#define LTC_POOL_H 1
+
+typedef struct LTCPool LTCPool;
+
+/** job callback, called once for every index 0 <= job < n_jobs */
+typedef void (*pool_job)(void *arg, int job, int n_jobs);
+
+/**
+ * Create a pool of worker threads.
+ *
+ * The calling thread takes part in processing, so a pool with
+ * n_jobs concurrent jobs spawns n_jobs - 1 threads.
+ * Returns NULL if n_jobs < 2, threads are not supported
+ * or thread creation failed.
+ */
+LTCPool* pool_create(int n_jobs);
+
+void pool_free(LTCPool *p);
+
+/** number of concurrent jobs of the pool */
+int pool_size(LTCPool *p);
+
+/**
+ * Run fn(arg, job, n_jobs) for all jobs of the pool and wait for completion.
+ * If p is NULL, fn(arg, 0, 1) is called in the calling thread.
+ */
+void pool_run(LTCPool *p, pool_job fn, void *arg);
+
+#endif
@@ -0,0 +1,302 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined HAVE_SHM_OPEN && defined HAVE_SYS_MMAN_H && defined HAVE_UNISTD_H && !defined _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# define LTC_SHM
+#endif
+
+#include "publisher.h"
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Shared memory frame publisher
+ *
+ * A single publisher writes frames to a ring of seqlock protected slots,
+ * any number of subscribers in other processes poll the ring. Subscribers
+ * only read the shared memory, they never block the publisher: a slow
+ * subscriber loses the oldest frames.
+ */
+
+#ifdef LTC_SHM
+
+static size_t shm_length(uint32_t queue_len) {
+	return sizeof(struct LTCShmHeader) + queue_len * sizeof(struct LTCShmSlot);
+}
+
+/** the name still refers to the publisher's object, it has not been replaced */
+static int shm_owned(const LTCPublisher *p) {
+	struct stat st;
+	const int fd = shm_open(p->name, O_RDONLY, 0);
+	int rv;
+	if (fd < 0) {
+		return 0;
+	}
+	rv = !fstat(fd, &st) && (unsigned long long) st.st_dev == p->dev && (unsigned long long) st.st_ino == p->ino;
+	close(fd);
+	return rv;
+}
+
+LTCPublisher* ltc_publisher_create(const char *name, int queue_size, int flags) {
+	LTCPublisher *p;
+	uint32_t len = 1;
+	struct stat st;
+	void *map;
+	int fd;
+
+	if (!name || queue_size < 1 || queue_size > (1 << 20)) {
+		return NULL;
+	}
+	while (len < (uint32_t) queue_size) {
+		len <<= 1;
+	}
+
+	p = (LTCPublisher*) calloc(1, sizeof(LTCPublisher));
+	if (!p) {
+		return NULL;
+	}
+	p->name = strdup(name);
+	p->queue_len = len;
+	p->map_len = shm_length(len);
+
+	if (flags & LTC_PUBLISHER_REPLACE) {
+		/* subscribers of the replaced object keep their mapping */
+		shm_unlink(name);
+	}
+	fd = p->name ? shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644) : -1;
+	if (fd < 0) {
+		free(p->name);
+		free(p);
+		return NULL;
+	}
+	if (fstat(fd, &st) || ftruncate(fd, p->map_len)
+			|| (map = mmap(NULL, p->map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		close(fd);
+		shm_unlink(name);
+		free(p->name);
+		free(p);
+		return NULL;
+	}
+	close(fd);
+
+	p->dev = st.st_dev;
+	p->ino = st.st_ino;
+	p->shm = (struct LTCShmHeader*) map;
+	p->slots = (struct LTCShmSlot*) &p->shm[1];
+	p->shm->version = LTC_SHM_VERSION;
+	p->shm->frame_size = sizeof(LTCFrameExt);
+	p->shm->slot_size = sizeof(struct LTCShmSlot);
+	p->shm->queue_len = len;
+	ltc_atomic_store_release(&p->shm->magic, LTC_SHM_MAGIC);
+	return p;
+}
+
+void ltc_publisher_free(LTCPublisher *p) {
+	if (!p) return;
+	if (shm_owned(p)) {
+		shm_unlink(p->name);
+	}
+	munmap(p->shm, p->map_len);
+	free(p->name);
+	free(p);
+}
+
+void ltc_publisher_write(LTCPublisher *p, const LTCFrameExt *frame) {
+	const uint32_t n = p->write_count;
+	struct LTCShmSlot *s = &p->slots[n & (p->queue_len - 1)];
+
+	ltc_atomic_store_relaxed(&s->seq, 2 * n + 1);
+	ltc_atomic_fence_release();
+	memcpy(&s->frame, frame, sizeof(LTCFrameExt));
+	ltc_atomic_store_release(&s->seq, 2 * n + 2);
+
+	p->write_count = n + 1;
+	ltc_atomic_store_release(&p->shm->write_count, n + 1);
+}
+
+int ltc_publisher_forward(LTCPublisher *p, LTCDecoder *d) {
+	LTCFrameExt frame;
+	int n = 0;
+	while (ltc_decoder_read(d, &frame)) {
+		ltc_publisher_write(p, &frame);
+		++n;
+	}
+	return n;
+}
+
+LTCSubscriber* ltc_subscriber_open(const char *name) {
+	LTCSubscriber *s;
+	struct LTCShmHeader *h;
+	struct stat st;
+	void *map;
+	int fd;
+
+	if (!name || (fd = shm_open(name, O_RDONLY, 0)) < 0) {
+		return NULL;
+	}
+	if (fstat(fd, &st) || st.st_size < (off_t) sizeof(struct LTCShmHeader)
+			|| (map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		close(fd);
+		return NULL;
+	}
+	close(fd);
+
+	h = (struct LTCShmHeader*) map;
+	if (ltc_atomic_load_acquire(&h->magic) != LTC_SHM_MAGIC
+			|| h->version != LTC_SHM_VERSION
+			|| h->frame_size != sizeof(LTCFrameExt)
+			|| h->slot_size != sizeof(struct LTCShmSlot)
+			|| h->queue_len == 0 || (h->queue_len & (h->queue_len - 1))
+			|| (size_t) st.st_size < shm_length(h->queue_len)
+			|| !(s = (LTCSubscriber*) calloc(1, sizeof(LTCSubscriber)))) {
+		munmap(map, st.st_size);
+		return NULL;
+	}
+
+	s->shm = h;
+	s->slots = (struct LTCShmSlot*) &h[1];
+	s->map_len = st.st_size;
+	s->queue_len = h->queue_len;
+	s->next = ltc_atomic_load_acquire(&s->shm->write_count);
+	return s;
+}
+
+void ltc_subscriber_close(LTCSubscriber *s) {
+	if (!s) return;
+	munmap(s->shm, s->map_len);
+	free(s);
+}
+
+/**
+ * copy the n-th frame.
+ * @return 0 on success, 1 if the slot was overwritten by a later frame,
+ * -1 if it is being written
+ */
+static int read_slot(LTCSubscriber *s, uint32_t n, LTCFrameExt *frame) {
+	struct LTCShmSlot *slot = &s->slots[n & (s->queue_len - 1)];
+	const uint32_t expect = 2 * n + 2;
+	int i;
+
+	for (i = 0; i < LTC_SHM_RETRY; ++i) {
+		const uint32_t seq = ltc_atomic_load_acquire(&slot->seq);
+		if (seq & 1) {
+			continue;
+		}
+		if (seq != expect) {
+			return 1;
+		}
+		memcpy(frame, &slot->frame, sizeof(LTCFrameExt));
+		ltc_atomic_fence_acquire();
+		if (ltc_atomic_load_relaxed(&slot->seq) == expect) {
+			return 0;
+		}
+	}
+	return -1;
+}
+
+int ltc_subscriber_read(LTCSubscriber *s, LTCFrameExt *frame) {
+	int i;
+	for (i = 0; i < LTC_SHM_RETRY; ++i) {
+		const uint32_t w = ltc_atomic_load_acquire(&s->shm->write_count);
+		int rv;
+		if (w == s->next) {
+			return 0;
+		}
+		if (w - s->next > s->queue_len) {
+			s->overruns += w - s->next - s->queue_len;
+			s->next = w - s->queue_len;
+		}
+		rv = read_slot(s, s->next, frame);
+		if (rv == 0) {
+			++s->next;
+			return 1;
+		}
+		if (rv < 0) {
+			return 0;
+		}
+		/* overwritten while reading, skip ahead */
+	}
+	return 0;
+}
+
+int ltc_subscriber_latest(LTCSubscriber *s, LTCFrameExt *frame) {
+	int i;
+	for (i = 0; i < LTC_SHM_RETRY; ++i) {
+		const uint32_t w = ltc_atomic_load_acquire(&s->shm->write_count);
+		if (w == s->next) {
+			return 0;
+		}
+		if (read_slot(s, w - 1, frame) == 0) {
+			s->next = w;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+unsigned int ltc_subscriber_overruns(LTCSubscriber *s) {
+	return s->overruns;
+}
+
+#else /* no POSIX shared memory */
+
+LTCPublisher* ltc_publisher_create(const char *name, int queue_size, int flags) {
+	return NULL;
+}
+
+void ltc_publisher_free(LTCPublisher *p) {
+}
+
+void ltc_publisher_write(LTCPublisher *p, const LTCFrameExt *frame) {
+}
+
+int ltc_publisher_forward(LTCPublisher *p, LTCDecoder *d) {
+	return -1;
+}
+
+LTCSubscriber* ltc_subscriber_open(const char *name) {
+	return NULL;
+}
+
+void ltc_subscriber_close(LTCSubscriber *s) {
+}
+
+int ltc_subscriber_read(LTCSubscriber *s, LTCFrameExt *frame) {
+	return 0;
+}
+
+int ltc_subscriber_latest(LTCSubscriber *s, LTCFrameExt *frame) {
+	return 0;
+}
+
+unsigned int ltc_subscriber_overruns(LTCSubscriber *s) {
+	return 0;
+}
+
+#endif
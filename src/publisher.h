@@ -0,0 +1,76 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LTC_PUBLISHER_H
+#define LTC_PUBLISHER_H 1
+
+#include <stdint.h>
+#include "decoder.h"
+
+/** shared memory layout, "LTCS" little-endian in the magic field */
+#define LTC_SHM_MAGIC 0x5343544c
+#define LTC_SHM_VERSION 1
+/** reader attempts before a slot that is being written is given up */
+#define LTC_SHM_RETRY 64
+
+/**
+ * Header of the shared memory object, followed by queue_len slots.
+ * The magic is stored last, when the header is complete.
+ */
+struct LTCShmHeader {
+	ltc_atomic_t magic;
+	uint32_t version;
+	uint32_t frame_size; ///< sizeof(LTCFrameExt) of the publisher
+	uint32_t slot_size; ///< sizeof(struct LTCShmSlot) of the publisher
+	uint32_t queue_len;
+	ltc_atomic_t write_count; ///< number of published frames, wraps around
+	char pad[40]; ///< keep the slots on a separate cache-line
+};
+
+/**
+ * Seqlock protected frame: seq is odd while the frame is written,
+ * after publishing the n-th frame (counting from zero) it is 2 * n + 2.
+ */
+struct LTCShmSlot {
+	ltc_atomic_t seq;
+	LTCFrameExt frame;
+};
+
+struct LTCPublisher {
+	char *name;
+	struct LTCShmHeader *shm;
+	struct LTCShmSlot *slots;
+	size_t map_len;
+	uint32_t queue_len;
+	uint32_t write_count;
+	unsigned long long dev; ///< identity of the shared memory object, see fstat(2)
+	unsigned long long ino;
+};
+
+struct LTCSubscriber {
+	struct LTCShmHeader *shm; ///< mapped read-only
+	struct LTCShmSlot *slots;
+	size_t map_len;
+	uint32_t queue_len;
+	uint32_t next; ///< number of the next frame to read
+	unsigned int overruns; ///< frames that were overwritten before they were read
+};
+
+#endif
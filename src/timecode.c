@@ -23,109 +23,90 @@
 #include <string.h>
 
 #include "ltc.h"
+#include "timecode.h"
 
 #ifdef HAVE_CONFIG_H
 # include <config.h>
 #endif
 
-/**
- * SMPTE Timezones
- */
-struct SMPTETimeZonesStruct {
-	unsigned char code; //actually 6 bit!
-	char timezone[6];
-};
-
 /**
  * SMPTE Timezone codes as per http://www.barney-wol.net/time/timecode.html
+ *
+ * The table is indexed by the 6 bit code. Reserved and unknown codes map
+ * to "+0000".
  */
-static const struct SMPTETimeZonesStruct smpte_time_zones[] =
+static const char smpte_time_zones[64][6] =
 {
-    /*  code,   timezone (UTC+)     //Standard time                 //Daylight saving   */
-    {   0x00,   "+0000"             /* Greenwich */                 /* - */             },
-    {   0x00,   "-0000"             /* Greenwich */                 /* - */             },
-    {   0x01,   "-0100"             /* Azores */                    /* - */             },
-    {   0x02,   "-0200"             /* Mid-Atlantic */              /* - */             },
-    {   0x03,   "-0300"             /* Buenos Aires */              /* Halifax */       },
-    {   0x04,   "-0400"             /* Halifax */                   /* New York */      },
-    {   0x05,   "-0500"             /* New York */                  /* Chicago */       },
-    {   0x06,   "-0600"             /* Chicago Denver */            /* - */             },
-    {   0x07,   "-0700"             /* Denver */                    /* Los Angeles */   },
-    {   0x08,   "-0800"             /* Los Angeles */               /* - */             },
-    {   0x09,   "-0900"             /* Alaska */                    /* - */             },
-    {   0x10,   "-1000"             /* Hawaii */                    /* - */             },
-    {   0x11,   "-1100"             /* Midway Island */             /* - */             },
-    {   0x12,   "-1200"             /* Kwaialein */                 /* - */             },
-    {   0x13,   "+1300"             /* - */                         /* New Zealand */   },
-    {   0x14,   "+1200"             /* New Zealand */               /* - */             },
-    {   0x15,   "+1100"             /* Solomon Islands */           /* - */             },
-    {   0x16,   "+1000"             /* Guam */                      /* - */             },
-    {   0x17,   "+0900"             /* Tokyo */                     /* - */             },
-    {   0x18,   "+0800"             /* Beijing */                   /* - */             },
-    {   0x19,   "+0700"             /* Bangkok */                   /* - */             },
-    {   0x20,   "+0600"             /* Dhaka */                     /* - */             },
-    {   0x21,   "+0500"             /* Islamabad */                 /* - */             },
-    {   0x22,   "+0400"             /* Abu Dhabi */                 /* - */             },
-    {   0x23,   "+0300"             /* Moscow */                    /* - */             },
-    {   0x24,   "+0200"             /* Eastern Europe */            /* - */             },
-    {   0x25,   "+0100"             /* Central Europe */            /* - */             },
-/*  {   0x26,   "Undefined"         Reserved; do not use                                },*/
-/*  {   0x27,   "Undefined"         Reserved; do not use                                },*/
-    {   0x28,   "TP-03"             /* Time precision class 3 */    /* - */             },
-    {   0x29,   "TP-02"             /* Time precision class 2 */    /* - */             },
-    {   0x30,   "TP-01"             /* Time precision class 1 */    /* - */             },
-    {   0x31,   "TP-00"             /* Time precision class 0 */    /* - */             },
-    {   0x0A,   "-0030"             /* - */                         /* - */             },
-    {   0x0B,   "-0130"             /* - */                         /* - */             },
-    {   0x0C,   "-0230"             /* - */                         /* Newfoundland */  },
-    {   0x0D,   "-0330"             /* Newfoundland */              /* - */             },
-    {   0x0E,   "-0430"             /* - */                         /* - */             },
-    {   0x0F,   "-0530"             /* - */                         /* - */             },
-    {   0x1A,   "-0630"             /* - */                         /* - */             },
-    {   0x1B,   "-0730"             /* - */                         /* - */             },
-    {   0x1C,   "-0830"             /* - */                         /* - */             },
-    {   0x1D,   "-0930"             /* Marquesa Islands */          /* - */             },
-    {   0x1E,   "-1030"             /* - */                         /* - */             },
-    {   0x1F,   "-1130"             /* - */                         /* - */             },
-    {   0x2A,   "+1130"             /* Norfolk Island */            /* - */             },
-    {   0x2B,   "+1030"             /* Lord Howe Is. */             /* - */             },
-    {   0x2C,   "+0930"             /* Darwin */                    /* - */             },
-    {   0x2D,   "+0830"             /* - */                         /* - */             },
-    {   0x2E,   "+0730"             /* - */                         /* - */             },
-    {   0x2F,   "+0630"             /* Rangoon */                   /* - */             },
-    {   0x3A,   "+0530"             /* Bombay */                    /* - */             },
-    {   0x3B,   "+0430"             /* Kabul */                     /* - */             },
-    {   0x3C,   "+0330"             /* Tehran */                    /* - */             },
-    {   0x3D,   "+0230"             /* - */                         /* - */             },
-    {   0x3E,   "+0130"             /* - */                         /* - */             },
-    {   0x3F,   "+0030"             /* - */                         /* - */             },
-    {   0x32,   "+1245"             /* Chatham Island */            /* - */             },
-/*  {   0x33,   "Undefined"         Reserved; do not use                                },*/
-/*  {   0x34,   "Undefined"         Reserved; do not use                                },*/
-/*  {   0x35,   "Undefined"         Reserved; do not use                                },*/
-/*  {   0x36,   "Undefined"         Reserved; do not use                                },*/
-/*  {   0x37,   "Undefined"         Reserved; do not use                                },*/
-    {   0x38,   "+XXXX"             /* User defined time offset */  /* - */             },
-/*  {   0x39,   "Undefined"         Unknown                         Unknown             },*/
-/*  {   0x39,   "Undefined"         Unknown                         Unknown             },*/
-
-    {   0xFF,   ""                  /* The End */                                       }
+    /* code     timezone (UTC+)     //Standard time                 //Daylight saving   */
+    /* 0x00 */ "+0000",           /* Greenwich */                 /* -                */
+    /* 0x01 */ "-0100",           /* Azores */                    /* -                */
+    /* 0x02 */ "-0200",           /* Mid-Atlantic */              /* -                */
+    /* 0x03 */ "-0300",           /* Buenos Aires */              /* Halifax          */
+    /* 0x04 */ "-0400",           /* Halifax */                   /* New York         */
+    /* 0x05 */ "-0500",           /* New York */                  /* Chicago          */
+    /* 0x06 */ "-0600",           /* Chicago Denver */            /* -                */
+    /* 0x07 */ "-0700",           /* Denver */                    /* Los Angeles      */
+    /* 0x08 */ "-0800",           /* Los Angeles */               /* -                */
+    /* 0x09 */ "-0900",           /* Alaska */                    /* -                */
+    /* 0x0A */ "-0030",           /* - */                         /* -                */
+    /* 0x0B */ "-0130",           /* - */                         /* -                */
+    /* 0x0C */ "-0230",           /* - */                         /* Newfoundland     */
+    /* 0x0D */ "-0330",           /* Newfoundland */              /* -                */
+    /* 0x0E */ "-0430",           /* - */                         /* -                */
+    /* 0x0F */ "-0530",           /* - */                         /* -                */
+    /* 0x10 */ "-1000",           /* Hawaii */                    /* -                */
+    /* 0x11 */ "-1100",           /* Midway Island */             /* -                */
+    /* 0x12 */ "-1200",           /* Kwaialein */                 /* -                */
+    /* 0x13 */ "+1300",           /* - */                         /* New Zealand      */
+    /* 0x14 */ "+1200",           /* New Zealand */               /* -                */
+    /* 0x15 */ "+1100",           /* Solomon Islands */           /* -                */
+    /* 0x16 */ "+1000",           /* Guam */                      /* -                */
+    /* 0x17 */ "+0900",           /* Tokyo */                     /* -                */
+    /* 0x18 */ "+0800",           /* Beijing */                   /* -                */
+    /* 0x19 */ "+0700",           /* Bangkok */                   /* -                */
+    /* 0x1A */ "-0630",           /* - */                         /* -                */
+    /* 0x1B */ "-0730",           /* - */                         /* -                */
+    /* 0x1C */ "-0830",           /* - */                         /* -                */
+    /* 0x1D */ "-0930",           /* Marquesa Islands */          /* -                */
+    /* 0x1E */ "-1030",           /* - */                         /* -                */
+    /* 0x1F */ "-1130",           /* - */                         /* -                */
+    /* 0x20 */ "+0600",           /* Dhaka */                     /* -                */
+    /* 0x21 */ "+0500",           /* Islamabad */                 /* -                */
+    /* 0x22 */ "+0400",           /* Abu Dhabi */                 /* -                */
+    /* 0x23 */ "+0300",           /* Moscow */                    /* -                */
+    /* 0x24 */ "+0200",           /* Eastern Europe */            /* -                */
+    /* 0x25 */ "+0100",           /* Central Europe */            /* -                */
+    /* 0x26 */ "+0000",           /* Reserved; do not use */      /* -                */
+    /* 0x27 */ "+0000",           /* Reserved; do not use */      /* -                */
+    /* 0x28 */ "TP-03",           /* Time precision class 3 */    /* -                */
+    /* 0x29 */ "TP-02",           /* Time precision class 2 */    /* -                */
+    /* 0x2A */ "+1130",           /* Norfolk Island */            /* -                */
+    /* 0x2B */ "+1030",           /* Lord Howe Is. */             /* -                */
+    /* 0x2C */ "+0930",           /* Darwin */                    /* -                */
+    /* 0x2D */ "+0830",           /* - */                         /* -                */
+    /* 0x2E */ "+0730",           /* - */                         /* -                */
+    /* 0x2F */ "+0630",           /* Rangoon */                   /* -                */
+    /* 0x30 */ "TP-01",           /* Time precision class 1 */    /* -                */
+    /* 0x31 */ "TP-00",           /* Time precision class 0 */    /* -                */
+    /* 0x32 */ "+1245",           /* Chatham Island */            /* -                */
+    /* 0x33 */ "+0000",           /* Reserved; do not use */      /* -                */
+    /* 0x34 */ "+0000",           /* Reserved; do not use */      /* -                */
+    /* 0x35 */ "+0000",           /* Reserved; do not use */      /* -                */
+    /* 0x36 */ "+0000",           /* Reserved; do not use */      /* -                */
+    /* 0x37 */ "+0000",           /* Reserved; do not use */      /* -                */
+    /* 0x38 */ "+XXXX",           /* User defined time offset */  /* -                */
+    /* 0x39 */ "+0000",           /* Unknown */                   /* Unknown          */
+    /* 0x3A */ "+0530",           /* Bombay */                    /* -                */
+    /* 0x3B */ "+0430",           /* Kabul */                     /* -                */
+    /* 0x3C */ "+0330",           /* Tehran */                    /* -                */
+    /* 0x3D */ "+0230",           /* - */                         /* -                */
+    /* 0x3E */ "+0130",           /* - */                         /* -                */
+    /* 0x3F */ "+0030",           /* - */                         /* -                */
 };
 
 static void smpte_set_timezone_string(LTCFrame *frame, SMPTETimecode *stime) {
-	int i = 0;
-
 	const unsigned char code = frame->user7 + (frame->user8 << 4);
-
-	char timezone[6] = "+0000";
-
-	for (i = 0 ; smpte_time_zones[i].code != 0xFF ; i++) {
-		if ( smpte_time_zones[i].code == code ) {
-			strcpy(timezone, smpte_time_zones[i].timezone);
-			break;
-		}
-	}
-	strcpy(stime->timezone, timezone);
+	memcpy(stime->timezone, code < 64 ? smpte_time_zones[code] : "+0000", 6);
 }
 
 static void smpte_set_timezone_code(SMPTETimecode *stime, LTCFrame *frame) {
@@ -133,10 +114,9 @@ static void smpte_set_timezone_code(SMPTETimecode *stime, LTCFrame *frame) {
 	unsigned char code = 0x00;
 
 	// Find code for timezone string
-	// Primitive search
-	for (i=0; smpte_time_zones[i].code != 0xFF; i++) {
-		if ( (strcmp(smpte_time_zones[i].timezone, stime->timezone)) == 0 ) {
-			code = smpte_time_zones[i].code;
+	for (i = 0; i < 64; i++) {
+		if ( (strcmp(smpte_time_zones[i], stime->timezone)) == 0 ) {
+			code = i;
 			break;
 		}
 	}
@@ -174,7 +154,7 @@ void ltc_frame_to_time(SMPTETimecode *stime, LTCFrame *frame, int flags) {
 		stime->years  = 0;
 		stime->months = 0;
 		stime->days   = 0;
-		sprintf(stime->timezone,"+0000");
+		memcpy(stime->timezone, "+0000", 6);
 	}
 
 	stime->hours = frame->hours_units + frame->hours_tens*10;
@@ -213,6 +193,37 @@ void ltc_time_to_frame(LTCFrame* frame, SMPTETimecode* stime, enum LTC_TV_STANDA
 	}
 }
 
+void ltc_frames_to_time(SMPTETimecode* stimes, LTCFrame* frames, int count, int flags) {
+	int i;
+	for (i = 0; i < count; ++i) {
+		ltc_frame_to_time(&stimes[i], &frames[i], flags);
+	}
+}
+
+void ltc_time_to_frames(LTCFrame* frames, SMPTETimecode* stimes, int count, enum LTC_TV_STANDARD standard, int flags) {
+	int i;
+	for (i = 0; i < count; ++i) {
+		ltc_time_to_frame(&frames[i], &stimes[i], standard, flags);
+	}
+}
+
+int ltc_frame_to_string(char *buf, LTCFrame *frame) {
+	/* the BCD digits are printed as-is */
+	buf[0]  = '0' + frame->hours_tens;
+	buf[1]  = '0' + frame->hours_units;
+	buf[2]  = ':';
+	buf[3]  = '0' + frame->mins_tens;
+	buf[4]  = '0' + frame->mins_units;
+	buf[5]  = ':';
+	buf[6]  = '0' + frame->secs_tens;
+	buf[7]  = '0' + frame->secs_units;
+	buf[8]  = frame->dfbit ? '.' : ':';
+	buf[9]  = '0' + frame->frame_tens;
+	buf[10] = '0' + frame->frame_units;
+	buf[11] = '\0';
+	return LTC_TIMECODE_STRLEN;
+}
+
 void ltc_frame_reset(LTCFrame* frame) {
 	memset(frame, 0, sizeof(LTCFrame));
 	// syncword = 0x3FFD
@@ -431,6 +442,153 @@ int ltc_frame_decrement(LTCFrame* frame, int fps, enum LTC_TV_STANDARD standard,
 	return rv;
 }
 
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Frame index arithmetic
+ *
+ * Drop-frame timecode skips frame numbers 0 and 1 at the start of every
+ * minute, except for every 10th minute (see skip_drop_frames).
+ */
+
+ltc_off_t frames_per_day(int fps, int df) {
+	if (df) {
+		return 144 * (600 * (ltc_off_t)fps - 18);
+	}
+	return 86400 * (ltc_off_t)fps;
+}
+
+ltc_off_t ltc_frame_to_index(LTCFrame *frame, int fps) {
+	const int hours = frame->hours_units + frame->hours_tens * 10;
+	const int mins  = frame->mins_units  + frame->mins_tens  * 10;
+	const int secs  = frame->secs_units  + frame->secs_tens  * 10;
+	const int frames = frame->frame_units + frame->frame_tens * 10;
+	const ltc_off_t total_mins = 60 * hours + mins;
+
+	ltc_off_t index = ((total_mins * 60) + secs) * fps + frames;
+	if (frame->dfbit) {
+		index -= 2 * (total_mins - total_mins / 10);
+	}
+	return index;
+}
+
+/** set the timecode fields, 0 <= index < frames_per_day () */
+static void set_frame_index(LTCFrame *frame, ltc_off_t index, int fps) {
+	int hours, mins, secs, frames;
+
+	if (frame->dfbit) {
+		const ltc_off_t per_10min = 600 * (ltc_off_t)fps - 18;
+		const ltc_off_t per_min = 60 * (ltc_off_t)fps - 2;
+		const ltc_off_t d = index / per_10min;
+		const ltc_off_t m = index % per_10min;
+		/* re-insert the skipped frame numbers */
+		index += 18 * d;
+		if (m > 1) {
+			index += 2 * ((m - 2) / per_min);
+		}
+	}
+
+	frames = index % fps;
+	index /= fps;
+	secs = index % 60;
+	index /= 60;
+	mins = index % 60;
+	hours = index / 60;
+
+	frame->hours_tens  = hours / 10;
+	frame->hours_units = hours % 10;
+	frame->mins_tens   = mins / 10;
+	frame->mins_units  = mins % 10;
+	frame->secs_tens   = secs / 10;
+	frame->secs_units  = secs % 10;
+	frame->frame_tens  = frames / 10;
+	frame->frame_units = frames % 10;
+}
+
+void ltc_index_to_frame(LTCFrame *frame, ltc_off_t index, int fps, enum LTC_TV_STANDARD standard, int flags) {
+	const ltc_off_t day = frames_per_day(fps, frame->dfbit);
+	index %= day;
+	if (index < 0) {
+		index += day;
+	}
+	set_frame_index(frame, index, fps);
+
+	if ((flags & LTC_NO_PARITY) == 0) {
+		ltc_frame_set_parity(frame, standard);
+	}
+}
+
+/* Date arithmetic. As with ltc_frame_increment, a two-digit year is
+ * used and every 4th year is a leap year. 100 years are 36525 days.
+ */
+static const short days_before_month[2][12] = {
+	{ 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 },
+	{ 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335 }
+};
+
+static int frame_add_days(LTCFrame *frame, ltc_off_t days) {
+	const int years  = frame->user5 + frame->user6 * 10;
+	const int months = frame->user3 + frame->user4 * 10;
+	const int mday   = frame->user1 + frame->user2 * 10;
+	ltc_off_t dn;
+	int y, yd, leap, m;
+
+	if (months < 1 || months > 12 || years > 99) {
+		return -1;
+	}
+
+	/* days since 00-01-01 */
+	dn = (years / 4) * 1461 + (years % 4) * 365 + ((years % 4) ? 1 : 0)
+		+ days_before_month[(years % 4) == 0][months - 1] + mday - 1;
+
+	dn = (dn + days) % 36525;
+	if (dn < 0) {
+		dn += 36525;
+	}
+
+	y = (dn / 1461) * 4;
+	yd = dn % 1461;
+	if (yd >= 366) {
+		y += 1 + (yd - 366) / 365;
+		yd = (yd - 366) % 365;
+	}
+	leap = (y % 4) == 0;
+	for (m = 11; days_before_month[leap][m] > yd; --m) ;
+
+	frame->user6 = y / 10;
+	frame->user5 = y % 10;
+	frame->user4 = (m + 1) / 10;
+	frame->user3 = (m + 1) % 10;
+	frame->user2 = (yd - days_before_month[leap][m] + 1) / 10;
+	frame->user1 = (yd - days_before_month[leap][m] + 1) % 10;
+	return 0;
+}
+
+int ltc_frame_advance(LTCFrame *frame, ltc_off_t n_frames, int fps, enum LTC_TV_STANDARD standard, int flags) {
+	const ltc_off_t day = frames_per_day(fps, frame->dfbit);
+	ltc_off_t index = ltc_frame_to_index(frame, fps) + n_frames;
+	ltc_off_t days = index / day;
+	int rv = 0;
+
+	index %= day;
+	if (index < 0) {
+		index += day;
+		--days;
+	}
+
+	set_frame_index(frame, index, fps);
+
+	if (days != 0) {
+		rv = 1;
+		if ((flags & LTC_USE_DATE) && frame_add_days(frame, days)) {
+			rv = -1;
+		}
+	}
+
+	if ((flags & LTC_NO_PARITY) == 0) {
+		ltc_frame_set_parity(frame, standard);
+	}
+	return rv;
+}
+
 int ltc_frame_parse_bcg_flags(LTCFrame *frame, enum LTC_TV_STANDARD standard) {
 	switch (standard) {
 		case LTC_TV_625_50: /* 25 fps mode */
@@ -0,0 +1,35 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LTC_TIMECODE_H
+#define LTC_TIMECODE_H 1
+
+#include "ltc.h"
+
+/**
+ * Number of frames in 24 hours, the frame-numbers of
+ * \ref ltc_frame_to_index are in the range 0 <= index < frames_per_day().
+ *
+ * @param fps integer frame-rate
+ * @param df non-zero for drop-frame timecode
+ */
+ltc_off_t frames_per_day(int fps, int df);
+
+#endif
@@ -0,0 +1,183 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "tracker.h"
+#include "timecode.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* -+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * Timecode tracker
+ *
+ * A second order delay-locked loop: the start of each decoded frame is
+ * compared to the predicted position and the error is used to correct
+ * the phase (t0) and frame duration (period) estimates.
+ */
+
+LTCTracker* ltc_tracker_create(double sample_rate, double fps, enum LTC_TV_STANDARD standard, int flags) {
+	LTCTracker *t;
+	if (sample_rate < 1 || fps < 1) {
+		return NULL;
+	}
+	t = (LTCTracker*) calloc(1, sizeof(LTCTracker));
+	if (!t) return NULL;
+	t->sample_rate = sample_rate;
+	t->apv = sample_rate / fps;
+	t->fps = ceil(fps);
+	t->standard = standard;
+	t->flags = flags;
+	ltc_tracker_set_bandwidth(t, LTC_TRACKER_BANDWIDTH);
+	return t;
+}
+
+void ltc_tracker_free(LTCTracker *t) {
+	free(t);
+}
+
+void ltc_tracker_reset(LTCTracker *t) {
+	t->count = 0;
+}
+
+int ltc_tracker_set_bandwidth(LTCTracker *t, double bandwidth) {
+	double omega;
+	if (bandwidth <= 0 || bandwidth > t->sample_rate / t->apv / 8.0) {
+		return -1;
+	}
+	omega = 2.0 * M_PI * bandwidth * t->apv / t->sample_rate;
+	t->bandwidth = bandwidth;
+	t->b = sqrt(2.0) * omega;
+	t->c = omega * omega;
+	return 0;
+}
+
+static void tracker_restart(LTCTracker *t, LTCFrameExt *frame, ltc_off_t index) {
+	t->count = 1;
+	t->reverse = frame->reverse != 0;
+	t->index = index;
+	memcpy(&t->ltc, &frame->ltc, sizeof(LTCFrame));
+	t->t0 = frame->off_start;
+	t->period = frame->off_end - frame->off_start + 1;
+	if (t->period < 1) {
+		t->period = t->apv;
+	}
+}
+
+int ltc_tracker_update(LTCTracker *t, LTCFrameExt *frame) {
+	const ltc_off_t index = ltc_frame_to_index(&frame->ltc, t->fps);
+	const ltc_off_t day = frames_per_day(t->fps, frame->ltc.dfbit);
+	int rv = 0;
+
+	if (t->count > 0 && (frame->reverse != 0) == t->reverse && frame->ltc.dfbit == t->ltc.dfbit) {
+		/* number of frame periods since the last frame, and frame-numbers advanced */
+		const ltc_off_t n = floor((frame->off_start - t->t0) / t->period + .5);
+		const ltc_off_t d = ((frame->reverse ? t->index - index : index - t->index) % day + day) % day;
+
+		if (n >= 1 && n == d && n <= LTC_TRACKER_MAX_GAP + 1) {
+			const double predict = t->t0 + n * t->period;
+			const double err = frame->off_start - predict;
+			if (t->count == 1) {
+				/* initial estimate, the duration of the first frame is less accurate */
+				t->period = (frame->off_start - t->t0) / n;
+				t->t0 = frame->off_start;
+			} else {
+				t->t0 = predict + t->b * err;
+				t->period += t->c * err / n;
+			}
+			if (n > 1) {
+				rv |= LTC_TRACKER_DROPOUT;
+			}
+			t->index = index;
+			memcpy(&t->ltc, &frame->ltc, sizeof(LTCFrame));
+			if (++t->count >= LTC_TRACKER_LOCK_FRAMES) {
+				t->count = LTC_TRACKER_LOCK_FRAMES;
+				rv |= LTC_TRACKER_LOCKED;
+			}
+			return rv;
+		}
+		rv |= (n == d) ? LTC_TRACKER_DROPOUT : LTC_TRACKER_JUMP;
+	} else if (t->count > 0) {
+		rv |= LTC_TRACKER_JUMP;
+	}
+
+	tracker_restart(t, frame, index);
+	return rv;
+}
+
+int ltc_tracker_status(LTCTracker *t, ltc_off_t sample) {
+	if (t->count == 0) {
+		return 0;
+	}
+	if (sample - t->t0 > (LTC_TRACKER_MAX_GAP + 2) * t->period) {
+		return LTC_TRACKER_DROPOUT;
+	}
+	return t->count >= LTC_TRACKER_LOCK_FRAMES ? LTC_TRACKER_LOCKED : 0;
+}
+
+double ltc_tracker_speed(LTCTracker *t) {
+	if (t->count == 0) {
+		return 0;
+	}
+	return (t->reverse ? -t->apv : t->apv) / t->period;
+}
+
+/** frames since the start of the last frame, in timecode direction */
+static double tracker_frames(LTCTracker *t, ltc_off_t sample) {
+	const double pos = (sample - t->t0) / t->period;
+	/* a reverse frame starts at the end of its frame-number */
+	return t->reverse ? 1.0 - pos : pos;
+}
+
+double ltc_tracker_position(LTCTracker *t, ltc_off_t sample) {
+	const double day = frames_per_day(t->fps, t->ltc.dfbit);
+	double pos;
+	if (t->count == 0) {
+		return -1;
+	}
+	pos = fmod(t->index + tracker_frames(t, sample), day);
+	if (pos < 0) {
+		pos += day;
+	}
+	return pos;
+}
+
+int ltc_tracker_timecode(LTCTracker *t, ltc_off_t sample, LTCFrame *frame, double *subframe) {
+	double pos, n;
+	if (t->count == 0) {
+		return -1;
+	}
+	pos = tracker_frames(t, sample);
+	n = floor(pos);
+	memcpy(frame, &t->ltc, sizeof(LTCFrame));
+	ltc_frame_advance(frame, (ltc_off_t)n, t->fps, t->standard, t->flags);
+	if (subframe) {
+		*subframe = pos - n;
+	}
+	return 0;
+}
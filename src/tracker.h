@@ -0,0 +1,51 @@
+/*
+   libltc - en+decode linear timecode
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as
+   published by the Free Software Foundation, either version 3 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library.
+   If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LTC_TRACKER_H
+#define LTC_TRACKER_H 1
+
+#include "ltc.h"
+
+/** default loop bandwidth in Hz, see \ref ltc_tracker_set_bandwidth */
+#define LTC_TRACKER_BANDWIDTH 1.0
+/** number of consecutive frames required for lock */
+#define LTC_TRACKER_LOCK_FRAMES 4
+/** maximum number of missing frames that are bridged without re-locking */
+#define LTC_TRACKER_MAX_GAP 8
+
+struct LTCTracker {
+	double sample_rate;
+	double apv; ///< nominal audio-frames per video-frame
+	int fps; ///< integer framerate, used for frame-numbers
+	enum LTC_TV_STANDARD standard;
+	int flags;
+	double bandwidth;
+
+	double b, c; ///< DLL coefficients
+
+	int count; ///< number of consecutive frames tracked, 0: no frame yet
+	int reverse; ///< direction of the last frame, 0 or 1
+	LTCFrame ltc; ///< the last frame (for dfbit and user-bits)
+	ltc_off_t index; ///< frame-number of the last frame
+	double t0; ///< filtered sample position of the start of the last frame
+	double period; ///< filtered frame duration in audio-frames
+};
+
+#endif
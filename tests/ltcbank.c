@@ -0,0 +1,326 @@
+/**
+   @brief self-test decoder bank and parallel decoding
+   @file ltcbank.c
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ltc.h>
+
+#define RATE 48000
+#define APV 1920
+#define BLOCK 1024
+
+/** LTC at 48kHz, 25fps starting after delay samples, with a gap of silence */
+static float* generate(size_t n_samples, size_t delay, float gain) {
+	float *sig = (float*) calloc(n_samples, sizeof(float));
+	LTCEncoder *encoder = ltc_encoder_create(RATE, 25, LTC_TV_625_50, 0);
+	const size_t gap = n_samples / 3;
+	size_t i;
+
+	ltc_encoder_render_reset(encoder, 0);
+	ltc_encoder_render_float(encoder, &sig[delay], gap - delay);
+	ltc_encoder_render_reset(encoder, 0);
+	ltc_encoder_render_float(encoder, &sig[gap + RATE / 2], n_samples - gap - RATE / 2);
+	ltc_encoder_free(encoder);
+
+	for (i = 0; i < n_samples; ++i) {
+		sig[i] *= gain;
+	}
+	return sig;
+}
+
+static ltcsnd_sample_t to_u8(float v) {
+	return 128 + (int)(v * 127.f);
+}
+
+static int same_frame(const LTCFrameExt *a, const LTCFrameExt *b) {
+	return !memcmp(&a->ltc, &b->ltc, sizeof(LTCFrame))
+		&& a->off_start == b->off_start
+		&& a->off_end == b->off_end
+		&& a->reverse == b->reverse;
+}
+
+/** decode the buffer with a single decoder, @return number of frames */
+static int decode_sequential(const float *sig, const ltcsnd_sample_t *u8, size_t n_samples, LTCFrameExt *frames, int max_frames) {
+	LTCDecoder *decoder = ltc_decoder_create(APV, 32);
+	size_t off;
+	int n = 0;
+
+	for (off = 0; off < n_samples; off += BLOCK) {
+		const size_t len = n_samples - off < BLOCK ? n_samples - off : BLOCK;
+		if (sig) {
+			ltc_decoder_write_float(decoder, (float*) &sig[off], len, off);
+		} else {
+			ltc_decoder_write(decoder, (ltcsnd_sample_t*) &u8[off], len, off);
+		}
+		while (n < max_frames && ltc_decoder_read(decoder, &frames[n])) {
+			++n;
+		}
+	}
+	ltc_decoder_free(decoder);
+	return n;
+}
+
+/* every channel of a bank decodes like a single decoder, channel 2 is silent */
+static int check_bank(void) {
+	const int channels = 4;
+	const size_t n_samples = 4 * RATE;
+	const int max_frames = 4 * 25;
+	float *sig[4];
+	ltcsnd_sample_t *u8[4];
+	short *s16[4];
+	ltcsnd_sample_t *ubuf = (ltcsnd_sample_t*) malloc(n_samples * channels);
+	short *sbuf = (short*) malloc(n_samples * channels * sizeof(short));
+	float *fbuf = (float*) malloc(n_samples * channels * sizeof(float));
+	LTCFrameExt *ref = (LTCFrameExt*) malloc(channels * max_frames * sizeof(LTCFrameExt));
+	int n_ref[4];
+	int rv = 0, c, fmt;
+	size_t s;
+
+	for (c = 0; c < channels; ++c) {
+		sig[c] = generate(n_samples, 977 * c, c == 2 ? 0.f : .9f - .2f * c);
+		u8[c] = (ltcsnd_sample_t*) malloc(n_samples);
+		s16[c] = (short*) malloc(n_samples * sizeof(short));
+		for (s = 0; s < n_samples; ++s) {
+			u8[c][s] = to_u8(sig[c][s]);
+			s16[c][s] = sig[c][s] * 32767.f;
+			ubuf[s * channels + c] = u8[c][s];
+			sbuf[s * channels + c] = s16[c][s];
+			fbuf[s * channels + c] = sig[c][s];
+		}
+	}
+
+	for (fmt = 0; fmt < 5; ++fmt) {
+		LTCDecoderBank *bank = ltc_decoder_bank_create(channels, APV, 8);
+		LTCDecoderStats stats;
+		LTCFrameExt frame;
+		ltc_off_t prev = 0;
+		int cnt[4] = { 0, 0, 0, 0 };
+		size_t off;
+
+		/* single decoder reference, u8, s16 and float */
+		for (c = 0; c < channels; ++c) {
+			LTCDecoder *decoder = ltc_decoder_create(APV, 32);
+			n_ref[c] = 0;
+			for (off = 0; off < n_samples; off += BLOCK) {
+				const size_t len = n_samples - off < BLOCK ? n_samples - off : BLOCK;
+				switch (fmt) {
+					case 0: case 3: ltc_decoder_write(decoder, &u8[c][off], len, off); break;
+					case 1: case 4: ltc_decoder_write_s16(decoder, &s16[c][off], len, off); break;
+					default: ltc_decoder_write_float(decoder, &sig[c][off], len, off); break;
+				}
+				while (n_ref[c] < max_frames && ltc_decoder_read(decoder, &ref[c * max_frames + n_ref[c]])) {
+					++n_ref[c];
+				}
+			}
+			ltc_decoder_free(decoder);
+		}
+
+		for (off = 0; off < n_samples; off += BLOCK) {
+			const size_t len = n_samples - off < BLOCK ? n_samples - off : BLOCK;
+			ltcsnd_sample_t *ubufs[4];
+			short *sbufs[4];
+			for (c = 0; c < channels; ++c) {
+				ubufs[c] = &u8[c][off];
+				sbufs[c] = &s16[c][off];
+			}
+			switch (fmt) {
+				case 0: ltc_decoder_bank_write(bank, &ubuf[off * channels], len, off); break;
+				case 1: ltc_decoder_bank_write_s16(bank, &sbuf[off * channels], len, off); break;
+				case 2: ltc_decoder_bank_write_float(bank, &fbuf[off * channels], len, off); break;
+				case 3: ltc_decoder_bank_write_planar(bank, ubufs, len, off); break;
+				default: ltc_decoder_bank_write_planar_s16(bank, sbufs, len, off); break;
+			}
+			/* oldest first across all channels */
+			while (ltc_decoder_bank_read(bank, &frame, &c)) {
+				if (frame.off_start < prev || c < 0 || c >= channels
+						|| cnt[c] >= n_ref[c] || !same_frame(&frame, &ref[c * max_frames + cnt[c]])) {
+					fprintf(stderr, "bank: format %d, channel %d frame %d differs\n", fmt, c, cnt[c]);
+					rv = -1;
+					break;
+				}
+				prev = frame.off_start;
+				++cnt[c];
+			}
+		}
+
+		for (c = 0; c < channels; ++c) {
+			if (cnt[c] != n_ref[c] || (c == 2) != (cnt[c] == 0)) {
+				fprintf(stderr, "bank: format %d, channel %d decoded %d of %d frames\n", fmt, c, cnt[c], n_ref[c]);
+				rv = -1;
+			}
+		}
+		if (ltc_decoder_bank_stats(bank, 2, &stats) || stats.frames != 0
+				|| ltc_decoder_bank_stats(bank, 1, &stats) || stats.frames != (unsigned int) n_ref[1]
+				|| ltc_decoder_bank_stats(bank, channels, &stats) != -1) {
+			rv = -1;
+		}
+		ltc_decoder_bank_free(bank);
+	}
+
+	for (c = 0; c < channels; ++c) {
+		free(sig[c]);
+		free(u8[c]);
+		free(s16[c]);
+	}
+	free(ubuf);
+	free(sbuf);
+	free(fbuf);
+	free(ref);
+	return rv;
+}
+
+/* parallel decoding must yield the frames of a sequential decode */
+static int check_parallel(void) {
+	const size_t n_samples = 30 * RATE;
+	const int max_frames = 30 * 25;
+	float *sig = generate(n_samples, 0, .7f);
+	ltcsnd_sample_t *u8 = (ltcsnd_sample_t*) malloc(n_samples);
+	LTCFrameExt *ref = (LTCFrameExt*) malloc(max_frames * sizeof(LTCFrameExt));
+	int rv = 0, fmt, threads, n_ref, n, i;
+	size_t s;
+
+	for (s = 0; s < n_samples; ++s) {
+		u8[s] = to_u8(sig[s]);
+	}
+
+	for (fmt = 0; fmt < 2; ++fmt) {
+		n_ref = decode_sequential(fmt ? sig : NULL, u8, n_samples, ref, max_frames);
+		if (n_ref < max_frames - 30) {
+			fprintf(stderr, "parallel: sequential decode found %d frames\n", n_ref);
+			rv = -1;
+		}
+		for (threads = 1; threads <= 8; ++threads) {
+			LTCFrameExt *frames;
+			if (fmt) {
+				n = ltc_decode_parallel_float(sig, n_samples, APV, threads, &frames);
+			} else {
+				n = ltc_decode_parallel(u8, n_samples, APV, threads, &frames);
+			}
+			if (n != n_ref) {
+				fprintf(stderr, "parallel: %d threads decoded %d of %d frames\n", threads, n, n_ref);
+				rv = -1;
+			}
+			for (i = 0; i < n && i < n_ref; ++i) {
+				if (!same_frame(&frames[i], &ref[i])) {
+					fprintf(stderr, "parallel: %d threads, frame %d differs\n", threads, i);
+					rv = -1;
+					break;
+				}
+			}
+			ltc_frames_free(frames);
+		}
+	}
+
+	free(ref);
+	free(u8);
+	free(sig);
+	return rv;
+}
+
+/* a threaded bank yields the frames of a bank decoded in the calling thread */
+static int check_bank_threads(void) {
+	const int channels = 6;
+	const size_t n_samples = 6 * RATE;
+	float *fbuf = (float*) malloc(n_samples * channels * sizeof(float));
+	ltcsnd_sample_t *ubuf = (ltcsnd_sample_t*) malloc(n_samples * channels);
+	float *planar[6];
+	int rv = 0, c, threads, mode;
+	size_t s;
+
+	for (c = 0; c < channels; ++c) {
+		planar[c] = generate(n_samples, 331 * c, 1.f - .1f * c);
+		for (s = 0; s < n_samples; ++s) {
+			fbuf[s * channels + c] = planar[c][s];
+			ubuf[s * channels + c] = to_u8(planar[c][s]);
+		}
+	}
+
+	for (mode = 0; mode < 3; ++mode) {
+		for (threads = 2; threads <= channels + 1; threads += 2) {
+			LTCDecoderBank *ref = ltc_decoder_bank_create(channels, APV, 32);
+			LTCDecoderBank *bank = ltc_decoder_bank_create(channels, APV, 32);
+			LTCFrameExt a, b;
+			int ca, cb, cnt = 0;
+			size_t off;
+
+			if (ltc_decoder_bank_set_threads(bank, threads) < 1) {
+				rv = -1;
+			}
+			for (off = 0; off < n_samples; off += BLOCK) {
+				const size_t len = n_samples - off < BLOCK ? n_samples - off : BLOCK;
+				float *pbuf[6];
+				switch (mode) {
+					case 0:
+						ltc_decoder_bank_write(ref, &ubuf[off * channels], len, off);
+						ltc_decoder_bank_write(bank, &ubuf[off * channels], len, off);
+						break;
+					case 1:
+						ltc_decoder_bank_write_float(ref, &fbuf[off * channels], len, off);
+						ltc_decoder_bank_write_float(bank, &fbuf[off * channels], len, off);
+						break;
+					default:
+						for (c = 0; c < channels; ++c) {
+							pbuf[c] = &planar[c][off];
+						}
+						ltc_decoder_bank_write_planar_float(ref, pbuf, len, off);
+						ltc_decoder_bank_write_planar_float(bank, pbuf, len, off);
+						break;
+				}
+				while (ltc_decoder_bank_read(ref, &a, &ca)) {
+					if (!ltc_decoder_bank_read(bank, &b, &cb) || ca != cb || !same_frame(&a, &b)) {
+						fprintf(stderr, "bank: %d threads, frame %d differs (mode %d)\n", threads, cnt, mode);
+						rv = -1;
+						break;
+					}
+					++cnt;
+				}
+				if (ltc_decoder_bank_queue_length(bank) != 0) {
+					rv = -1;
+				}
+			}
+			if (cnt < channels * 5 * 25) {
+				fprintf(stderr, "bank: decoded %d frames (mode %d)\n", cnt, mode);
+				rv = -1;
+			}
+			ltc_decoder_bank_free(ref);
+			ltc_decoder_bank_free(bank);
+		}
+	}
+
+	for (c = 0; c < channels; ++c) {
+		free(planar[c]);
+	}
+	free(fbuf);
+	free(ubuf);
+	return rv;
+}
+
+int main(int argc, char **argv) {
+	int rv = 0;
+	if (check_bank()) rv = -1;
+	if (check_parallel()) rv = -1;
+	if (check_bank_threads()) rv = -1;
+	return rv;
+}
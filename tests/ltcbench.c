@@ -0,0 +1,306 @@
+/**
+   @brief encoder and decoder throughput benchmark
+   @file ltcbench.c
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+/* Output is CSV, one line per case:
+ *
+ *   test,format,rate,fps,channels,noise,filter,ns_per_sample,frames_per_sec
+ *
+ * filter is 1 for the encoder's rise-time filter or LTC_DECODER_MATCHED,
+ * ns_per_sample is wall-clock time per (per channel) audio sample,
+ * frames_per_sec the number of LTC frames encoded or decoded per second.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#endif
+
+#include <ltc.h>
+
+#define BLOCK_SIZE 1024
+
+enum Format {
+	FMT_U8,
+	FMT_S16,
+	FMT_FLOAT
+};
+
+static const char *format_names[] = { "u8", "s16", "float" };
+
+static double min_time = 0.2; ///< seconds per case
+
+static double now(void) {
+#ifdef _WIN32
+	LARGE_INTEGER f, c;
+	QueryPerformanceFrequency(&f);
+	QueryPerformanceCounter(&c);
+	return c.QuadPart / (double)f.QuadPart;
+#elif defined CLOCK_MONOTONIC
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + 1e-6 * tv.tv_usec;
+#endif
+}
+
+/** deterministic white noise -1..+1 */
+static float noise(unsigned int *seed) {
+	*seed = *seed * 1664525u + 1013904223u;
+	return (*seed >> 8) * (2.f / 16777216.f) - 1.f;
+}
+
+static void report(const char *test, enum Format fmt, int rate, double fps, int channels, double noise_level,
+		int filter, double elapsed, double samples, double frames) {
+	printf("%s,%s,%d,%.2f,%d,%g,%d,%.3f,%.1f\n",
+			test, format_names[fmt], rate, fps, channels, noise_level, filter,
+			1e9 * elapsed / samples, frames / elapsed);
+	fflush(stdout);
+}
+
+/** render n_samples of LTC at -3dBFS with noise added */
+static float* generate(int rate, double fps, size_t n_samples, float noise_level) {
+	float *sig = (float*) malloc(n_samples * sizeof(float));
+	enum LTC_TV_STANDARD standard = (fps == 25) ? LTC_TV_625_50 : (fps == 24) ? LTC_TV_FILM_24 : LTC_TV_525_60;
+	LTCEncoder *encoder = ltc_encoder_create(rate, fps, standard, 0);
+	unsigned int seed = 1;
+	size_t i;
+
+	ltc_encoder_render_reset(encoder, 0);
+	ltc_encoder_render_float(encoder, sig, n_samples);
+	ltc_encoder_free(encoder);
+
+	for (i = 0; i < n_samples; ++i) {
+		sig[i] += noise_level * noise(&seed);
+	}
+	return sig;
+}
+
+/** interleave and convert the signal, all channels carry the same LTC */
+static void* convert(const float *sig, size_t n_samples, int channels, enum Format fmt) {
+	const size_t n = n_samples * channels;
+	void *buf;
+	size_t i;
+
+	switch (fmt) {
+		case FMT_U8:
+			buf = malloc(n);
+			for (i = 0; i < n; ++i) {
+				float v = sig[i / channels];
+				if (v > 1.f) v = 1.f;
+				if (v < -1.f) v = -1.f;
+				((ltcsnd_sample_t*)buf)[i] = 128 + (int)(v * 127.f);
+			}
+			break;
+		case FMT_S16:
+			buf = malloc(n * sizeof(short));
+			for (i = 0; i < n; ++i) {
+				float v = sig[i / channels];
+				if (v > 1.f) v = 1.f;
+				if (v < -1.f) v = -1.f;
+				((short*)buf)[i] = (short)(v * 32767.f);
+			}
+			break;
+		default:
+			buf = malloc(n * sizeof(float));
+			for (i = 0; i < n; ++i) {
+				((float*)buf)[i] = sig[i / channels];
+			}
+			break;
+	}
+	return buf;
+}
+
+static void bench_decode(int rate, double fps, enum Format fmt, float noise_level, int matched) {
+	const size_t n_samples = 10 * rate;
+	const int apv = rate / fps;
+	float *sig = generate(rate, fps, n_samples, noise_level);
+	void *buf = convert(sig, n_samples, 1, fmt);
+	double elapsed = 0, samples = 0, frames = 0;
+	LTCDecoder *decoder = ltc_decoder_create_ex(apv, 32, matched ? LTC_DECODER_MATCHED : 0);
+	LTCFrameExt frame;
+
+	do {
+		const double t0 = now();
+		size_t off;
+		for (off = 0; off < n_samples; off += BLOCK_SIZE) {
+			size_t n = n_samples - off;
+			if (n > BLOCK_SIZE) n = BLOCK_SIZE;
+			switch (fmt) {
+				case FMT_U8:
+					ltc_decoder_write(decoder, &((ltcsnd_sample_t*)buf)[off], n, off);
+					break;
+				case FMT_S16:
+					ltc_decoder_write_s16(decoder, &((short*)buf)[off], n, off);
+					break;
+				default:
+					ltc_decoder_write_float(decoder, &((float*)buf)[off], n, off);
+					break;
+			}
+			while (ltc_decoder_read(decoder, &frame)) {
+				++frames;
+			}
+		}
+		elapsed += now() - t0;
+		samples += n_samples;
+	} while (elapsed < min_time);
+
+	report("decode", fmt, rate, fps, 1, noise_level, matched, elapsed, samples, frames);
+
+	ltc_decoder_free(decoder);
+	free(buf);
+	free(sig);
+}
+
+static void bench_bank(int rate, double fps, enum Format fmt, int channels) {
+	const size_t n_samples = 10 * rate;
+	const int apv = rate / fps;
+	float *sig = generate(rate, fps, n_samples, 0);
+	void *buf = convert(sig, n_samples, channels, fmt);
+	double elapsed = 0, samples = 0, frames = 0;
+	LTCDecoderBank *bank = ltc_decoder_bank_create(channels, apv, 32);
+	LTCFrameExt frame;
+	int c;
+
+	do {
+		const double t0 = now();
+		size_t off;
+		for (off = 0; off < n_samples; off += BLOCK_SIZE) {
+			size_t n = n_samples - off;
+			if (n > BLOCK_SIZE) n = BLOCK_SIZE;
+			switch (fmt) {
+				case FMT_U8:
+					ltc_decoder_bank_write(bank, &((ltcsnd_sample_t*)buf)[off * channels], n, off);
+					break;
+				case FMT_S16:
+					ltc_decoder_bank_write_s16(bank, &((short*)buf)[off * channels], n, off);
+					break;
+				default:
+					ltc_decoder_bank_write_float(bank, &((float*)buf)[off * channels], n, off);
+					break;
+			}
+			while (ltc_decoder_bank_read(bank, &frame, &c)) {
+				++frames;
+			}
+		}
+		elapsed += now() - t0;
+		samples += n_samples;
+	} while (elapsed < min_time);
+
+	report("bank", fmt, rate, fps, channels, 0, 0, elapsed, samples, frames);
+
+	ltc_decoder_bank_free(bank);
+	free(buf);
+	free(sig);
+}
+
+static void bench_encode(int rate, double fps, enum Format fmt, int filter) {
+	const int n_frames = 250;
+	enum LTC_TV_STANDARD standard = (fps == 25) ? LTC_TV_625_50 : (fps == 24) ? LTC_TV_FILM_24 : LTC_TV_525_60;
+	LTCEncoder *encoder = ltc_encoder_create(rate, fps, standard, 0);
+	const size_t size = (size_t)ceil(n_frames * (rate / fps)) + n_frames * 2 + 1;
+	void *buf = malloc(size * sizeof(float));
+	double elapsed = 0, samples = 0, frames = 0;
+
+	if (!filter) {
+		ltc_encoder_set_filter(encoder, 0);
+	}
+
+	do {
+		const double t0 = now();
+		size_t n;
+		switch (fmt) {
+			case FMT_U8:
+				n = ltc_encoder_encode_frames(encoder, n_frames, (ltcsnd_sample_t*)buf, size);
+				break;
+			case FMT_S16:
+				n = ltc_encoder_encode_frames_s16(encoder, n_frames, (short*)buf, size);
+				break;
+			default:
+				n = ltc_encoder_encode_frames_float(encoder, n_frames, (float*)buf, size);
+				break;
+		}
+		elapsed += now() - t0;
+		samples += n;
+		frames += n_frames;
+	} while (elapsed < min_time);
+
+	report("encode", fmt, rate, fps, 1, 0, filter, elapsed, samples, frames);
+
+	ltc_encoder_free(encoder);
+	free(buf);
+}
+
+int main(int argc, char **argv) {
+	static const int rates[] = { 22050, 44100, 48000, 96000, 192000 };
+	static const double fpss[] = { 24, 25, 30000.0 / 1001.0, 30 };
+	static const float noise_levels[] = { 0.001f, 0.01f, 0.1f };
+	static const int channels[] = { 1, 2, 8, 16 };
+	const int n_rates = sizeof(rates) / sizeof(rates[0]);
+	const int n_fps = sizeof(fpss) / sizeof(fpss[0]);
+	int r, f, fmt, i;
+
+	if (argc > 1) {
+		min_time = atof(argv[1]);
+	}
+
+	printf("test,format,rate,fps,channels,noise,filter,ns_per_sample,frames_per_sec\n");
+
+	for (r = 0; r < n_rates; ++r) {
+		for (f = 0; f < n_fps; ++f) {
+			for (fmt = FMT_U8; fmt <= FMT_FLOAT; ++fmt) {
+				bench_decode(rates[r], fpss[f], fmt, 0, 0);
+			}
+		}
+	}
+
+	for (i = 0; i < (int)(sizeof(noise_levels) / sizeof(noise_levels[0])); ++i) {
+		for (fmt = FMT_U8; fmt <= FMT_FLOAT; ++fmt) {
+			bench_decode(48000, 25, fmt, noise_levels[i], 0);
+			bench_decode(48000, 25, fmt, noise_levels[i], 1);
+		}
+	}
+
+	for (i = 0; i < (int)(sizeof(channels) / sizeof(channels[0])); ++i) {
+		for (fmt = FMT_U8; fmt <= FMT_FLOAT; ++fmt) {
+			bench_bank(48000, 25, fmt, channels[i]);
+		}
+	}
+
+	for (r = 0; r < n_rates; ++r) {
+		for (f = 0; f < n_fps; ++f) {
+			for (fmt = FMT_U8; fmt <= FMT_FLOAT; ++fmt) {
+				bench_encode(rates[r], fpss[f], fmt, 0);
+				bench_encode(rates[r], fpss[f], fmt, 1);
+			}
+		}
+	}
+
+	return 0;
+}
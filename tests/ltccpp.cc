@@ -0,0 +1,146 @@
+/**
+   @brief self-test C++ interface
+   @file ltccpp.cc
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <ltc.hpp>
+
+/* compile-time timecode arithmetic */
+static_assert(ltc::frames_per_day(25, false) == 2160000, "frames per day");
+static_assert(ltc::frames_per_day(30, true) == 2589408, "drop-frame frames per day");
+static_assert(ltc::timecode_to_index<ltc::Rate2997DF>(ltc::Timecode { 0, 1, 0, 2 }) == 1800, "drop-frame index");
+static_assert(ltc::index_to_timecode<ltc::Rate2997DF>(1800) == ltc::Timecode { 0, 1, 0, 2 }, "drop-frame timecode");
+static_assert(ltc::index_to_timecode<ltc::Rate25>(-1) == ltc::Timecode { 23, 59, 59, 24 }, "wrap around");
+static_assert(ltc::advance(ltc::Timecode { 0, 9, 59, 29 }, 1, 30, true) == ltc::Timecode { 0, 10, 0, 0 }, "10th minute");
+static_assert(!ltc::is_valid(ltc::Timecode { 0, 1, 0, 0 }, 30, true), "dropped frame-number");
+static_assert(ltc::frame_to_sample<ltc::Rate2997>(30000, 48000) == 48048000, "exact sample position");
+static_assert(ltc::SquareEncoder<float, 48000, ltc::Rate25>::samples_per_clock == 24.0, "samples per bit");
+
+static int check_index(void) {
+	const ltc::Timecode t[] = { { 0, 0, 0, 0 }, { 0, 0, 59, 29 }, { 0, 1, 0, 2 }, { 1, 10, 0, 0 }, { 23, 59, 59, 29 } };
+	int rv = 0;
+
+	for (ltc_off_t i = -3; i < 2 * 17982 + 3; ++i) {
+		LTCFrame f;
+		memset (&f, 0, sizeof (LTCFrame));
+		f.dfbit = 1;
+		ltc_index_to_frame (&f, i, 30, LTC_TV_525_60, 0);
+		if (ltc::to_timecode (f) != ltc::index_to_timecode (i, 30, true)
+				|| ltc_frame_to_index (&f, 30) != ltc::timecode_to_index (ltc::to_timecode (f), 30, true)) {
+			fprintf (stderr, "C++ index mismatch at %lld\n", (long long) i);
+			rv = -1;
+			break;
+		}
+	}
+
+	for (const ltc::Timecode &tc : t) {
+		LTCFrame f;
+		memset (&f, 0, sizeof (LTCFrame));
+		ltc::set_timecode<ltc::Rate2997DF> (f, tc);
+		if (!f.dfbit || ltc::to_timecode (f) != tc) {
+			fprintf (stderr, "C++ set_timecode failed\n");
+			rv = -1;
+		}
+	}
+	return rv;
+}
+
+/** the compile-time encoder must match the C encoder without filter */
+template <typename Sample, long SampleRate, typename FrameRate>
+static int check_square(void) {
+	typedef ltc::SquareEncoder<Sample, SampleRate, FrameRate> Square;
+	const int n_frames = 50;
+	ltc::Encoder<ltc::default_standard<FrameRate> ()> encoder (SampleRate, FrameRate::value);
+	Square square;
+	std::vector<Sample> a (n_frames * Square::max_frame_samples);
+	std::vector<Sample> b (n_frames * Square::max_frame_samples);
+	SMPTETimecode st;
+	int rv = 0;
+
+	memset (&st, 0, sizeof (SMPTETimecode));
+	strcpy (st.timezone, "+0000");
+	st.hours = 9;
+	st.mins = 59;
+	st.secs = 59;
+	st.frame = 5;
+	encoder.set_timecode (st);
+	encoder.set_filter (0);
+	square.set_frame (encoder.frame ());
+
+	const size_t len = square.encode_frames (n_frames, a.data ());
+	const size_t ref = encoder.encode_frames (n_frames, b.data (), b.size ());
+
+	if (len != ref || memcmp (a.data (), b.data (), len * sizeof (Sample))) {
+		fprintf (stderr, "C++ square encoder mismatch (%d Hz, %.2f fps)\n", (int) SampleRate, FrameRate::value);
+		rv = -1;
+	}
+
+	/* and decode it */
+	ltc::Decoder decoder (SampleRate / FrameRate::value);
+	LTCFrameExt frame;
+	int cnt = 0;
+	for (size_t i = 0; i < len; i += 1024) {
+		decoder.write (&a[i], len - i < 1024 ? len - i : 1024, i);
+		while (decoder.read (frame)) {
+			++cnt;
+		}
+	}
+	if (cnt < n_frames - 1) {
+		fprintf (stderr, "C++ decoded %d of %d frames\n", cnt, n_frames);
+		rv = -1;
+	}
+	return rv;
+}
+
+static int check_handles(void) {
+	ltc::Decoder a (1920);
+	LTCDecoder *d = a.get ();
+	ltc::Decoder b (std::move (a));
+	int rv = 0;
+
+	if (a.get () || b.get () != d) {
+		fprintf (stderr, "C++ decoder move failed\n");
+		rv = -1;
+	}
+
+	ltc::Encoder<LTC_TV_625_50> e (48000, 25);
+	ltc::Encoder<LTC_TV_625_50> f (std::move (e));
+	if (e.get () || !f.get ()) {
+		fprintf (stderr, "C++ encoder move failed\n");
+		rv = -1;
+	}
+	return rv;
+}
+
+int main(void) {
+	int rv = 0;
+	if (check_index ()) rv = -1;
+	if (check_square<ltcsnd_sample_t, 48000, ltc::Rate25> ()) rv = -1;
+	if (check_square<float, 48000, ltc::Rate2997DF> ()) rv = -1;
+	if (check_square<short, 44100, ltc::Rate24> ()) rv = -1;
+	if (check_square<float, 96000, ltc::Rate23976> ()) rv = -1;
+	if (check_handles ()) rv = -1;
+	return rv;
+}
@@ -0,0 +1,510 @@
+/**
+   @brief self-test decoding LTC from audio files
+   @file ltcfile.c
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <ltc.h>
+
+#define SAMPLERATE 48000
+#define N_SAMPLES (2 * SAMPLERATE)
+#define MAX_FRAMES 64
+
+static const char *wavfile = "ltcfile.wav";
+static const char *rawfile = "ltcfile.raw";
+static const char *idxfile = "ltcfile.idx";
+
+static void put_u16(FILE *f, unsigned int v) {
+	fputc(v & 0xff, f);
+	fputc((v >> 8) & 0xff, f);
+}
+
+static void put_u32(FILE *f, unsigned int v) {
+	put_u16(f, v & 0xffff);
+	put_u16(f, v >> 16);
+}
+
+static void put_sample(FILE *f, float v, int tag, int bytes) {
+	if (tag == 3 && bytes == 4) {
+		unsigned int u;
+		memcpy(&u, &v, 4);
+		put_u32(f, u);
+	} else if (tag == 3) {
+		double d = v;
+		unsigned long long u;
+		memcpy(&u, &d, 8);
+		put_u32(f, u & 0xffffffff);
+		put_u32(f, u >> 32);
+	} else if (bytes == 1) {
+		fputc(128 + (int)(v * 127.f), f);
+	} else {
+		/* scale to 32 bit and write the upper bytes */
+		const unsigned int u = (unsigned int)(int)(v * 2147483520.f);
+		int b;
+		for (b = 4 - bytes; b < 4; ++b) {
+			fputc((u >> (8 * b)) & 0xff, f);
+		}
+	}
+}
+
+/** write a WAVE file, LTC is in the last channel, the other channels are silent */
+static int write_wav(float *sig, int n_samples, int rate, int tag, int bytes, int channels, int rf64, int extensible) {
+	const unsigned int data_size = n_samples * bytes * channels;
+	FILE *f = fopen(wavfile, "wb");
+	int i, c;
+	if (!f) return -1;
+
+	fwrite(rf64 ? "RF64" : "RIFF", 1, 4, f);
+	put_u32(f, rf64 ? 0xffffffff : 0);
+	fwrite("WAVE", 1, 4, f);
+	if (rf64) {
+		fwrite("ds64", 1, 4, f);
+		put_u32(f, 28);
+		put_u32(f, 0); put_u32(f, 0); /* riff size */
+		put_u32(f, data_size); put_u32(f, 0);
+		put_u32(f, n_samples); put_u32(f, 0);
+		put_u32(f, 0); /* table length */
+	}
+	/* unknown chunk with odd size */
+	fwrite("junk", 1, 4, f);
+	put_u32(f, 3);
+	fwrite("abc\0", 1, 4, f);
+
+	fwrite("fmt ", 1, 4, f);
+	put_u32(f, extensible ? 40 : 16);
+	put_u16(f, extensible ? 0xFFFE : tag);
+	put_u16(f, channels);
+	put_u32(f, rate);
+	put_u32(f, rate * bytes * channels);
+	put_u16(f, bytes * channels);
+	put_u16(f, bytes * 8);
+	if (extensible) {
+		put_u16(f, 22);
+		put_u16(f, bytes * 8);
+		put_u32(f, 0);
+		put_u16(f, tag);
+		fwrite("\x00\x00\x00\x00\x10\x00\x80\x00\x00\xAA\x00\x38\x9B\x71", 1, 14, f);
+	}
+
+	fwrite("data", 1, 4, f);
+	put_u32(f, rf64 ? 0xffffffff : data_size);
+	for (i = 0; i < n_samples; ++i) {
+		for (c = 0; c < channels - 1; ++c) {
+			put_sample(f, 0, tag, bytes);
+		}
+		put_sample(f, sig[i], tag, bytes);
+	}
+	fclose(f);
+	return 0;
+}
+
+static int decode_file(const char *path, int channel, int flags, LTCFrameExt *frames) {
+	LTCFrameExt frame;
+	int n = 0;
+	LTCFileDecoder *f = ltc_file_decoder_open(path, channel, 0, flags);
+	if (!f) return -1;
+	while (ltc_file_decoder_read(f, &frame) > 0) {
+		if (n < MAX_FRAMES) {
+			frames[n] = frame;
+		}
+		++n;
+	}
+	ltc_file_decoder_close(f);
+	return n;
+}
+
+static int compare(const char *name, LTCFrameExt *ref, int n_ref, LTCFrameExt *frames, int n, int tolerance) {
+	int i;
+	if (n != n_ref) {
+		fprintf(stderr, "%s: decoded %d frames, expected %d\n", name, n, n_ref);
+		return -1;
+	}
+	for (i = 0; i < n && i < MAX_FRAMES; ++i) {
+		const ltc_off_t d = frames[i].off_start - ref[i].off_start;
+		if (d < -tolerance || d > tolerance
+				|| ltc_frame_to_index(&frames[i].ltc, 25) != ltc_frame_to_index(&ref[i].ltc, 25)) {
+			fprintf(stderr, "%s: frame %d mismatch\n", name, i);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int check_index(LTCFrameExt *ref, int n_ref) {
+	LTCFileDecoder *fd = ltc_file_decoder_open(wavfile, 1, 0, 0);
+	LTCIndex *x = ltc_index_create(25, 10);
+	LTCIndex *y = NULL;
+	LTCIndexEntry e;
+	LTCFrameExt frame;
+	int i, rv = 0;
+
+	if (!fd || !x || ltc_index_build(x, fd) != (n_ref + 9) / 10) {
+		fprintf(stderr, "index: build failed\n");
+		rv = -1;
+		goto out;
+	}
+
+	if (ltc_index_save(x, idxfile) || !(y = ltc_index_load(idxfile)) || ltc_index_size(y) != ltc_index_size(x)) {
+		fprintf(stderr, "index: save/load failed\n");
+		rv = -1;
+		goto out;
+	}
+
+	for (i = 0; i < n_ref; i += 7) {
+		const ltc_off_t len = ref[i].off_end - ref[i].off_start + 1;
+		const ltc_off_t est = ltc_index_lookup(y, &ref[i].ltc);
+		if (est < ref[i].off_start - len / 2 || est > ref[i].off_start + len / 2
+				|| ltc_index_seek(y, fd, &ref[i].ltc, &frame) != ref[i].off_start
+				|| frame.off_end != ref[i].off_end) {
+			fprintf(stderr, "index: seek to frame %d failed\n", i);
+			rv = -1;
+		}
+	}
+
+	/* timecode that is not in the file */
+	ltc_frame_advance(&frame.ltc, 100, 25, LTC_TV_625_50, 0);
+	if (ltc_index_lookup(y, &frame.ltc) != -1) {
+		fprintf(stderr, "index: found non-existent timecode\n");
+		rv = -1;
+	}
+
+	/* discontinuities */
+	ltc_index_free(x);
+	x = ltc_index_create(25, 25);
+	for (i = 0; i < 20; ++i) {
+		ltc_frame_reset(&frame.ltc);
+		ltc_frame_advance(&frame.ltc, i < 10 ? i : i + 100, 25, LTC_TV_625_50, 0);
+		frame.off_start = i * 1920;
+		frame.off_end = frame.off_start + 1919;
+		frame.reverse = 0;
+		ltc_index_add(x, &frame);
+	}
+	if (ltc_index_size(x) != 2 || ltc_index_entry(x, 1, &e) || !e.discontinuity || e.n_frames != 10
+			|| ltc_index_lookup(x, &frame.ltc) != 19 * 1920) {
+		fprintf(stderr, "index: discontinuity not detected\n");
+		rv = -1;
+	}
+
+out:
+	ltc_index_free(y);
+	ltc_index_free(x);
+	ltc_file_decoder_close(fd);
+	return rv;
+}
+
+/** reverse playback with a drifting speed, n_frames at 48k/25 fps, @return number of samples */
+static int render_reverse(float *sig, int n_frames) {
+	LTCEncoder *encoder = ltc_encoder_create(SAMPLERATE, 25, LTC_TV_625_50, 0);
+	ltcsnd_sample_t *buf;
+	int i, n = 0;
+
+	ltc_encoder_set_min_speed(encoder, 0.97);
+	buf = malloc(ltc_encoder_get_buffersize(encoder));
+	for (i = 0; i < n_frames; ++i) {
+		int k, len;
+		ltc_encoder_encode_frame_varispeed(encoder, 1 + .03 * sin(i * .1), 1 + .03 * sin((i + 1) * .1));
+		len = ltc_encoder_copy_buffer(encoder, buf);
+		for (k = 0; k < len; ++k) {
+			sig[n + k] = (buf[k] - 128) / 127.f;
+		}
+		n += len;
+		ltc_encoder_inc_timecode(encoder);
+	}
+	ltc_encoder_free(encoder);
+	free(buf);
+
+	for (i = 0; i < n / 2; ++i) {
+		const float t = sig[i];
+		sig[i] = sig[n - 1 - i];
+		sig[n - 1 - i] = t;
+	}
+	return n;
+}
+
+/** index a decoded reverse recording, it is one continuous run */
+static int check_reverse_index(void) {
+	const int n_frames = 200;
+	float *sig = malloc(n_frames * SAMPLERATE / 25 * sizeof(float) * 11 / 10);
+	const int n_samples = render_reverse(sig, n_frames);
+	LTCFileDecoder *fd = NULL;
+	LTCIndex *x = ltc_index_create(25, 10);
+	LTCIndex *y = ltc_index_create(25, 10);
+	LTCIndexEntry e;
+	LTCFrameExt frame;
+	ltc_off_t start[MAX_FRAMES];
+	LTCFrame tc[MAX_FRAMES];
+	int i, n = 0, rv = 0;
+
+	if (write_wav(sig, n_samples, SAMPLERATE, 1, 2, 1, 0, 0) || !(fd = ltc_file_decoder_open(wavfile, 0, 0, 0))) {
+		rv = -1;
+		goto out;
+	}
+	while (ltc_file_decoder_read(fd, &frame) > 0) {
+		if (!frame.reverse || ltc_index_add(x, &frame) < 0) {
+			rv = -1;
+		}
+		if (n % 4 == 0 && n / 4 < MAX_FRAMES) {
+			start[n / 4] = frame.off_start;
+			tc[n / 4] = frame.ltc;
+		}
+		++n;
+	}
+
+	if (n < n_frames - 1 || ltc_index_size(x) != (n + 9) / 10) {
+		fprintf(stderr, "reverse index: %d checkpoints for %d frames\n", ltc_index_size(x), n);
+		rv = -1;
+	}
+	for (i = 0; ltc_index_entry(x, i, &e) == 0; ++i) {
+		if (e.reverse != 1 || e.discontinuity != (i == 0)) {
+			fprintf(stderr, "reverse index: checkpoint %d is not continuous\n", i);
+			rv = -1;
+		}
+	}
+	/* the probe-scan finds the same continuous run */
+	if (ltc_index_scan(y, fd, 10 * SAMPLERATE / 25) != ltc_index_size(x)) {
+		fprintf(stderr, "reverse index: scan found %d checkpoints\n", ltc_index_size(y));
+		rv = -1;
+	}
+	for (i = 0; ltc_index_entry(y, i, &e) == 0; ++i) {
+		if (e.reverse != 1 || e.discontinuity != (i == 0)) {
+			fprintf(stderr, "reverse index: scanned checkpoint %d is not continuous\n", i);
+			rv = -1;
+		}
+	}
+	for (i = 0; i < n / 4 && i < MAX_FRAMES; ++i) {
+		/* off_start of a reverse frame depends on the decoder's period estimate */
+		const ltc_off_t d = ltc_index_seek(x, fd, &tc[i], NULL) - start[i];
+		if (d < -2 || d > 2) {
+			fprintf(stderr, "reverse index: seek to frame %d failed\n", 4 * i);
+			rv = -1;
+		}
+	}
+
+out:
+	ltc_index_free(y);
+	ltc_index_free(x);
+	ltc_file_decoder_close(fd);
+	free(sig);
+	return rv;
+}
+
+/** a long file with a gap and a jump, compare probe-scan with a full decode,
+ * played forward or in reverse
+ */
+static int check_scan(int reverse) {
+	const int rate = 16000;
+	const int spf = rate / 25;
+	const int n_samples = 120 * rate;
+	float *sig = calloc(n_samples, sizeof(float));
+	LTCEncoder *encoder = ltc_encoder_create(rate, 25, LTC_TV_625_50, 0);
+	LTCFileDecoder *fd = NULL;
+	LTCIndex *full = ltc_index_create(25, 25);
+	LTCIndex *scan = ltc_index_create(25, 25);
+	LTCIndexEntry a, b;
+	LTCFrameExt frame;
+	SMPTETimecode st;
+	int i, j, rv = 0;
+
+	memset(&st, 0, sizeof(st));
+	strcpy(st.timezone, "+0000");
+
+	/* 0..40s: 01:00:00:00, 40..50s: silence, 50..80s: 10:00:00:00, 80..120s: 02:00:00:00 */
+	st.hours = 1;
+	ltc_encoder_set_timecode(encoder, &st);
+	ltc_encoder_render_reset(encoder, 0);
+	ltc_encoder_render_float(encoder, sig, 40 * rate);
+
+	st.hours = 10;
+	ltc_encoder_set_timecode(encoder, &st);
+	ltc_encoder_render_reset(encoder, 0);
+	ltc_encoder_render_float(encoder, &sig[50 * rate], 30 * rate);
+	st.hours = 2;
+	ltc_encoder_set_timecode(encoder, &st);
+	ltc_encoder_render_float(encoder, &sig[80 * rate], 40 * rate);
+	ltc_encoder_free(encoder);
+
+	/* reverse: 0..40s: 02:00:39:24, 40..70s: 10:00:29:24, 70..80s silence, 80..120s: 01:00:39:24 */
+	for (i = 0; reverse && i < n_samples / 2; ++i) {
+		const float t = sig[i];
+		sig[i] = sig[n_samples - 1 - i];
+		sig[n_samples - 1 - i] = t;
+	}
+
+	if (write_wav(sig, n_samples, rate, 1, 2, 1, 0, 0)) {
+		free(sig);
+		return -1;
+	}
+	free(sig);
+
+	fd = ltc_file_decoder_open(wavfile, 0, spf, 0);
+	if (!fd || !full || !scan || ltc_index_build(full, fd) < 0 || ltc_index_scan(scan, fd, 5 * rate) < 0) {
+		fprintf(stderr, "scan: failed\n");
+		rv = -1;
+		goto out;
+	}
+
+	/* the same discontinuities, and seeking gives the same result.
+	 * The first and last frame around a gap may differ, a decoder
+	 * that runs through the gap can complete the last frame with
+	 * the first edge after the gap.
+	 */
+	for (i = j = 0; i < ltc_index_size(full); ++i) {
+		ltc_index_entry(full, i, &a);
+		if (a.discontinuity) {
+			while (ltc_index_entry(scan, j, &b) == 0 && !b.discontinuity) ++j;
+			if (j >= ltc_index_size(scan) || b.off_start - a.off_start > spf || a.off_start - b.off_start > spf) {
+				fprintf(stderr, "scan: discontinuity %d mismatch\n", i);
+				rv = -1;
+			}
+			++j;
+		}
+		memcpy(&frame.ltc, &a.ltc, sizeof(LTCFrame));
+		ltc_frame_advance(&frame.ltc, a.n_frames / 2, 25, LTC_TV_625_50, 0);
+		if (ltc_index_seek(full, fd, &frame.ltc, NULL) != ltc_index_seek(scan, fd, &frame.ltc, NULL)) {
+			fprintf(stderr, "scan: seek %d mismatch\n", i);
+			rv = -1;
+		}
+	}
+	if (ltc_index_size(scan) != ltc_index_size(full)) {
+		fprintf(stderr, "scan: index size mismatch\n");
+		rv = -1;
+	}
+
+	/* first frame, and first frame after the gap */
+	ltc_index_entry(full, 0, &a);
+	if (ltc_file_decoder_seek(fd, 0) || ltc_file_decoder_find(fd, 0, &frame) != 1 || frame.off_start != a.off_start) {
+		fprintf(stderr, "scan: find failed\n");
+		rv = -1;
+	}
+	if (ltc_file_decoder_seek(fd, (reverse ? 71 : 41) * rate) || ltc_file_decoder_find(fd, 3 * rate, &frame) != 1
+			|| frame.ltc.hours_tens != !reverse || frame.off_start < (reverse ? 80 : 50) * rate
+			|| frame.off_start > (reverse ? 80 : 50) * rate + 2 * spf) {
+		fprintf(stderr, "scan: find after gap failed\n");
+		rv = -1;
+	}
+
+out:
+	ltc_index_free(scan);
+	ltc_index_free(full);
+	ltc_file_decoder_close(fd);
+	return rv;
+}
+
+int main(void) {
+	static const struct {
+		const char *name;
+		int tag, bytes, channels, rf64, extensible;
+	} formats[] = {
+		{ "u8 mono",       1, 1, 1, 0, 0 },
+		{ "u8 stereo",     1, 1, 2, 0, 0 },
+		{ "s16 stereo",    1, 2, 2, 0, 0 },
+		{ "s24 stereo",    1, 3, 2, 0, 0 },
+		{ "s24 rf64",      1, 3, 1, 1, 0 },
+		{ "s32 ext",       1, 4, 3, 0, 1 },
+		{ "float mono",    3, 4, 1, 0, 0 },
+		{ "float stereo",  3, 4, 2, 1, 1 },
+		{ "double stereo", 3, 8, 2, 0, 0 },
+	};
+
+	LTCFrameExt ref[MAX_FRAMES], frames[MAX_FRAMES], frame;
+	float *sig = malloc(N_SAMPLES * sizeof(float));
+	ltcsnd_sample_t *u8 = malloc(N_SAMPLES);
+	LTCEncoder *encoder;
+	LTCDecoder *decoder;
+	LTCFileDecoder *fd;
+	FILE *f;
+	int i, n, n_ref = 0, rv = 0;
+
+	encoder = ltc_encoder_create(SAMPLERATE, 25, LTC_TV_625_50, 0);
+	ltc_encoder_render_reset(encoder, 0);
+	ltc_encoder_render_float(encoder, sig, N_SAMPLES);
+	ltc_encoder_free(encoder);
+
+	decoder = ltc_decoder_create(SAMPLERATE / 25, MAX_FRAMES);
+	ltc_decoder_write_float(decoder, sig, N_SAMPLES, 0);
+	while (ltc_decoder_read(decoder, &frame)) {
+		ref[n_ref++] = frame;
+	}
+	ltc_decoder_free(decoder);
+
+	if (n_ref < 40) {
+		fprintf(stderr, "reference decode failed\n");
+		return -1;
+	}
+
+	for (i = 0; i < (int)(sizeof(formats) / sizeof(formats[0])); ++i) {
+		if (write_wav(sig, N_SAMPLES, SAMPLERATE, formats[i].tag, formats[i].bytes, formats[i].channels, formats[i].rf64, formats[i].extensible)) {
+			return -1;
+		}
+		n = decode_file(wavfile, formats[i].channels - 1, 0, frames);
+		rv |= compare(formats[i].name, ref, n_ref, frames, n, formats[i].bytes == 1 ? 2 : 0);
+		/* read-buffer fallback */
+		n = decode_file(wavfile, formats[i].channels - 1, LTC_FILE_NO_MMAP, frames);
+		rv |= compare(formats[i].name, ref, n_ref, frames, n, formats[i].bytes == 1 ? 2 : 0);
+	}
+
+	/* seek */
+	fd = ltc_file_decoder_open(wavfile, 1, 0, 0);
+	if (!fd || ltc_file_decoder_length(fd) != N_SAMPLES || ltc_file_decoder_sample_rate(fd) != SAMPLERATE
+			|| ltc_file_decoder_seek(fd, ref[20].off_start - 100)
+			|| ltc_file_decoder_read(fd, &frame) != 1
+			|| frame.off_start < ref[20].off_start - 100) {
+		fprintf(stderr, "seek failed\n");
+		rv = -1;
+	}
+	ltc_file_decoder_close(fd);
+
+	/* seek index */
+	rv |= check_index(ref, n_ref);
+	rv |= check_reverse_index();
+
+	rv |= check_scan(0);
+	rv |= check_scan(1);
+
+	/* raw u8, compare with ltc_decoder_write */
+	for (i = 0; i < N_SAMPLES; ++i) {
+		u8[i] = 128 + (int)(sig[i] * 127.f);
+	}
+	decoder = ltc_decoder_create(SAMPLERATE / 25, MAX_FRAMES);
+	ltc_decoder_write(decoder, u8, N_SAMPLES, 0);
+	n_ref = 0;
+	while (ltc_decoder_read(decoder, &frame)) {
+		ref[n_ref++] = frame;
+	}
+	ltc_decoder_free(decoder);
+
+	f = fopen(rawfile, "wb");
+	if (!f || fwrite(u8, 1, N_SAMPLES, f) != N_SAMPLES) {
+		return -1;
+	}
+	fclose(f);
+
+	n = decode_file(rawfile, 0, LTC_FILE_RAW, frames);
+	rv |= compare("raw", ref, n_ref, frames, n, 0);
+
+	remove(wavfile);
+	remove(rawfile);
+	remove(idxfile);
+	free(u8);
+	free(sig);
+	return rv ? -1 : 0;
+}
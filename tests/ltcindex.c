@@ -0,0 +1,167 @@
+/**
+   @brief self-test timecode arithmetic and conversion
+   @file ltcindex.c
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ltc.h>
+
+static int check_day(int fps, int df) {
+	LTCFrame inc, adv, idx;
+	ltc_off_t i = 0;
+	int wrapped = 0;
+
+	ltc_frame_reset (&inc);
+	inc.dfbit = df;
+	ltc_frame_set_parity (&inc, LTC_TV_525_60);
+
+	/* walk one full day frame by frame, compare with closed-form results */
+	do {
+		if (ltc_frame_to_index (&inc, fps) != i) {
+			fprintf (stderr, "index mismatch at %lld (%d%s)\n", (long long)i, fps, df ? "df" : "");
+			return -1;
+		}
+
+		idx = inc;
+		ltc_index_to_frame (&idx, i, fps, LTC_TV_525_60, 0);
+
+		ltc_frame_reset (&adv);
+		adv.dfbit = df;
+		ltc_frame_advance (&adv, i, fps, LTC_TV_525_60, 0);
+
+		if (memcmp (&idx, &inc, sizeof (LTCFrame)) || memcmp (&adv, &inc, sizeof (LTCFrame))) {
+			fprintf (stderr, "frame mismatch at %lld (%d%s)\n", (long long)i, fps, df ? "df" : "");
+			return -1;
+		}
+
+		wrapped = ltc_frame_increment (&inc, fps, LTC_TV_525_60, 0);
+		++i;
+	} while (!wrapped);
+
+	/* reverse wrap */
+	ltc_frame_reset (&adv);
+	adv.dfbit = df;
+	if (ltc_frame_advance (&adv, -1, fps, LTC_TV_525_60, 0) != 1
+			|| ltc_frame_to_index (&adv, fps) != i - 1) {
+		fprintf (stderr, "reverse wrap failed (%d%s)\n", fps, df ? "df" : "");
+		return -1;
+	}
+	return 0;
+}
+
+static int check_date(void) {
+	const int fps = 25;
+	const ltc_off_t day = 86400 * fps;
+	SMPTETimecode stime;
+	LTCFrame inc, adv;
+	int d;
+
+	memset (&stime, 0, sizeof (stime));
+	strcpy (stime.timezone, "+0000");
+	stime.years  = 99;
+	stime.months = 2;
+	stime.days   = 27;
+	stime.hours  = 23;
+	stime.mins   = 59;
+	stime.secs   = 59;
+	stime.frame  = 24;
+
+	ltc_time_to_frame (&inc, &stime, LTC_TV_625_50, LTC_USE_DATE);
+	adv = inc;
+
+	/* cross 28 Feb .. 1 Mar and the wrap 99 -> 00 over ~1500 days, in both directions */
+	for (d = 0; d < 1500; ++d) {
+		ltc_frame_increment (&inc, fps, LTC_TV_625_50, LTC_USE_DATE);
+		if (ltc_frame_advance (&adv, 1, fps, LTC_TV_625_50, LTC_USE_DATE) != 1
+				|| memcmp (&adv, &inc, sizeof (LTCFrame))) {
+			fprintf (stderr, "date mismatch at day %d\n", d);
+			return -1;
+		}
+		ltc_frame_advance (&inc, day - 1, fps, LTC_TV_625_50, LTC_USE_DATE);
+		ltc_frame_advance (&adv, day - 1, fps, LTC_TV_625_50, LTC_USE_DATE);
+	}
+
+	for (d = 0; d < 1500; ++d) {
+		ltc_frame_advance (&inc, day - 1, fps, LTC_TV_625_50, LTC_USE_DATE);
+	}
+	ltc_frame_advance (&adv, 1500 * (day - 1), fps, LTC_TV_625_50, LTC_USE_DATE);
+	if (memcmp (&adv, &inc, sizeof (LTCFrame))) {
+		fprintf (stderr, "multi-day advance mismatch\n");
+		return -1;
+	}
+
+	ltc_frame_advance (&adv, -1500 * (day - 1), fps, LTC_TV_625_50, LTC_USE_DATE);
+	for (d = 0; d < 1500; ++d) {
+		ltc_frame_advance (&inc, 1 - day, fps, LTC_TV_625_50, LTC_USE_DATE);
+	}
+	if (memcmp (&adv, &inc, sizeof (LTCFrame))) {
+		fprintf (stderr, "multi-day rewind mismatch\n");
+		return -1;
+	}
+	return 0;
+}
+
+static int check_convert(void) {
+	LTCFrame frames[64];
+	SMPTETimecode stimes[64];
+	char tc[LTC_TIMECODE_STRLEN + 1];
+	char ref[32];
+	int i;
+
+	/* timezone codes round-trip */
+	for (i = 0; i < 64; ++i) {
+		ltc_frame_reset (&frames[i]);
+		frames[i].user7 = i & 0x0F;
+		frames[i].user8 = i >> 4;
+		frames[i].user3 = 1;
+		ltc_frame_advance (&frames[i], 1000003 * i, 25, LTC_TV_625_50, 0);
+	}
+	ltc_frames_to_time (stimes, frames, 64, LTC_USE_DATE);
+	ltc_time_to_frames (frames, stimes, 64, LTC_TV_625_50, LTC_USE_DATE);
+
+	for (i = 0; i < 64; ++i) {
+		const int code = frames[i].user7 + (frames[i].user8 << 4);
+		if (code != i && strcmp (stimes[i].timezone, "+0000")) {
+			fprintf (stderr, "timezone mismatch 0x%02x '%s'\n", i, stimes[i].timezone);
+			return -1;
+		}
+		frames[i].dfbit = i & 1;
+		snprintf (ref, sizeof (ref), "%02d:%02d:%02d%c%02d",
+				stimes[i].hours, stimes[i].mins, stimes[i].secs,
+				(i & 1) ? '.' : ':', stimes[i].frame);
+		if (ltc_frame_to_string (tc, &frames[i]) != LTC_TIMECODE_STRLEN || strcmp (tc, ref)) {
+			fprintf (stderr, "format mismatch '%s' != '%s'\n", tc, ref);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int main(void) {
+	int rv = 0;
+	rv |= check_day (24, 0);
+	rv |= check_day (25, 0);
+	rv |= check_day (30, 0);
+	rv |= check_day (30, 1);
+	rv |= check_date ();
+	rv |= check_convert ();
+	return rv ? -1 : 0;
+}
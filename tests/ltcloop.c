@@ -25,10 +25,525 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include <ltc.h>
 
 
+static int n_alloc = 0;
+
+static void* count_alloc(void* arg, size_t size) {
+	++n_alloc;
+	return malloc (size);
+}
+
+static void count_free(void* arg, void* ptr) {
+	--n_alloc;
+	free (ptr);
+}
+
+/* memory that is not aligned for any type */
+static void* misaligned_alloc(void* arg, size_t size) {
+	char *p = (char*) count_alloc (arg, size + 4);
+	return p ? p + 4 : NULL;
+}
+
+static void misaligned_free(void* arg, void* ptr) {
+	count_free (arg, (char*)ptr - 4);
+}
+
+/* encode and decode a frame with objects in an arena and with allocator callbacks */
+static int check_memory(void) {
+	static double arena[4096];
+	const LTCAllocator allocator = { count_alloc, count_free, NULL };
+	const LTCAllocator misaligned = { misaligned_alloc, misaligned_free, NULL };
+	const size_t esize = ltc_encoder_size (48000, 24);
+	const size_t dsize = ltc_decoder_size (4, 0);
+	LTCEncoder *encoder;
+	LTCDecoder *decoder;
+	LTCFrameExt frame;
+	ltcsnd_sample_t *buf;
+	int rv = 0, len, n;
+
+	if (esize + dsize > sizeof (arena)
+			|| ltc_encoder_create_in (arena, esize - 1, 48000, 24, 0, 0) != NULL
+			|| ltc_decoder_create_in ((char*)arena + 1, dsize, 1920, 4, 0) != NULL) {
+		return -1;
+	}
+
+	/* room for 24 fps, create for 25 and enlarge in-place */
+	encoder = ltc_encoder_create_in (arena, esize, 48000, 25, 0, 0);
+	decoder = ltc_decoder_create_in ((char*)arena + ((esize + 15) & ~15), dsize, 1920, 4, 0);
+	if (!encoder || !decoder
+			|| ltc_encoder_set_buffersize (encoder, 48000, 24) != 0
+			|| ltc_encoder_set_buffersize (encoder, 48000, 23) != -1
+			|| ltc_encoder_get_buffersize (encoder) != 2001) {
+		return -1;
+	}
+	for (n = 0; n < 2; ++n) {
+		ltc_encoder_encode_frame (encoder);
+		len = ltc_encoder_get_bufferptr (encoder, &buf, 1);
+		ltc_decoder_write (decoder, buf, len, n * len);
+	}
+	if (!ltc_decoder_read (decoder, &frame)) {
+		rv = -1;
+	}
+	ltc_encoder_free (encoder);
+	ltc_decoder_free (decoder);
+
+	/* allocator callbacks, a single block per object */
+	encoder = ltc_encoder_create_alloc (&allocator, 48000, 25, 0, 0);
+	decoder = ltc_decoder_create_alloc (&allocator, 1920, 4, LTC_DECODER_COMPACT);
+	if (!encoder || !decoder || n_alloc != 2) {
+		rv = -1;
+	}
+	/* shrinking and enlarging up to the previous size does not allocate */
+	ltc_encoder_set_buffersize (encoder, 48000, 30);
+	ltc_encoder_set_buffersize (encoder, 48000, 25);
+	if (n_alloc != 2 || ltc_encoder_set_buffersize (encoder, 96000, 25) != 0 || n_alloc != 3) {
+		rv = -1;
+	}
+	ltc_encoder_free (encoder);
+	ltc_decoder_free (decoder);
+	if (n_alloc != 0) {
+		rv = -1;
+	}
+
+	/* misaligned blocks are rejected and released */
+	if (ltc_encoder_create_alloc (&misaligned, 48000, 25, 0, 0) != NULL
+			|| ltc_decoder_create_alloc (&misaligned, 1920, 4, 0) != NULL
+			|| n_alloc != 0) {
+		rv = -1;
+	}
+	return rv;
+}
+
+/* switch from 48 kHz to 96 kHz while encoding and decoding */
+static int check_reconfigure(void) {
+	const LTCAllocator allocator = { count_alloc, count_free, NULL };
+	LTCEncoder *encoder = ltc_encoder_create_alloc (&allocator, 48000, 25, 0, 0);
+	LTCDecoder *decoder = ltc_decoder_create_alloc (&allocator, 1920, 16, 0);
+	ltcsnd_sample_t *buf;
+	LTCFrameExt frame;
+	ltc_off_t pos = 0;
+	int rv = 0, n, len, cnt = 0, expect = 0, lost = 0;
+
+	if (ltc_encoder_reconfigure (encoder, 96000, 25) != -1
+			|| ltc_encoder_reserve (encoder, 96000, 24) != 0
+			|| ltc_decoder_reconfigure (decoder, -1) != -1) {
+		rv = -1;
+	}
+	const int allocated = n_alloc;
+
+	for (n = 0; n < 12; ++n) {
+		if (n == 6) {
+			if (ltc_encoder_reconfigure (encoder, 96000, 25) || ltc_decoder_reconfigure (decoder, 3840)) {
+				rv = -1;
+			}
+		}
+		ltc_encoder_encode_frame (encoder);
+		ltc_encoder_inc_timecode (encoder);
+		len = ltc_encoder_get_bufferptr (encoder, &buf, 1);
+		ltc_decoder_write (decoder, buf, len, pos);
+		pos += len;
+		while (ltc_decoder_read (decoder, &frame)) {
+			/* frames are consecutive, (at most) the frame at the switch is lost */
+			const int f = frame.ltc.frame_units + 10 * frame.ltc.frame_tens;
+			if (f != expect && f != expect + 1) {
+				rv = -1;
+			}
+			lost += f - expect;
+			expect = f + 1;
+			++cnt;
+		}
+	}
+	if (cnt < 10 || lost > 1 || n_alloc != allocated || ltc_encoder_get_buffersize (encoder) != 3841) {
+		rv = -1;
+	}
+	ltc_encoder_free (encoder);
+	ltc_decoder_free (decoder);
+	return rv;
+}
+
+/* shuttle: slow down to 1/4 speed and back, then play in reverse */
+static int check_varispeed(void) {
+	LTCEncoder *encoder = ltc_encoder_create (48000, 25, 0, 0);
+	LTCEncoder *reference = ltc_encoder_create (48000, 25, 0, 0);
+	LTCDecoder *decoder = ltc_decoder_create (1920, 8);
+	ltcsnd_sample_t *buf, *ref;
+	LTCFrameExt frame;
+	ltc_off_t pos = 0;
+	double total = 0;
+	int rv = 0, n, len, cnt = 0, expect = 0;
+
+	/* nominal speed is identical to ltc_encoder_encode_frame */
+	ltc_encoder_encode_frame (reference);
+	ltc_encoder_get_bufferptr (reference, &ref, 1);
+	if (ltc_encoder_encode_frame_varispeed (encoder, 1.0, 1.0)
+			|| ltc_encoder_get_bufferptr (encoder, &buf, 1) != 1920
+			|| memcmp (buf, ref, 1920)) {
+		rv = -1;
+	}
+	ltc_encoder_reset (encoder);
+
+	/* does not fit into the default buffer, mixed directions are invalid */
+	if (ltc_encoder_encode_frame_varispeed (encoder, 1.0, 0.9) != -1
+			|| ltc_encoder_encode_frame_varispeed (encoder, 1.0, -1.0) != -1
+			|| ltc_encoder_get_bufferptr (encoder, &buf, 1) != 0
+			|| ltc_encoder_set_min_speed (encoder, 0.25)
+			|| ltc_encoder_get_buffersize (encoder) != 7681) {
+		rv = -1;
+	}
+
+	for (n = 0; n < 30; ++n) {
+		const double s0 = n < 15 ? 1.0 - .05 * n : .3 + .05 * (n - 15);
+		const double s1 = n < 15 ? 1.0 - .05 * (n + 1) : .3 + .05 * (n - 14);
+		if (ltc_encoder_encode_frame_varispeed (encoder, s0, s1)) {
+			rv = -1;
+		}
+		ltc_encoder_inc_timecode (encoder);
+		total += 1920 * (log (s0) - log (s1)) / (s0 - s1);
+		len = ltc_encoder_get_bufferptr (encoder, &buf, 1);
+		ltc_decoder_write (decoder, buf, len, pos);
+		pos += len;
+		while (ltc_decoder_read (decoder, &frame)) {
+			if (frame.reverse || frame.ltc.frame_units + 10 * frame.ltc.frame_tens != expect) {
+				rv = -1;
+			}
+			expect = (expect + 1) % 25;
+			++cnt;
+		}
+	}
+	if (cnt < 29 || fabs (pos - total) > 1) {
+		fprintf (stderr, "varispeed: decoded %d of 30 frames, %d of %.1f samples\n", cnt, (int) pos, total);
+		rv = -1;
+	}
+
+	/* reverse, accelerating */
+	ltc_decoder_queue_flush (decoder);
+	cnt = 0;
+	for (n = 0; n < 10; ++n) {
+		ltc_encoder_dec_timecode (encoder);
+		if (ltc_encoder_encode_frame_varispeed (encoder, -.5 - .05 * n, -.55 - .05 * n)) {
+			rv = -1;
+		}
+		len = ltc_encoder_get_bufferptr (encoder, &buf, 1);
+		ltc_decoder_write (decoder, buf, len, pos);
+		pos += len;
+		while (ltc_decoder_read (decoder, &frame)) {
+			if (frame.reverse) {
+				++cnt;
+			}
+		}
+	}
+	if (cnt < 8) {
+		fprintf (stderr, "varispeed: decoded %d of 10 reverse frames\n", cnt);
+		rv = -1;
+	}
+
+	ltc_encoder_free (encoder);
+	ltc_encoder_free (reference);
+	ltc_decoder_free (decoder);
+	return rv;
+}
+
+/** compare the fields of a compact record with a frame */
+static int same_compact(const LTCFrameCompact *c, const LTCFrameExt *f) {
+	return !memcmp (&c->ltc, &f->ltc, sizeof (LTCFrame))
+		&& c->off_start == f->off_start && c->off_end == f->off_end && c->reverse == f->reverse
+		&& c->sample_min == f->sample_min && c->sample_max == f->sample_max && c->volume == f->volume;
+}
+
+/* in-place access to a small queue that wraps around, compared with ltc_decoder_read */
+static int check_peek(void) {
+	LTCEncoder *encoder = ltc_encoder_create (48000, 25, LTC_TV_625_50, 0);
+	LTCDecoder *ref = ltc_decoder_create (1920, 32);
+	LTCDecoder *decoder = ltc_decoder_create (1920, 5);
+	LTCDecoder *compact = ltc_decoder_create_ex (1920, 5, LTC_DECODER_COMPACT);
+	ltcsnd_sample_t *buf = (ltcsnd_sample_t*) malloc (3 * 1920);
+	const LTCFrameExt *frames;
+	const LTCFrameCompact *cframes;
+	LTCFrameExt frame;
+	int rv = 0, round, len, n, i, cnt = 0, wrapped = 0;
+
+	if (ltc_decoder_peek (compact, &frames) != -1 || ltc_decoder_peek_compact (decoder, &cframes) != -1
+			|| ltc_decoder_peek (decoder, &frames) != 0 || frames != NULL || ltc_decoder_consume (decoder, 1) != 0) {
+		rv = -1;
+	}
+
+	for (round = 0; round < 12; ++round) {
+		/* 3 frames per write */
+		for (i = 0, len = 0; i < 3; ++i) {
+			ltc_encoder_encode_frame (encoder);
+			ltc_encoder_inc_timecode (encoder);
+			len += ltc_encoder_copy_buffer (encoder, &buf[len]);
+		}
+		ltc_decoder_write (ref, buf, len, round * len);
+		ltc_decoder_write (decoder, buf, len, round * len);
+		ltc_decoder_write (compact, buf, len, round * len);
+
+		if (ltc_decoder_queue_length (compact) != ltc_decoder_queue_length (ref)
+				|| ltc_decoder_queue_length (decoder) != ltc_decoder_queue_length (ref)) {
+			rv = -1;
+			break;
+		}
+
+		/* consume at most two frames at a time, a wrapped queue is returned in two parts */
+		while ((n = ltc_decoder_peek (decoder, &frames)) > 0) {
+			const int m = n < 2 ? n : 2;
+			if (n < ltc_decoder_queue_length (decoder)) {
+				++wrapped;
+			}
+			if (ltc_decoder_peek_compact (compact, &cframes) != n) {
+				rv = -1;
+			}
+			for (i = 0; i < m; ++i, ++cnt) {
+				if (!ltc_decoder_read (ref, &frame) || memcmp (&frames[i], &frame, sizeof (LTCFrameExt))
+						|| !same_compact (&cframes[i], &frame)) {
+					fprintf (stderr, "peek: frame %d differs\n", cnt);
+					rv = -1;
+				}
+			}
+			if (ltc_decoder_consume (decoder, m) != m || ltc_decoder_consume (compact, m) != m) {
+				rv = -1;
+			}
+		}
+		if (n != 0 || ltc_decoder_queue_length (ref) != 0) {
+			rv = -1;
+		}
+	}
+	if (ltc_decoder_consume (decoder, 10) != 0 || ltc_decoder_queue_overruns (decoder) != 0) {
+		rv = -1;
+	}
+	if (cnt < 35 || !wrapped) {
+		fprintf (stderr, "peek: %d frames, the queue wrapped %d times\n", cnt, wrapped);
+		rv = -1;
+	}
+
+	ltc_encoder_free (encoder);
+	ltc_decoder_free (ref);
+	ltc_decoder_free (decoder);
+	ltc_decoder_free (compact);
+	free (buf);
+	return rv;
+}
+
+/* compact records from either kind of queue, compared with ltc_decoder_read */
+static int check_compact(void) {
+	LTCEncoder *encoder = ltc_encoder_create (48000, 25, LTC_TV_625_50, 0);
+	LTCDecoder *ref = ltc_decoder_create (1920, 8);
+	LTCDecoder *decoder = ltc_decoder_create (1920, 8);
+	LTCDecoder *compact = ltc_decoder_create_ex (1920, 8, LTC_DECODER_COMPACT);
+	ltcsnd_sample_t *buf;
+	const float zero[LTC_FRAME_BIT_COUNT] = { 0 };
+	LTCFrameExt frame, cext;
+	LTCFrameCompact a, b;
+	int rv = 0, n, len, cnt = 0;
+
+	if (ltc_decoder_size (8, LTC_DECODER_COMPACT) >= ltc_decoder_size (8, 0)
+			|| ltc_decoder_read_compact (compact, NULL) != -1) {
+		rv = -1;
+	}
+
+	for (n = 0; n < 20; ++n) {
+		ltc_encoder_encode_frame (encoder);
+		ltc_encoder_inc_timecode (encoder);
+		len = ltc_encoder_get_bufferptr (encoder, &buf, 1);
+		ltc_decoder_write (ref, buf, len, n * len);
+		ltc_decoder_write (decoder, buf, len, n * len);
+		ltc_decoder_write (compact, buf, len, n * len);
+
+		while (ltc_decoder_read (ref, &frame)) {
+			/* alternate between both read functions on the compact queue */
+			if (!ltc_decoder_read_compact (decoder, &a) || !same_compact (&a, &frame)) {
+				rv = -1;
+			}
+			if (cnt & 1) {
+				if (!ltc_decoder_read_compact (compact, &b) || !same_compact (&b, &frame)) {
+					rv = -1;
+				}
+			} else {
+				if (!ltc_decoder_read (compact, &cext) || memcmp (cext.biphase_tics, zero, sizeof (zero))) {
+					rv = -1;
+				}
+				memcpy (cext.biphase_tics, frame.biphase_tics, sizeof (zero));
+				if (memcmp (&cext, &frame, sizeof (LTCFrameExt))) {
+					rv = -1;
+				}
+			}
+			++cnt;
+		}
+	}
+	if (cnt < 19 || ltc_decoder_read_compact (decoder, &a) || ltc_decoder_read_compact (compact, &b)) {
+		fprintf (stderr, "compact: decoded %d of 20 frames\n", cnt);
+		rv = -1;
+	}
+
+	ltc_encoder_free (encoder);
+	ltc_decoder_free (ref);
+	ltc_decoder_free (decoder);
+	ltc_decoder_free (compact);
+	return rv;
+}
+
+/* compact records with the bit timing of each queued frame */
+static int check_tics(void) {
+	LTCEncoder *encoder = ltc_encoder_create (48000, 25, LTC_TV_625_50, 0);
+	LTCDecoder *ref = ltc_decoder_create (1920, 8);
+	LTCDecoder *decoder = ltc_decoder_create_ex (1920, 8, LTC_DECODER_COMPACT | LTC_DECODER_TICS);
+	LTCDecoder *compact = ltc_decoder_create_ex (1920, 8, LTC_DECODER_COMPACT);
+	ltcsnd_sample_t *buf = (ltcsnd_sample_t*) malloc (4 * 3841);
+	LTCFrameExt frames[8], frame;
+	LTCFrameCompact cframe;
+	float tics[LTC_FRAME_BIT_COUNT];
+	ltc_off_t pos = 0;
+	int rv = 0, round, len, n, i;
+
+	if (ltc_decoder_size (8, LTC_DECODER_COMPACT | LTC_DECODER_TICS) != ltc_decoder_size (8, LTC_DECODER_COMPACT) + 8 * sizeof (tics)
+			|| ltc_decoder_size (8, LTC_DECODER_TICS) != ltc_decoder_size (8, 0)) {
+		rv = -1;
+	}
+	ltc_encoder_set_min_speed (encoder, 0.5);
+
+	for (round = 0; round < 3; ++round) {
+		/* the speed changes with every frame, all frames are written at once */
+		for (i = 0, len = 0; i < 4; ++i) {
+			const double speed = 1.0 - .05 * (4 * round + i);
+			ltc_encoder_encode_frame_varispeed (encoder, speed, speed);
+			ltc_encoder_inc_timecode (encoder);
+			len += ltc_encoder_copy_buffer (encoder, &buf[len]);
+		}
+		ltc_decoder_write (ref, buf, len, pos);
+		ltc_decoder_write (decoder, buf, len, pos);
+		ltc_decoder_write (compact, buf, len, pos);
+		pos += len;
+
+		n = ltc_decoder_queue_length (ref);
+		if (n < 3 || n != ltc_decoder_queue_length (decoder)
+				|| ltc_decoder_peek_tics (ref, 0, tics) || ltc_decoder_peek_tics (compact, 0, tics) != -1) {
+			rv = -1;
+			break;
+		}
+		for (i = 0; i < n; ++i) {
+			ltc_decoder_read (ref, &frames[i]);
+		}
+		if (!memcmp (frames[0].biphase_tics, frames[n - 1].biphase_tics, sizeof (tics))) {
+			rv = -1;
+		}
+		/* the queue wraps around in the second round */
+		for (i = 0; i < n; ++i) {
+			if (ltc_decoder_peek_tics (decoder, n - 1 - i, tics) || memcmp (tics, frames[n - 1 - i].biphase_tics, sizeof (tics))) {
+				fprintf (stderr, "tics: frame %d of round %d differs\n", n - 1 - i, round);
+				rv = -1;
+			}
+		}
+		if (ltc_decoder_peek_tics (decoder, n, tics) != -1 || ltc_decoder_peek_tics (decoder, -1, tics) != -1) {
+			rv = -1;
+		}
+		/* positions follow the reads */
+		for (i = 0; i < n; ++i) {
+			ltc_decoder_peek_tics (decoder, 0, tics);
+			if (i & 1) {
+				ltc_decoder_read (decoder, &frame);
+				if (memcmp (frame.biphase_tics, frames[i].biphase_tics, sizeof (tics)) || frame.off_start != frames[i].off_start) {
+					rv = -1;
+				}
+			} else {
+				ltc_decoder_read_compact (decoder, &cframe);
+				if (cframe.off_start != frames[i].off_start) {
+					rv = -1;
+				}
+			}
+			if (memcmp (tics, frames[i].biphase_tics, sizeof (tics))) {
+				rv = -1;
+			}
+		}
+		ltc_decoder_queue_flush (compact);
+	}
+
+	ltc_encoder_free (encoder);
+	ltc_decoder_free (ref);
+	ltc_decoder_free (decoder);
+	ltc_decoder_free (compact);
+	free (buf);
+	return rv;
+}
+
+/* band-limited LTC with noise, which the threshold detector alone can not decode */
+static int check_matched(void) {
+	const int n_samples = 100 * 1920;
+	float *sig = (float*) malloc (n_samples * sizeof (float));
+	short *s16 = (short*) malloc (n_samples * sizeof (short));
+	LTCEncoder *encoder = ltc_encoder_create (48000, 25, LTC_TV_625_50, 0);
+	unsigned int seed = 1;
+	float z = 0;
+	int rv = 0, i, m;
+
+	ltc_encoder_render_reset (encoder, 0);
+	ltc_encoder_render_float (encoder, sig, n_samples);
+	ltc_encoder_free (encoder);
+
+	for (m = 0; m < 4; ++m) {
+		const int flags = (m & 1) ? LTC_DECODER_MATCHED : 0;
+		LTCDecoder *decoder = ltc_decoder_create_ex (1920, 8, flags);
+		LTCFrameExt frame;
+		int off, cnt = 0, bad = 0;
+
+		if (m == 2) {
+			/* 3 kHz low-pass, -6 dBFS, noise at -17 dB RMS */
+			for (i = 0; i < n_samples; ++i) {
+				float n = 0;
+				int k;
+				for (k = 0; k < 2; ++k) {
+					seed = seed * 1664525u + 1013904223u;
+					n += (seed >> 8) * (2.f / 16777216.f) - 1.f;
+				}
+				z += .325f * (sig[i] - z);
+				sig[i] = .5f * z + .245f * n;
+			}
+		}
+		for (i = 0; i < n_samples; ++i) {
+			s16[i] = sig[i] * 32767.f;
+		}
+
+		for (off = 0; off < n_samples; off += 1000) {
+			const int n = n_samples - off < 1000 ? n_samples - off : 1000;
+			if (m < 2) {
+				ltc_decoder_write_float (decoder, &sig[off], n, off);
+			} else {
+				ltc_decoder_write_s16 (decoder, &s16[off], n, off);
+			}
+			while (ltc_decoder_read (decoder, &frame)) {
+				const int f = frame.ltc.frame_units + 10 * frame.ltc.frame_tens + 25 * frame.ltc.secs_units;
+				/* the start is estimated from the bit-phase, which jitters with noise */
+				if (llabs (frame.off_start - 1920LL * f) > (m < 2 ? 4 : 24) || frame.reverse) {
+					++bad;
+				} else {
+					++cnt;
+				}
+			}
+		}
+		ltc_decoder_free (decoder);
+
+		if (m < 2 && (cnt < 99 || bad)) {
+			fprintf (stderr, "matched: decoded %d of 100 frames (flags %d), %d bad\n", cnt, flags, bad);
+			rv = -1;
+		}
+		if (m == 2 && cnt > 50) {
+			fprintf (stderr, "matched: noise too low to test, %d frames decoded\n", cnt);
+			rv = -1;
+		}
+		if (m == 3 && (cnt < 95 || bad > 2)) {
+			fprintf (stderr, "matched: decoded %d of 100 noisy frames, %d bad\n", cnt, bad);
+			rv = -1;
+		}
+	}
+
+	free (s16);
+	free (sig);
+	return rv;
+}
+
 int main(int argc, char **argv) {
 	double fps = 25;
 	double samplerate = 48000;
@@ -91,8 +606,157 @@ int main(int argc, char **argv) {
 #endif
 	}
 
+	/* Statistics */
+	LTCDecoderStats stats;
+	ltc_decoder_stats (decoder, &stats);
+	if (stats.samples != (unsigned long long)off || stats.frames != (unsigned long long)vframe_end
+			|| stats.frames_reverse != 0 || stats.overruns != 0 || stats.bits < 80 * vframe_end) {
+		vframe_cnt = -1;
+	}
+	ltc_decoder_stats_reset (decoder);
+	ltc_decoder_stats (decoder, &stats);
+	if (stats.samples != 0 || stats.frames != 0) {
+		vframe_cnt = -1;
+	}
+
+	ltc_decoder_free (decoder);
+
+	/* Decode native formats */
+	int rv = vframe_cnt == 0 ? 0 : -1;
+	float* fbuf = malloc (off * sizeof (float));
+	short* sbuf = malloc (off * sizeof (short));
+	for (int i = 0; i < off; ++i) {
+		fbuf[i] = (buf[i] - 128) / 127.f;
+		sbuf[i] = (buf[i] - 128) * 256;
+	}
+
+	decoder = ltc_decoder_create(samplerate / fps, vframe_end);
+	ltc_decoder_write_float (decoder, fbuf, off, 0);
+	for (vframe_cnt = 0; ltc_decoder_read (decoder, &frame); ++vframe_cnt) ;
+	if (vframe_cnt != vframe_end) {
+		rv = -1;
+	}
+	ltc_decoder_free (decoder);
+
+	decoder = ltc_decoder_create(samplerate / fps, vframe_end);
+	ltc_decoder_write_s16 (decoder, sbuf, off, 0);
+	for (vframe_cnt = 0; ltc_decoder_read (decoder, &frame); ++vframe_cnt) ;
+	if (vframe_cnt != vframe_end) {
+		rv = -1;
+	}
 	ltc_decoder_free (decoder);
+
+	/* Bulk encode, compare */
+	ltcsnd_sample_t* bbuf = malloc ((1 + vframe_end) * frame_size);
+	encoder = ltc_encoder_create (samplerate, fps, 0, 0);
+	ltc_encoder_set_filter(encoder, 0);
+	ltc_encoder_set_volume(encoder, -3.0);
+
+	int boff = ltc_encoder_encode_frames (encoder, vframe_end, bbuf, vframe_end * frame_size);
+	ltc_encoder_end_encode (encoder);
+	boff += ltc_encoder_copy_buffer (encoder, &bbuf[boff]);
+	ltc_encoder_free(encoder);
+
+	if (boff != off || memcmp (buf, bbuf, off)) {
+		rv = -1;
+	}
+
+	/* Early frames, the 7th frame is cut off after 90% */
+	encoder = ltc_encoder_create (samplerate, fps, 0, 0);
+	ltc_encoder_set_filter(encoder, 0);
+	ltc_encoder_set_volume(encoder, -3.0);
+	ltcsnd_sample_t* ebuf = malloc (11 * frame_size);
+	const int apv = samplerate / fps;
+	const int cut = 6.9 * apv;
+	int eoff = ltc_encoder_encode_frames (encoder, 10, ebuf, 10 * frame_size);
+	ltc_encoder_end_encode (encoder);
+	eoff += ltc_encoder_copy_buffer (encoder, &ebuf[eoff]);
+	ltc_encoder_free(encoder);
+
+	memset (&ebuf[cut], 128, 7 * apv - cut);
+	decoder = ltc_decoder_create_ex(apv, 16, LTC_DECODER_EARLY);
+
+	LTCFrameEarly early, prov;
+	int n_prov = 0, n_conf = 0, n_retr = 0;
+	memset (&prov, 0, sizeof (prov));
+	for (int i = 0; i < eoff; i += 256) {
+		ltc_decoder_write (decoder, &ebuf[i], eoff - i < 256 ? eoff - i : 256, i);
+		while (ltc_decoder_read_early (decoder, &early)) {
+			switch (early.status) {
+				case LTC_EARLY_PROVISIONAL:
+					prov = early;
+					++n_prov;
+					break;
+				case LTC_EARLY_CONFIRMED:
+					/* must match the queued frame, and precede it by about 16 bits */
+					if (!ltc_decoder_read (decoder, &frame)
+							|| memcmp (&frame.ltc, &early.ltc, sizeof (LTCFrame))
+							|| memcmp (&prov.ltc, &early.ltc, sizeof (LTCFrame))
+							|| frame.off_end - prov.off_event < apv / 8) {
+						rv = -1;
+					}
+					++n_conf;
+					break;
+				case LTC_EARLY_RETRACTED:
+					if (memcmp (&prov.ltc, &early.ltc, sizeof (LTCFrame))) {
+						rv = -1;
+					}
+					++n_retr;
+					break;
+			}
+		}
+		while (ltc_decoder_read (decoder, &frame)) ;
+	}
+	if (n_prov != n_conf + n_retr || n_retr != 1 || n_conf < 6) {
+		rv = -1;
+	}
+	ltc_decoder_free (decoder);
+
+	/* Auto-detection without apv: 25 fps, silence, 29.97 fps drop-frame */
+	{
+		const double rates[2] = { 25, 29.97 };
+		int n_frames[2] = { 0, 0 };
+		ltc_off_t pos = 0;
+		double dfps = 0;
+		int df = -1;
+
+		decoder = ltc_decoder_create_ex(0, 16, LTC_DECODER_AUTODETECT);
+		if (ltc_decoder_detect (decoder, samplerate, &dfps, &df) != 0) {
+			rv = -1;
+		}
+		for (int k = 0; k < 2; ++k) {
+			encoder = ltc_encoder_create (samplerate, rates[k], LTC_TV_525_60, 0);
+			ltc_encoder_set_filter(encoder, 0);
+			const int aoff = ltc_encoder_encode_frames (encoder, 10, ebuf, 10 * frame_size);
+			ltc_encoder_free(encoder);
+
+			ltc_decoder_write (decoder, ebuf, aoff, pos);
+			pos += aoff;
+			while (ltc_decoder_read (decoder, &frame)) ++n_frames[k];
+
+			/* less than a second: estimated from the bit period */
+			if (ltc_decoder_detect (decoder, samplerate, &dfps, &df) != 1 || fabs (dfps - rates[k]) > 0.01 || df != k) {
+				rv = -1;
+			}
+			memset (ebuf, 128, frame_size);
+			ltc_decoder_write (decoder, ebuf, frame_size, pos);
+			pos += frame_size;
+		}
+		if (n_frames[0] < 8 || n_frames[1] < 8) {
+			rv = -1;
+		}
+		ltc_decoder_free (decoder);
+	}
+
+	if (check_memory () || check_reconfigure () || check_peek () || check_compact () || check_tics () || check_varispeed () || check_matched ()) {
+		rv = -1;
+	}
+
+	free (ebuf);
+	free (bbuf);
+	free (sbuf);
+	free (fbuf);
 	free (buf);
 
-	return vframe_cnt == 0 ? 0 : -1;
+	return rv;
 }
@@ -0,0 +1,150 @@
+/**
+   @brief self-test frame serialization
+   @file ltcpacket.c
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ltc.h>
+
+#define N_FRAMES 50
+
+/** encode and decode a few seconds of LTC */
+static int decode_frames(LTCFrameExt *frames) {
+	LTCEncoder *encoder = ltc_encoder_create (48000, 25, LTC_TV_625_50, 0);
+	LTCDecoder *decoder = ltc_decoder_create (1920, 8);
+	ltcsnd_sample_t *buf;
+	ltc_off_t pos = 123456789012LL;
+	int n, len, cnt = 0;
+
+	for (n = 0; n < N_FRAMES + 1; ++n) {
+		ltc_encoder_encode_frame (encoder);
+		ltc_encoder_inc_timecode (encoder);
+		len = ltc_encoder_get_bufferptr (encoder, &buf, 1);
+		ltc_decoder_write (decoder, buf, len, pos);
+		pos += len;
+		while (cnt < N_FRAMES && ltc_decoder_read (decoder, &frames[cnt])) {
+			++cnt;
+		}
+	}
+	ltc_encoder_free (encoder);
+	ltc_decoder_free (decoder);
+	return cnt;
+}
+
+static int same_frame(const LTCFrameExt *a, const LTCFrameExt *b, int fields) {
+	if (memcmp (&a->ltc, &b->ltc, sizeof (LTCFrame)) || !a->reverse != !b->reverse) {
+		return 0;
+	}
+	if ((fields & LTC_PACKET_OFFSETS) && (a->off_start != b->off_start || a->off_end != b->off_end)) {
+		return 0;
+	}
+	if ((fields & LTC_PACKET_QUALITY) && (a->sample_min != b->sample_min
+				|| a->sample_max != b->sample_max || (float) a->volume != (float) b->volume)) {
+		return 0;
+	}
+	return 1;
+}
+
+static int check_roundtrip(const LTCFrameExt *frames, int fields, size_t max_len) {
+	LTCFrameExt out[N_FRAMES];
+	const size_t size = ltc_frames_packed_size (N_FRAMES, fields);
+	unsigned char *buf = malloc (size);
+	size_t len;
+	int i, f = -1, rv = 0;
+
+	len = ltc_frames_pack (buf, size, frames, N_FRAMES, fields);
+	if (len == 0 || len > max_len
+			|| ltc_frames_packed_count (buf, len) != N_FRAMES
+			|| ltc_frames_unpack (out, N_FRAMES, buf, len, &f) != N_FRAMES
+			|| f != fields) {
+		fprintf (stderr, "packet: fields %d, length %d\n", fields, (int) len);
+		rv = -1;
+	} else {
+		for (i = 0; i < N_FRAMES; ++i) {
+			if (!same_frame (&frames[i], &out[i], fields)) {
+				fprintf (stderr, "packet: frame %d differs (fields %d)\n", i, fields);
+				rv = -1;
+				break;
+			}
+		}
+	}
+
+	/* truncated, too small destination */
+	if (len > 0 && (ltc_frames_unpack (out, N_FRAMES, buf, len - 1, NULL) != -1
+				|| ltc_frames_unpack (out, N_FRAMES - 1, buf, len, NULL) != -1
+				|| ltc_frames_pack (buf, len - 1, frames, N_FRAMES, fields) != 0)) {
+		fprintf (stderr, "packet: truncation was not detected\n");
+		rv = -1;
+	}
+	free (buf);
+	return rv;
+}
+
+static int check_header(const LTCFrameExt *frames) {
+	unsigned char buf[64];
+	LTCFrameExt out;
+	int rv = 0;
+	size_t len = ltc_frames_pack (buf, sizeof (buf), frames, 1, LTC_PACKET_OFFSETS);
+
+	if (len == 0 || ltc_frames_unpack (&out, 1, buf, len, NULL) != 1) {
+		rv = -1;
+	}
+	/* newer format version */
+	buf[4] = LTC_PACKET_VERSION + 1;
+	if (ltc_frames_packed_count (buf, len) != -1 || ltc_frames_unpack (&out, 1, buf, len, NULL) != -1) {
+		rv = -1;
+	}
+	buf[4] = LTC_PACKET_VERSION;
+	buf[0] = 'X';
+	if (ltc_frames_packed_count (buf, len) != -1) {
+		rv = -1;
+	}
+	/* empty packet */
+	len = ltc_frames_pack (buf, sizeof (buf), NULL, 0, 0);
+	if (len != 7 || ltc_frames_unpack (NULL, 0, buf, len, NULL) != 0) {
+		rv = -1;
+	}
+	if (rv) {
+		fprintf (stderr, "packet: invalid header was not detected\n");
+	}
+	return rv;
+}
+
+int main(void) {
+	LTCFrameExt frames[N_FRAMES];
+	int rv = 0;
+
+	if (decode_frames (frames) != N_FRAMES) {
+		fprintf (stderr, "packet: decoding failed\n");
+		return -1;
+	}
+	frames[7].reverse = 1;
+
+	/* continuous frames need 3 bytes for the offsets, except the first */
+	if (check_roundtrip (frames, 0, 7 + N_FRAMES * 11)) rv = -1;
+	if (check_roundtrip (frames, LTC_PACKET_OFFSETS, 7 + 6 + N_FRAMES * 14)) rv = -1;
+	if (check_roundtrip (frames, LTC_PACKET_OFFSETS | LTC_PACKET_QUALITY, 7 + 6 + N_FRAMES * 20)) rv = -1;
+	if (check_header (frames)) rv = -1;
+	return rv;
+}
@@ -0,0 +1,237 @@
+/**
+   @brief self-test encoder output formats
+   @file ltcrender.c
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <ltc.h>
+
+#define RATE 48000
+#define N_SAMPLES (2 * RATE)
+
+static LTCEncoder* create(int filter) {
+	LTCEncoder *encoder = ltc_encoder_create(RATE, 25, LTC_TV_625_50, 0);
+	if (!filter) {
+		ltc_encoder_set_filter(encoder, 0);
+	}
+	ltc_encoder_render_reset(encoder, 0);
+	return encoder;
+}
+
+/** render in chunks of varying size, which split edges */
+static size_t chunk(size_t off) {
+	const size_t n = 1 + (off * 7) % 1013;
+	return N_SAMPLES - off < n ? N_SAMPLES - off : n;
+}
+
+static int rd_s24(const unsigned char *p) {
+	return (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) >> 8;
+}
+
+/* integer formats match the floating point signal within one LSB */
+static int check_formats(void) {
+	float *fbuf = (float*) malloc(N_SAMPLES * sizeof(float));
+	short *sbuf = (short*) malloc(N_SAMPLES * sizeof(short));
+	unsigned char *buf24 = (unsigned char*) malloc(3 * N_SAMPLES);
+	int rv = 0, filter;
+	size_t i, off;
+
+	for (filter = 0; filter < 2; ++filter) {
+		LTCEncoder *ef = create(filter);
+		LTCEncoder *es = create(filter);
+		LTCEncoder *e24 = create(filter);
+		float peak = 0;
+
+		for (off = 0; off < N_SAMPLES; off += chunk(off)) {
+			ltc_encoder_render_float(ef, &fbuf[off], chunk(off));
+			ltc_encoder_render_s16(es, &sbuf[off], chunk(off));
+			ltc_encoder_render_s24(e24, &buf24[3 * off], chunk(off));
+		}
+
+		for (i = 0; i < N_SAMPLES; ++i) {
+			if (fabsf(fbuf[i]) > peak) peak = fabsf(fbuf[i]);
+			if (fabsf(sbuf[i] - fbuf[i] * 32767.f) > 1.f || fabsf(rd_s24(&buf24[3 * i]) - fbuf[i] * 8388607.f) > 1.f) {
+				fprintf(stderr, "formats: sample %d differs (filter %d)\n", (int) i, filter);
+				rv = -1;
+				break;
+			}
+		}
+		/* the encoder's default level is -3dBFS */
+		if (peak < .5f || peak > 1.f) {
+			fprintf(stderr, "formats: peak level %f\n", peak);
+			rv = -1;
+		}
+
+		ltc_encoder_free(ef);
+		ltc_encoder_free(es);
+		ltc_encoder_free(e24);
+	}
+
+	free(fbuf);
+	free(sbuf);
+	free(buf24);
+	return rv;
+}
+
+enum Format { FMT_U8, FMT_FLOAT, FMT_S16, FMT_S24 };
+
+static const size_t sample_size[] = { 1, sizeof(float), sizeof(short), 3 };
+
+static void render(LTCEncoder *e, enum Format fmt, unsigned char *buf, size_t n) {
+	switch (fmt) {
+		case FMT_U8: ltc_encoder_render(e, buf, n); break;
+		case FMT_FLOAT: ltc_encoder_render_float(e, (float*) buf, n); break;
+		case FMT_S16: ltc_encoder_render_s16(e, (short*) buf, n); break;
+		default: ltc_encoder_render_s24(e, buf, n); break;
+	}
+}
+
+static void render_interleaved(LTCEncoder *e, enum Format fmt, unsigned char *buf, int stride, int channel, size_t n) {
+	switch (fmt) {
+		case FMT_U8: ltc_encoder_render_interleaved(e, buf, stride, channel, n); break;
+		case FMT_FLOAT: ltc_encoder_render_interleaved_float(e, (float*) buf, stride, channel, n); break;
+		case FMT_S16: ltc_encoder_render_interleaved_s16(e, (short*) buf, stride, channel, n); break;
+		default: ltc_encoder_render_interleaved_s24(e, buf, stride, channel, n); break;
+	}
+}
+
+static void render_bank(LTCEncoderBank *b, enum Format fmt, unsigned char *buf, size_t n) {
+	switch (fmt) {
+		case FMT_U8: ltc_encoder_bank_render(b, buf, n); break;
+		case FMT_FLOAT: ltc_encoder_bank_render_float(b, (float*) buf, n); break;
+		case FMT_S16: ltc_encoder_bank_render_s16(b, (short*) buf, n); break;
+		default: ltc_encoder_bank_render_s24(b, buf, n); break;
+	}
+}
+
+/* a channel of an interleaved buffer equals ltc_encoder_render, other channels are not modified */
+static int check_interleaved(void) {
+	const int stride = 3;
+	int rv = 0, fmt, c;
+	size_t i, off;
+
+	for (fmt = FMT_U8; fmt <= FMT_S24; ++fmt) {
+		const size_t sz = sample_size[fmt];
+		unsigned char *mono = (unsigned char*) malloc(N_SAMPLES * sz);
+		unsigned char *buf = (unsigned char*) malloc(N_SAMPLES * stride * sz);
+		LTCEncoder *ref = create(1);
+		LTCEncoder *encoder = create(1);
+
+		memset(buf, 0x5a, N_SAMPLES * stride * sz);
+		for (off = 0; off < N_SAMPLES; off += chunk(off)) {
+			render(ref, fmt, &mono[off * sz], chunk(off));
+			render_interleaved(encoder, fmt, &buf[off * stride * sz], stride, 1, chunk(off));
+		}
+
+		for (i = 0; i < N_SAMPLES; ++i) {
+			for (c = 0; c < stride; ++c) {
+				const unsigned char *p = &buf[(i * stride + c) * sz];
+				size_t k;
+				int err = 0;
+				if (c == 1) {
+					err = memcmp(p, &mono[i * sz], sz);
+				} else {
+					for (k = 0; k < sz; ++k) err |= p[k] != 0x5a;
+				}
+				if (err) {
+					fprintf(stderr, "interleaved: format %d sample %d channel %d differs\n", fmt, (int) i, c);
+					rv = -1;
+					i = N_SAMPLES;
+					break;
+				}
+			}
+		}
+
+		ltc_encoder_free(ref);
+		ltc_encoder_free(encoder);
+		free(mono);
+		free(buf);
+	}
+	return rv;
+}
+
+/* the channels of a bank match individually configured single encoders */
+static int check_bank(void) {
+	const int channels = 5;
+	int rv = 0, fmt, c, k;
+	size_t i, off;
+
+	for (fmt = FMT_U8; fmt <= FMT_S24; ++fmt) {
+		const size_t sz = sample_size[fmt];
+		unsigned char *mono = (unsigned char*) malloc(N_SAMPLES * channels * sz);
+		unsigned char *buf = (unsigned char*) malloc(N_SAMPLES * channels * sz);
+		LTCEncoderBank *bank = ltc_encoder_bank_create(channels, RATE, 25, LTC_TV_625_50, 0);
+		LTCEncoder *ref[5];
+
+		if (ltc_encoder_bank_channels(bank) != channels || ltc_encoder_bank_encoder(bank, channels) != NULL) {
+			rv = -1;
+		}
+		/* offset timecode and different levels */
+		for (c = 0; c < channels; ++c) {
+			LTCEncoder *e = ltc_encoder_bank_encoder(bank, c);
+			ref[c] = create(1);
+			for (k = 0; k < c; ++k) {
+				ltc_encoder_inc_timecode(e);
+				ltc_encoder_inc_timecode(ref[c]);
+			}
+			ltc_encoder_set_volume(e, -3 - 2 * c);
+			ltc_encoder_set_volume(ref[c], -3 - 2 * c);
+			ltc_encoder_render_reset(e, 0);
+			ltc_encoder_render_reset(ref[c], 0);
+		}
+
+		for (off = 0; off < N_SAMPLES; off += chunk(off)) {
+			render_bank(bank, fmt, &buf[off * channels * sz], chunk(off));
+			for (c = 0; c < channels; ++c) {
+				render(ref[c], fmt, &mono[(c * N_SAMPLES + off) * sz], chunk(off));
+			}
+		}
+
+		for (c = 0; c < channels; ++c) {
+			for (i = 0; i < N_SAMPLES; ++i) {
+				if (memcmp(&buf[(i * channels + c) * sz], &mono[(c * N_SAMPLES + i) * sz], sz)) {
+					fprintf(stderr, "bank: format %d channel %d sample %d differs\n", fmt, c, (int) i);
+					rv = -1;
+					break;
+				}
+			}
+			ltc_encoder_free(ref[c]);
+		}
+
+		ltc_encoder_bank_free(bank);
+		free(mono);
+		free(buf);
+	}
+	return rv;
+}
+
+int main(int argc, char **argv) {
+	int rv = 0;
+	if (check_formats()) rv = -1;
+	if (check_interleaved()) rv = -1;
+	if (check_bank()) rv = -1;
+	return rv;
+}
@@ -0,0 +1,246 @@
+/**
+   @brief self-test shared memory frame publisher
+   @file ltcshm.c
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <ltc.h>
+
+#define N_FRAMES 20000
+
+/** synthesize the i-th frame, every field depends on i */
+static void make_frame(LTCFrameExt *frame, int i) {
+	memset (frame, 0, sizeof (LTCFrameExt));
+	ltc_index_to_frame (&frame->ltc, i, 25, LTC_TV_625_50, 0);
+	frame->off_start = i * (ltc_off_t) 1920;
+	frame->off_end = frame->off_start + 1919;
+	for (int b = 0; b < LTC_FRAME_BIT_COUNT; ++b) {
+		frame->biphase_tics[b] = i;
+	}
+	frame->volume = i;
+}
+
+/** @return frame number, -1 if the frame is inconsistent (torn) */
+static int check_frame(const LTCFrameExt *frame) {
+	const int i = frame->off_start / 1920;
+	LTCFrameExt expect;
+	make_frame (&expect, i);
+	return memcmp (&expect, frame, sizeof (LTCFrameExt)) ? -1 : i;
+}
+
+/* subscriber in another process, reading while the frames are published */
+static int subscribe(const char *name, int ready) {
+	LTCSubscriber *s = ltc_subscriber_open (name);
+	const time_t timeout = time (NULL) + 20;
+	LTCFrameExt frame;
+	int prev = -1, cnt = 0;
+
+	if (!s || write (ready, "1", 1) != 1) {
+		return 1;
+	}
+	while (prev < N_FRAMES - 1 && time (NULL) < timeout) {
+		if (!ltc_subscriber_read (s, &frame)) {
+			continue;
+		}
+		const int i = check_frame (&frame);
+		if (i <= prev) {
+			fprintf (stderr, "shm: frame %d after %d\n", i, prev);
+			return 1;
+		}
+		prev = i;
+		++cnt;
+	}
+	if (prev != N_FRAMES - 1 || cnt + ltc_subscriber_overruns (s) != N_FRAMES) {
+		fprintf (stderr, "shm: read %d frames, %u overruns\n", cnt, ltc_subscriber_overruns (s));
+		return 1;
+	}
+	ltc_subscriber_close (s);
+	return 0;
+}
+
+static int check_processes(const char *name) {
+	LTCPublisher *p = ltc_publisher_create (name, 64, 0);
+	LTCFrameExt frame;
+	int fd[2], status = -1;
+	char c;
+	pid_t pid;
+
+	if (!p || pipe (fd)) {
+		return -1;
+	}
+	pid = fork ();
+	if (pid == 0) {
+		close (fd[0]);
+		_exit (subscribe (name, fd[1]));
+	}
+	close (fd[1]);
+	if (pid < 0 || read (fd[0], &c, 1) != 1) {
+		fprintf (stderr, "shm: subscriber failed\n");
+	}
+	for (int i = 0; i < N_FRAMES; ++i) {
+		make_frame (&frame, i);
+		ltc_publisher_write (p, &frame);
+		if ((i % 16) == 0) {
+			/* let the subscriber run concurrently */
+			usleep (10);
+		}
+	}
+	if (pid > 0) {
+		waitpid (pid, &status, 0);
+	}
+	close (fd[0]);
+	ltc_publisher_free (p);
+	return (pid > 0 && WIFEXITED (status) && WEXITSTATUS (status) == 0) ? 0 : -1;
+}
+
+static int check_local(const char *name) {
+	LTCPublisher *p = ltc_publisher_create (name, 6, 0);
+	LTCSubscriber *s = ltc_subscriber_open (name);
+	LTCFrameExt frame;
+	int rv = 0;
+
+	if (!p || !s) {
+		return -1;
+	}
+	if (ltc_subscriber_read (s, &frame) || ltc_subscriber_latest (s, &frame)) {
+		rv = -1;
+	}
+	/* the queue is rounded up to 8, the first 2 frames are lost */
+	for (int i = 0; i < 10; ++i) {
+		make_frame (&frame, i);
+		ltc_publisher_write (p, &frame);
+	}
+	if (!ltc_subscriber_read (s, &frame) || check_frame (&frame) != 2 || ltc_subscriber_overruns (s) != 2) {
+		rv = -1;
+	}
+	if (!ltc_subscriber_latest (s, &frame) || check_frame (&frame) != 9
+			|| ltc_subscriber_latest (s, &frame) || ltc_subscriber_read (s, &frame)) {
+		rv = -1;
+	}
+
+	/* forward a decoder's frames */
+	LTCEncoder *encoder = ltc_encoder_create (48000, 25, LTC_TV_625_50, 0);
+	LTCDecoder *decoder = ltc_decoder_create (1920, 8);
+	ltcsnd_sample_t *buf;
+	int n, len, cnt = 0;
+	for (n = 0; n < 5; ++n) {
+		ltc_encoder_encode_frame (encoder);
+		ltc_encoder_inc_timecode (encoder);
+		len = ltc_encoder_get_bufferptr (encoder, &buf, 1);
+		ltc_decoder_write (decoder, buf, len, n * len);
+		cnt += ltc_publisher_forward (p, decoder);
+	}
+	n = 0;
+	while (ltc_subscriber_read (s, &frame)) {
+		if (frame.ltc.frame_units != n++) {
+			rv = -1;
+		}
+	}
+	if (cnt < 4 || n != cnt || ltc_decoder_queue_length (decoder) != 0) {
+		rv = -1;
+	}
+	ltc_encoder_free (encoder);
+	ltc_decoder_free (decoder);
+
+	ltc_subscriber_close (s);
+	ltc_publisher_free (p);
+
+	/* the object is removed */
+	if (ltc_subscriber_open (name)) {
+		rv = -1;
+	}
+	if (rv) {
+		fprintf (stderr, "shm: local subscriber failed\n");
+	}
+	return rv;
+}
+
+/* a running publisher is only replaced on request */
+static int check_replace(const char *name) {
+	LTCPublisher *p = ltc_publisher_create (name, 8, 0);
+	LTCPublisher *q;
+	LTCSubscriber *s, *t;
+	LTCFrameExt frame;
+	int rv = 0;
+
+	if (!p || ltc_publisher_create (name, 8, 0)) {
+		return -1;
+	}
+	s = ltc_subscriber_open (name);
+	q = ltc_publisher_create (name, 8, LTC_PUBLISHER_REPLACE);
+	t = ltc_subscriber_open (name);
+	if (!s || !q || !t) {
+		return -1;
+	}
+
+	/* each subscriber reads the object it attached to */
+	make_frame (&frame, 1);
+	ltc_publisher_write (p, &frame);
+	make_frame (&frame, 2);
+	ltc_publisher_write (q, &frame);
+	if (!ltc_subscriber_read (s, &frame) || check_frame (&frame) != 1
+			|| !ltc_subscriber_read (t, &frame) || check_frame (&frame) != 2) {
+		rv = -1;
+	}
+	ltc_subscriber_close (s);
+	ltc_subscriber_close (t);
+
+	/* the replaced publisher does not remove the new object */
+	ltc_publisher_free (p);
+	t = ltc_subscriber_open (name);
+	if (!t) {
+		rv = -1;
+	}
+	ltc_subscriber_close (t);
+	ltc_publisher_free (q);
+	if (ltc_subscriber_open (name)) {
+		rv = -1;
+	}
+	if (rv) {
+		fprintf (stderr, "shm: replacing a publisher failed\n");
+	}
+	return rv;
+}
+
+int main(void) {
+	char name[64];
+	int rv = 0;
+
+	snprintf (name, sizeof (name), "/ltcshm-test-%d", (int) getpid ());
+	if (!ltc_publisher_create (name, 0, 0) && !ltc_subscriber_open (name)) {
+		LTCPublisher *p = ltc_publisher_create (name, 1, 0);
+		if (!p) {
+			fprintf (stderr, "shm: not supported, skipping test\n");
+			return 0;
+		}
+		ltc_publisher_free (p);
+	}
+	if (check_local (name)) rv = -1;
+	if (check_replace (name)) rv = -1;
+	if (check_processes (name)) rv = -1;
+	return rv;
+}
@@ -0,0 +1,256 @@
+/**
+   @brief self-test timecode tracker
+   @file ltctracker.c
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006-2022 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <ltc.h>
+
+/** synthesize a frame, as the decoder would report it */
+static void make_frame(LTCFrameExt *frame, ltc_off_t index, int fps, double start, double period, int reverse) {
+	memset (frame, 0, sizeof (LTCFrameExt));
+	ltc_index_to_frame (&frame->ltc, index, fps, LTC_TV_625_50, 0);
+	frame->off_start = floor (start + .5);
+	frame->off_end = floor (start + period + .5) - 1;
+	/* the decoder reports reverse frames with their duration, not as 1 */
+	frame->reverse = reverse ? (int) period : 0;
+}
+
+static int check_decoded(void) {
+	const double samplerate = 48000;
+	const double fps = 25;
+	const int n_frames = 100;
+	LTCEncoder *encoder = ltc_encoder_create (samplerate, fps, LTC_TV_625_50, 0);
+	int frame_size = ltc_encoder_get_buffersize (encoder);
+	ltcsnd_sample_t *buf = malloc ((n_frames + 2) * frame_size);
+	LTCTracker *t = ltc_tracker_create (samplerate, fps, LTC_TV_625_50, 0);
+	LTCDecoder *decoder;
+	LTCFrameExt frame;
+	int off = 0, cnt = 0, rv = 0;
+
+	for (int i = 0; i < n_frames; ++i) {
+		ltc_encoder_encode_frame (encoder);
+		off += ltc_encoder_copy_buffer (encoder, &buf[off]);
+		ltc_encoder_inc_timecode (encoder);
+	}
+	ltc_encoder_end_encode (encoder);
+	off += ltc_encoder_copy_buffer (encoder, &buf[off]);
+	ltc_encoder_free (encoder);
+
+	decoder = ltc_decoder_create (samplerate / fps, 32);
+	for (int i = 0; i < off; i += 256) {
+		ltc_decoder_write (decoder, &buf[i], off - i < 256 ? off - i : 256, i);
+		while (ltc_decoder_read (decoder, &frame)) {
+			const int status = ltc_tracker_update (t, &frame);
+			LTCFrame tc;
+			double sub;
+			++cnt;
+			if (status & (LTC_TRACKER_JUMP | LTC_TRACKER_DROPOUT)) {
+				fprintf (stderr, "unexpected status %d at frame %d\n", status, cnt);
+				rv = -1;
+			}
+			if (cnt < 10) {
+				continue;
+			}
+			if (!(status & LTC_TRACKER_LOCKED)
+					|| fabs (ltc_tracker_speed (t) - 1.0) > 0.002
+					|| fabs (ltc_tracker_position (t, frame.off_start) - ltc_frame_to_index (&frame.ltc, 25)) > 0.05) {
+				fprintf (stderr, "poor estimate at frame %d\n", cnt);
+				rv = -1;
+			}
+			/* half a frame later, the timecode is the next frame */
+			ltc_tracker_timecode (t, frame.off_start + 1.5 * samplerate / fps, &tc, &sub);
+			if (ltc_frame_to_index (&tc, 25) != ltc_frame_to_index (&frame.ltc, 25) + 1 || fabs (sub - 0.5) > 0.05) {
+				fprintf (stderr, "timecode mismatch at frame %d\n", cnt);
+				rv = -1;
+			}
+		}
+	}
+	if (cnt != n_frames) {
+		fprintf (stderr, "decoded %d of %d frames\n", cnt, n_frames);
+		rv = -1;
+	}
+
+	ltc_decoder_free (decoder);
+	ltc_tracker_free (t);
+	free (buf);
+	return rv;
+}
+
+/* reverse playback with a drifting speed, decoded from audio */
+static int check_reverse(void) {
+	const double samplerate = 48000;
+	const double fps = 25;
+	const int n_frames = 200;
+	LTCEncoder *encoder = ltc_encoder_create (samplerate, fps, LTC_TV_625_50, 0);
+	ltcsnd_sample_t *buf, *rbuf;
+	LTCTracker *t = ltc_tracker_create (samplerate, fps, LTC_TV_625_50, 0);
+	LTCDecoder *decoder;
+	LTCFrameExt frame;
+	int off = 0, cnt = 0, locked = 0, rv = 0;
+
+	ltc_encoder_set_min_speed (encoder, 0.97);
+	buf = malloc ((n_frames + 2) * ltc_encoder_get_buffersize (encoder));
+	rbuf = malloc ((n_frames + 2) * ltc_encoder_get_buffersize (encoder));
+	for (int i = 0; i < n_frames; ++i) {
+		ltc_encoder_encode_frame_varispeed (encoder, 1 + .03 * sin (i * .1), 1 + .03 * sin ((i + 1) * .1));
+		off += ltc_encoder_copy_buffer (encoder, &buf[off]);
+		ltc_encoder_inc_timecode (encoder);
+	}
+	ltc_encoder_end_encode (encoder);
+	off += ltc_encoder_copy_buffer (encoder, &buf[off]);
+	ltc_encoder_free (encoder);
+
+	for (int i = 0; i < off; ++i) {
+		rbuf[i] = buf[off - 1 - i];
+	}
+
+	decoder = ltc_decoder_create (samplerate / fps, 32);
+	for (int i = 0; i < off; i += 256) {
+		ltc_decoder_write (decoder, &rbuf[i], off - i < 256 ? off - i : 256, i);
+		while (ltc_decoder_read (decoder, &frame)) {
+			const int status = ltc_tracker_update (t, &frame);
+			if (!frame.reverse || (cnt > 0 && (status & (LTC_TRACKER_JUMP | LTC_TRACKER_DROPOUT)))) {
+				fprintf (stderr, "reverse: unexpected status %d at frame %d\n", status, cnt);
+				rv = -1;
+			}
+			if (status & LTC_TRACKER_LOCKED) {
+				++locked;
+			}
+			++cnt;
+		}
+	}
+	if (cnt < n_frames - 1 || locked < cnt - 4) {
+		fprintf (stderr, "reverse: %d of %d frames locked\n", locked, cnt);
+		rv = -1;
+	}
+	if (fabs (ltc_tracker_speed (t) + 1.0) > 0.05) {
+		fprintf (stderr, "reverse: speed %f\n", ltc_tracker_speed (t));
+		rv = -1;
+	}
+
+	ltc_decoder_free (decoder);
+	ltc_tracker_free (t);
+	free (buf);
+	free (rbuf);
+	return rv;
+}
+
+static int check_varispeed(void) {
+	const double speed = 1.05;
+	const double period = 1920 / speed;
+	LTCTracker *t = ltc_tracker_create (48000, 25, LTC_TV_625_50, 0);
+	LTCFrameExt frame;
+	int rv = 0;
+
+	srand (1);
+	for (int i = 0; i < 250; ++i) {
+		const double jitter = (rand () % 5) - 2;
+		make_frame (&frame, 1000 + i, 25, 1000 + i * period + jitter, period, 0);
+		ltc_tracker_update (t, &frame);
+	}
+	if (fabs (ltc_tracker_speed (t) - speed) > 0.002
+			|| fabs (ltc_tracker_position (t, 1000 + 250 * period) - 1250) > 0.01) {
+		fprintf (stderr, "varispeed: speed %f\n", ltc_tracker_speed (t));
+		rv = -1;
+	}
+	ltc_tracker_free (t);
+	return rv;
+}
+
+static int check_events(void) {
+	const double period = 1920;
+	const ltc_off_t day = 86400 * 25;
+	LTCTracker *t = ltc_tracker_create (48000, 25, LTC_TV_625_50, 0);
+	LTCFrameExt frame;
+	LTCFrame tc;
+	int i, status, rv = 0;
+
+	/* cross midnight */
+	for (i = 0; i < 10; ++i) {
+		make_frame (&frame, (day - 5 + i) % day, 25, i * period, period, 0);
+		status = ltc_tracker_update (t, &frame);
+		if (status != (i < 3 ? 0 : LTC_TRACKER_LOCKED)) {
+			fprintf (stderr, "midnight: status %d at %d\n", status, i);
+			rv = -1;
+		}
+	}
+	ltc_tracker_timecode (t, 10 * period, &tc, NULL);
+	if (ltc_frame_to_index (&tc, 25) != 5 || fabs (ltc_tracker_position (t, 10 * period) - 5) > 0.01) {
+		fprintf (stderr, "midnight: wrong position\n");
+		rv = -1;
+	}
+
+	/* dropout of 3 frames */
+	make_frame (&frame, 8, 25, 13 * period, period, 0);
+	if (ltc_tracker_update (t, &frame) != (LTC_TRACKER_LOCKED | LTC_TRACKER_DROPOUT)) {
+		fprintf (stderr, "dropout not detected\n");
+		rv = -1;
+	}
+	if (ltc_tracker_status (t, 14 * period) != LTC_TRACKER_LOCKED
+			|| ltc_tracker_status (t, 30 * period) != LTC_TRACKER_DROPOUT) {
+		fprintf (stderr, "status mismatch\n");
+		rv = -1;
+	}
+
+	/* jump */
+	make_frame (&frame, 500, 25, 14 * period, period, 0);
+	if (ltc_tracker_update (t, &frame) != LTC_TRACKER_JUMP) {
+		fprintf (stderr, "jump not detected\n");
+		rv = -1;
+	}
+
+	/* change of direction, then track reverse playback */
+	for (i = 0; i < 10; ++i) {
+		make_frame (&frame, 499 - i, 25, (15 + i) * period, period, 1);
+		status = ltc_tracker_update (t, &frame);
+		if ((i == 0 && status != LTC_TRACKER_JUMP) || (i >= 3 && status != LTC_TRACKER_LOCKED)) {
+			fprintf (stderr, "reverse: status %d at %d\n", status, i);
+			rv = -1;
+		}
+	}
+	/* the last frame (490) started at 24 * period, the position passes its start at its end */
+	if (fabs (ltc_tracker_speed (t) + 1.0) > 0.001
+			|| fabs (ltc_tracker_position (t, 24.5 * period) - 490.5) > 0.01) {
+		fprintf (stderr, "reverse: wrong estimate\n");
+		rv = -1;
+	}
+
+	ltc_tracker_reset (t);
+	if (ltc_tracker_position (t, 0) != -1 || ltc_tracker_speed (t) != 0) {
+		rv = -1;
+	}
+	ltc_tracker_free (t);
+	return rv;
+}
+
+int main(void) {
+	int rv = 0;
+	if (check_decoded ()) rv = -1;
+	if (check_reverse ()) rv = -1;
+	if (check_varispeed ()) rv = -1;
+	if (check_events ()) rv = -1;
+	return rv;
+}